@@ -0,0 +1,54 @@
+#include "fir_decimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+FirDecimator::FirDecimator(int factor, int taps_per_output)
+    : factor_(std::max(1, factor)) {
+    const size_t n = static_cast<size_t>(std::max(1, taps_per_output) * factor_ + 1);
+    const double cutoff = 0.5 / factor_;   // 입력 fs 기준 정규화 (출력 Nyquist)
+    const double mid = (n - 1) / 2.0;
+
+    coeffs_.resize(n);
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double x = i - mid;
+        double sinc = x == 0.0 ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * x) / (M_PI * x);
+        double w = n == 1 ? 1.0 : 0.42 - 0.5 * std::cos(2.0 * M_PI * i / (n - 1)) + 0.08 * std::cos(4.0 * M_PI * i / (n - 1));
+        coeffs_[i] = static_cast<float>(sinc * w);
+        sum += coeffs_[i];
+    }
+    for (auto& c : coeffs_) c = static_cast<float>(c / sum);   // DC 이득 1
+
+    history_.assign(2 * n, {0.0f, 0.0f, 0.0f});
+}
+
+void FirDecimator::reset() {
+    std::fill(history_.begin(), history_.end(), std::array<float, 3>{0.0f, 0.0f, 0.0f});
+    pos_ = 0;
+    filled_ = 0;
+    phase_ = 0;
+}
+
+bool FirDecimator::push(const std::array<float, 3>& in, std::array<float, 3>& out) {
+    const size_t n = coeffs_.size();
+    history_[pos_] = in;
+    history_[pos_ + n] = in;
+    pos_ = pos_ + 1 == n ? 0 : pos_ + 1;
+    if (filled_ < n) ++filled_;
+
+    if (++phase_ < factor_) return false;
+    phase_ = 0;
+    if (filled_ < n) return false;   // 시작 직후 0 으로 채워진 구간은 내보내지 않음
+
+    // history_[pos_ .. pos_+n) = 가장 오래된 → 최신 (대칭 계수라 방향은 상관없음)
+    const std::array<float, 3>* h = history_.data() + pos_;
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        x += coeffs_[i] * h[i][0];
+        y += coeffs_[i] * h[i][1];
+        z += coeffs_[i] * h[i][2];
+    }
+    out = {x, y, z};
+    return true;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// 3축 FIR decimator (anti-alias 저역통과 + 1/factor 솎기).
+// Blackman 창 sinc, 차단 = 출력 Nyquist, 탭 = taps_per_output * factor + 1 (홀수, 선형 위상).
+// 기본 14 → 출력 주파수 fo 에 대해 0 ~ 0.3 fo 통과, 0.7 fo 이상 약 -74 dB (fold 되어도 0.3 fo 위로만 들어옴).
+// 필터 값은 출력할 차례에만 계산 (polyphase 와 같은 출력당 탭 수 만큼의 곱셈), 버퍼는 생성할 때 한 번만 할당.
+class FirDecimator {
+public:
+    explicit FirDecimator(int factor, int taps_per_output = 14);
+
+    // 입력 하나. 출력 차례면 out 을 채우고 true (처음 taps() 개 입력 동안은 false)
+    bool push(const std::array<float, 3>& in, std::array<float, 3>& out);
+    void reset();
+
+    int factor() const { return factor_; }
+    size_t taps() const { return coeffs_.size(); }
+    // 출력은 마지막 입력보다 이만큼 (입력 샘플 단위) 이전 시점의 값
+    double delay() const { return (coeffs_.size() - 1) / 2.0; }
+
+private:
+    int factor_;
+    std::vector<float> coeffs_;
+    std::vector<std::array<float, 3>> history_;   // taps * 2, 같은 값을 두 곳에 써서 곱할 구간이 항상 연속
+    size_t pos_ = 0;
+    size_t filled_ = 0;
+    int phase_ = 0;
+};
@@ -0,0 +1,137 @@
+#include "gps_imu_fusion.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr double DEG_TO_RAD = M_PI / 180.0;
+    constexpr double KMH_TO_MS = 1.0 / 3.6;
+
+    // 잡음 (표준편차). 가속도 / 자이로는 진동 포함, GPS 는 u-blox 급 수신기 기준
+    constexpr double ACCEL_NOISE = 0.5;          // m/s²
+    constexpr double ACCEL_BIAS_WALK = 0.02;     // m/s² /√s (경사로 / 장착 기울기 변화)
+    constexpr double GYRO_NOISE = 1.0;           // deg/s
+    constexpr double GYRO_BIAS_WALK = 0.05;      // deg/s /√s
+    constexpr double GPS_SPEED_NOISE = 0.5;      // m/s
+    constexpr double GPS_HEADING_NOISE = 3.0;    // deg (5 m/s 이상일 때, 느릴수록 크게)
+    constexpr double INITIAL_ACCEL_BIAS = 0.5;   // m/s²
+    constexpr double INITIAL_GYRO_BIAS = 1.0;    // deg/s
+
+    constexpr double MIN_HEADING_SPEED = 1.5;    // m/s 미만 fix 의 heading 은 쓰지 않음 (GpsKinematics 와 같음)
+    constexpr double MAX_IMU_GAP = 1.0;          // s, 이보다 끊기면 (idle 등) GPS 를 다시 받을 때까지 무효
+    constexpr double MAX_FIX_AGE = 2.0;          // s, 마지막 IMU 샘플보다 이만큼 오래된 fix 는 버림 (멈춘 GPS)
+
+    // (-180, 180]
+    double wrap_deg(double a) {
+        a = std::fmod(a + 180.0, 360.0);
+        if (a <= 0.0) a += 360.0;
+        return a - 180.0;
+    }
+
+    // [0, 360)
+    double wrap_heading(double a) {
+        a = std::fmod(a, 360.0);
+        return a < 0.0 ? a + 360.0 : a;
+    }
+}
+
+void GpsImuFusion::Track::init(double value, double var_x, double var_bias) {
+    x = value;
+    bias = 0.0;
+    p00 = var_x;
+    p01 = 0.0;
+    p11 = var_bias;
+}
+
+void GpsImuFusion::Track::predict(double rate, double dt, double q_x, double q_bias) {
+    // F = [1 -dt; 0 1]
+    x += (rate - bias) * dt;
+    p00 += -2.0 * dt * p01 + dt * dt * p11 + q_x;
+    p01 -= dt * p11;
+    p11 += q_bias;
+}
+
+void GpsImuFusion::Track::correct(double innovation, double r) {
+    // H = [1 0]
+    double s = p00 + r;
+    double k0 = p00 / s;
+    double k1 = p01 / s;
+    x += k0 * innovation;
+    bias += k1 * innovation;
+    p11 -= k1 * p01;
+    p00 *= 1.0 - k0;
+    p01 *= 1.0 - k0;
+}
+
+void GpsImuFusion::correct(const GpsData& fix) {
+    if (fix.source_timestamp <= last_fix_t_) return;
+    if (has_prev_ && prev_t_ - fix.source_timestamp > MAX_FIX_AGE) return;
+    last_fix_t_ = fix.source_timestamp;
+
+    const double speed = fix.speed * KMH_TO_MS;
+    const double speed_var = GPS_SPEED_NOISE * GPS_SPEED_NOISE;
+    if (!speed_valid_) {
+        speed_.init(speed, speed_var, INITIAL_ACCEL_BIAS * INITIAL_ACCEL_BIAS);
+        speed_valid_ = true;
+    } else {
+        speed_.correct(speed - speed_.x, speed_var);
+        speed_.x = std::max(0.0, speed_.x);
+    }
+
+    if (fix.kinematics_valid && speed >= MIN_HEADING_SPEED) {
+        double noise = GPS_HEADING_NOISE * std::max(1.0, 5.0 / speed);
+        if (!heading_valid_) {
+            heading_.init(fix.heading, noise * noise, INITIAL_GYRO_BIAS * INITIAL_GYRO_BIAS);
+            heading_valid_ = true;
+        } else {
+            heading_.correct(wrap_deg(fix.heading - heading_.x), noise * noise);
+            heading_.x = wrap_heading(heading_.x);
+        }
+    }
+}
+
+void GpsImuFusion::process(ImuData& sample) {
+    const double dt = sample.source_timestamp - prev_t_;
+    if (has_prev_ && (dt <= 0.0 || dt > MAX_IMU_GAP)) {
+        // 끊긴 동안 차가 어떻게 움직였는지 모른다 → 다음 GPS fix 부터 다시
+        speed_valid_ = false;
+        heading_valid_ = false;
+    }
+    const bool step = has_prev_ && dt > 0.0 && dt <= MAX_IMU_GAP;
+    has_prev_ = true;
+    prev_t_ = sample.source_timestamp;
+
+    const double accel = sample.accel[FUSION_LONG_AXIS];
+    const double yaw_rate = FUSION_YAW_SIGN * sample.gyro[FUSION_YAW_AXIS];   // deg/s, 시계방향 양수
+
+    if (step && speed_valid_) {
+        speed_.predict(accel, dt, ACCEL_NOISE * ACCEL_NOISE * dt * dt, ACCEL_BIAS_WALK * ACCEL_BIAS_WALK * dt);
+        speed_.x = std::max(0.0, speed_.x);
+    }
+    if (step && heading_valid_) {
+        heading_.predict(yaw_rate, dt, GYRO_NOISE * GYRO_NOISE * dt * dt, GYRO_BIAS_WALK * GYRO_BIAS_WALK * dt);
+        heading_.x = wrap_heading(heading_.x);
+    }
+
+    sample.fused_valid = speed_valid_;
+    sample.fused_heading_valid = heading_valid_;
+    if (!speed_valid_) return;
+
+    // heading 을 아직 못 받았어도 bias 0 으로 보고 횡가속도는 낸다
+    const double heading_rate = yaw_rate - (heading_valid_ ? heading_.bias : 0.0);
+    sample.fused_speed = static_cast<float>(speed_.x / KMH_TO_MS);
+    sample.fused_heading = static_cast<float>(heading_.x);
+    sample.fused_long_acc = static_cast<float>(accel - speed_.bias);
+    sample.fused_lat_acc = static_cast<float>(speed_.x * heading_rate * DEG_TO_RAD);
+}
+
+void compute_fusion_features(SampleSpan<ImuData> imu, SummaryRow& row) {
+    double sum = 0.0;
+    size_t n = 0;
+    for (const auto& s : imu) {
+        if (!s.fused_valid) continue;
+        sum += s.fused_speed;
+        ++n;
+    }
+    if (n) row.set(COL_SPEED, sum / n);
+}
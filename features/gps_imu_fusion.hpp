@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../include/shared_structs.hpp"
+#include "summary_features.hpp"
+
+// 차량 축 (summary 의 acc_x / yaw_rate 컬럼과 같은 배치). 장착 방향이 다르면 여기만 바꾼다
+constexpr int FUSION_LONG_AXIS = 0;        // accel[LONG]: 전진 방향 가속이 양수
+constexpr int FUSION_YAW_AXIS = 2;         // gyro[YAW]
+constexpr float FUSION_YAW_SIGN = -1.0f;   // 자이로는 좌회전(반시계)이 양수, heading 은 시계방향
+
+// GPS (~1Hz) 와 IMU (100Hz) 를 합쳐서 IMU 주기로 속도 / heading / 종·횡가속도를 낸다.
+// 속도 [v, accel bias], heading [ψ, gyro bias] 두 개의 2상태 칼만 필터:
+//   IMU 샘플마다 가속도 / yaw rate 로 예측, GPS fix 가 오면 속도 / heading 으로 보정.
+// 터널처럼 GPS 가 끊겨도 마지막 bias 추정으로 계속 적분한다 (불확실성만 커짐).
+// 샘플당 고정 비용, 힙 할당 없음. 결과는 ImuData::fused_* 에 채워진다.
+class GpsImuFusion {
+public:
+    void reset() { *this = GpsImuFusion(); }
+
+    // GPS fix 마다 (GpsKinematics 를 거친 것). 이미 반영한 fix (timestamp 가 같거나 이전) 와
+    // 마지막 IMU 샘플보다 MAX_FIX_AGE 이상 오래된 fix 는 무시
+    void correct(const GpsData& fix);
+
+    // IMU 샘플마다 (시간순)
+    void process(ImuData& sample);
+
+private:
+    // 상태 하나 + 그 bias (x' = rate - bias), 공분산 [p00 p01; p01 p11]
+    struct Track {
+        double x = 0.0;
+        double bias = 0.0;
+        double p00 = 0.0, p01 = 0.0, p11 = 0.0;
+
+        void init(double value, double var_x, double var_bias);
+        void predict(double rate, double dt, double q_x, double q_bias);
+        void correct(double innovation, double r);
+    };
+
+    Track speed_;       // m/s, bias m/s²
+    Track heading_;     // deg, bias deg/s
+    bool speed_valid_ = false;
+    bool heading_valid_ = false;
+
+    bool has_prev_ = false;
+    double prev_t_ = 0.0;
+    double last_fix_t_ = 0.0;
+};
+
+// speed 컬럼 = 구간의 융합 속도 평균 (km/h). 첫 GPS fix 전이면 기본값
+void compute_fusion_features(SampleSpan<ImuData> imu, SummaryRow& row);
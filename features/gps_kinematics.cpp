@@ -0,0 +1,102 @@
+#include "gps_kinematics.hpp"
+
+#include <cmath>
+
+namespace {
+    constexpr double DEG_TO_RAD = M_PI / 180.0;
+    constexpr double WGS84_A = 6378137.0;
+    constexpr double WGS84_E2 = 6.69437999014e-3;
+
+    constexpr double KMH_TO_MS = 1.0 / 3.6;
+    constexpr double MIN_HEADING_SPEED = 1.5;   // m/s 미만이면 heading 을 유지 (정지 중 GPS 흔들림)
+    constexpr double MIN_HEADING_DIST = 1.0;    // m
+    constexpr double MAX_FIX_GAP = 5.0;         // s, 이보다 끊기면 미분값 체인을 새로 시작
+
+    void geodetic_to_ecef(double lat_rad, double lon_rad, double out[3]) {
+        double sin_lat = std::sin(lat_rad);
+        double cos_lat = std::cos(lat_rad);
+        double n = WGS84_A / std::sqrt(1.0 - WGS84_E2 * sin_lat * sin_lat);
+        out[0] = n * cos_lat * std::cos(lon_rad);
+        out[1] = n * cos_lat * std::sin(lon_rad);
+        out[2] = n * (1.0 - WGS84_E2) * sin_lat;
+    }
+
+    // (-180, 180] 로 감기
+    double wrap_deg(double a) {
+        a = std::fmod(a + 180.0, 360.0);
+        if (a <= 0.0) a += 360.0;
+        return a - 180.0;
+    }
+}
+
+void GpsKinematics::to_enu(double lat_deg, double lon_deg, double& east, double& north) const {
+    double ecef[3];
+    geodetic_to_ecef(lat_deg * DEG_TO_RAD, lon_deg * DEG_TO_RAD, ecef);
+    double dx = ecef[0] - origin_ecef_[0];
+    double dy = ecef[1] - origin_ecef_[1];
+    double dz = ecef[2] - origin_ecef_[2];
+
+    east = -sin_lon0_ * dx + cos_lon0_ * dy;
+    north = -sin_lat0_ * cos_lon0_ * dx - sin_lat0_ * sin_lon0_ * dy + cos_lat0_ * dz;
+}
+
+void GpsKinematics::update(GpsData& fix) {
+    if (!has_origin_) {
+        double lat0 = fix.lat * DEG_TO_RAD;
+        double lon0 = fix.lon * DEG_TO_RAD;
+        sin_lat0_ = std::sin(lat0); cos_lat0_ = std::cos(lat0);
+        sin_lon0_ = std::sin(lon0); cos_lon0_ = std::cos(lon0);
+        geodetic_to_ecef(lat0, lon0, origin_ecef_);
+        has_origin_ = true;
+    }
+
+    to_enu(fix.lat, fix.lon, fix.east, fix.north);
+    double speed = fix.speed * KMH_TO_MS;
+
+    double dt = fix.source_timestamp - prev_t_;
+    if (!has_prev_ || dt <= 0.0 || dt > MAX_FIX_GAP) {
+        // 첫 fix 혹은 끊김 직후: 위치만 갱신
+        has_prev_ = true;
+        has_heading_ = false;
+        prev_t_ = fix.source_timestamp;
+        prev_east_ = fix.east;
+        prev_north_ = fix.north;
+        prev_speed_ = speed;
+        fix.heading = heading_;
+        fix.kinematics_valid = false;
+        return;
+    }
+
+    double de = fix.east - prev_east_;
+    double dn = fix.north - prev_north_;
+    double dist = std::sqrt(de * de + dn * dn);
+    double v_mid = 0.5 * (speed + prev_speed_);
+
+    double heading_rate = 0.0;   // deg/s
+    if (v_mid >= MIN_HEADING_SPEED && dist >= MIN_HEADING_DIST) {
+        double heading = std::atan2(de, dn) / DEG_TO_RAD;  // 북 기준 시계방향
+        if (heading < 0.0) heading += 360.0;
+        if (heading >= 360.0) heading -= 360.0;
+        // 두 fix 사이 변위의 방향이라 구간 중간 시각의 heading. 저속으로 유지했던 구간이 있으면 그만큼 나눠서
+        // (교차로 / 주차장에서 천천히 돈 것이 fix 하나의 급회전으로 보이지 않도록), 너무 오래 유지했으면 새로 시작
+        double heading_t = 0.5 * (prev_t_ + fix.source_timestamp);
+        double elapsed = heading_t - heading_t_;
+        if (has_heading_ && elapsed > 0.0 && elapsed <= MAX_FIX_GAP) heading_rate = wrap_deg(heading - heading_) / elapsed;
+        heading_ = heading;
+        heading_t_ = heading_t;
+        has_heading_ = true;
+    }
+
+    fix.heading = heading_;
+    fix.heading_rate = heading_rate;
+    fix.long_acc = (speed - prev_speed_) / dt;
+    // 횡가속도 = v · ω, 곡률 = ω / v (heading 이 시계방향이라 우회전이 양수)
+    fix.lat_acc = v_mid * heading_rate * DEG_TO_RAD;
+    fix.curvature = v_mid >= MIN_HEADING_SPEED ? heading_rate * DEG_TO_RAD / v_mid : 0.0;
+    fix.kinematics_valid = true;
+
+    prev_t_ = fix.source_timestamp;
+    prev_east_ = fix.east;
+    prev_north_ = fix.north;
+    prev_speed_ = speed;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "../include/shared_structs.hpp"
+
+// GPS fix 를 순서대로 받아 로컬 ENU 평면으로 투영하고
+// heading / heading rate / 종·횡가속도 / 곡률을 fix 당 O(1) 로 갱신한다.
+// 결과는 GpsData 의 east ~ curvature 필드에 채워진다.
+class GpsKinematics {
+public:
+    void reset() { *this = GpsKinematics(); }
+    void update(GpsData& fix);
+
+private:
+    // 첫 fix 기준 ENU 원점 (WGS84 ECEF)
+    bool has_origin_ = false;
+    double origin_ecef_[3] = {0.0, 0.0, 0.0};
+    double sin_lat0_ = 0.0, cos_lat0_ = 1.0;
+    double sin_lon0_ = 0.0, cos_lon0_ = 1.0;
+
+    bool has_prev_ = false;
+    double prev_t_ = 0.0;
+    double prev_east_ = 0.0;
+    double prev_north_ = 0.0;
+    double prev_speed_ = 0.0;    // m/s
+
+    bool has_heading_ = false;
+    double heading_ = 0.0;       // deg, 북=0 시계방향
+    double heading_t_ = 0.0;     // heading_ 을 마지막으로 갱신한 구간의 중간 시각
+
+    void to_enu(double lat_deg, double lon_deg, double& east, double& north) const;
+};
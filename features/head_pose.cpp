@@ -0,0 +1,134 @@
+#include "head_pose.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr double RAD_TO_DEG = 180.0 / M_PI;
+
+    // a ⊗ b
+    Quaternion quat_mul(const Quaternion& a, const Quaternion& b) {
+        return {
+            a[0]*b[0] - a[1]*b[1] - a[2]*b[2] - a[3]*b[3],
+            a[0]*b[1] + a[1]*b[0] + a[2]*b[3] - a[3]*b[2],
+            a[0]*b[2] - a[1]*b[3] + a[2]*b[0] + a[3]*b[1],
+            a[0]*b[3] + a[1]*b[2] - a[2]*b[1] + a[3]*b[0]
+        };
+    }
+
+    Quaternion quat_conj(const Quaternion& q) {
+        return {q[0], -q[1], -q[2], -q[3]};
+    }
+}
+
+Quaternion quat_from_rotation_matrix(const double m[3][3]) {
+    Quaternion q;
+    double trace = m[0][0] + m[1][1] + m[2][2];
+
+    if (trace > 0.0) {
+        double s = std::sqrt(trace + 1.0) * 2.0;
+        q = {0.25 * s, (m[2][1] - m[1][2]) / s, (m[0][2] - m[2][0]) / s, (m[1][0] - m[0][1]) / s};
+    } else if (m[0][0] > m[1][1] && m[0][0] > m[2][2]) {
+        double s = std::sqrt(1.0 + m[0][0] - m[1][1] - m[2][2]) * 2.0;
+        q = {(m[2][1] - m[1][2]) / s, 0.25 * s, (m[0][1] + m[1][0]) / s, (m[0][2] + m[2][0]) / s};
+    } else if (m[1][1] > m[2][2]) {
+        double s = std::sqrt(1.0 + m[1][1] - m[0][0] - m[2][2]) * 2.0;
+        q = {(m[0][2] - m[2][0]) / s, (m[0][1] + m[1][0]) / s, 0.25 * s, (m[1][2] + m[2][1]) / s};
+    } else {
+        double s = std::sqrt(1.0 + m[2][2] - m[0][0] - m[1][1]) * 2.0;
+        q = {(m[1][0] - m[0][1]) / s, (m[0][2] + m[2][0]) / s, (m[1][2] + m[2][1]) / s, 0.25 * s};
+    }
+
+    // MediaPipe 행렬은 스케일이 약간 섞여 있어서 정규화
+    double norm = std::sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+    if (norm < 1e-12) return {1.0, 0.0, 0.0, 0.0};
+    double sign = q[0] < 0.0 ? -1.0 : 1.0;
+    for (auto& v : q) v *= sign / norm;
+    return q;
+}
+
+void HeadKinematics::Moments::add(double v) {
+    sum += v;
+    sum_sq += v * v;
+    peak = std::max(peak, std::abs(v));
+    ++count;
+}
+
+double HeadKinematics::Moments::mean() const {
+    return count ? sum / count : 0.0;
+}
+
+double HeadKinematics::Moments::rms() const {
+    return count ? std::sqrt(sum_sq / count) : 0.0;
+}
+
+void HeadKinematics::add(const FaceData& face) {
+    const bool has_trans = face.has_translation;
+    std::array<double, 3> trans{};
+    if (has_trans) {
+        for (int i = 0; i < 3; ++i) trans[i] = face.translation_vector[i];
+    }
+
+    bool pair_ok = false;
+    double dt = face.source_timestamp - prev_t_;
+
+    // 기존 head_tv/head_rv 와 같게: 두 프레임 모두 translation 이 있어야 한 쌍으로 본다
+    if (has_prev_ && dt > 0 && has_trans && prev_has_trans_) {
+        double dx = trans[0] - prev_trans_[0];
+        double dy = trans[1] - prev_trans_[1];
+        double dz = trans[2] - prev_trans_[2];
+        tv_.add(std::sqrt(dx*dx + dy*dy + dz*dz) / dt);
+
+        if (face.has_head_pose && prev_has_pose_) {
+            // 상대 회전 q_d = q2 ⊗ q1* (R2 * R1^T 와 동일), 짧은 쪽으로
+            Quaternion qd = quat_mul(face.head_quat, quat_conj(prev_q_));
+            if (qd[0] < 0.0) for (auto& v : qd) v = -v;
+
+            double vnorm = std::sqrt(qd[1]*qd[1] + qd[2]*qd[2] + qd[3]*qd[3]);
+            double angle = 2.0 * std::atan2(vnorm, qd[0]);   // rad
+            rv_.add(angle * RAD_TO_DEG / dt);
+
+            // 축-각 → 각속도 벡터 (deg/s)
+            std::array<double, 3> omega{};
+            if (vnorm > 1e-12) {
+                double scale = angle * RAD_TO_DEG / (vnorm * dt);
+                for (int i = 0; i < 3; ++i) omega[i] = qd[i + 1] * scale;
+            }
+            for (int i = 0; i < 3; ++i) rate_[i].add(omega[i]);
+
+            if (has_prev_omega_) {
+                double dt_mid = 0.5 * (dt + prev_omega_dt_);
+                double ax = (omega[0] - prev_omega_[0]) / dt_mid;
+                double ay = (omega[1] - prev_omega_[1]) / dt_mid;
+                double az = (omega[2] - prev_omega_[2]) / dt_mid;
+                ang_acc_.add(std::sqrt(ax*ax + ay*ay + az*az));
+            }
+            prev_omega_ = omega;
+            prev_omega_dt_ = dt;
+            pair_ok = true;
+        }
+    }
+    has_prev_omega_ = pair_ok;
+
+    has_prev_ = true;
+    prev_t_ = face.source_timestamp;
+    prev_has_trans_ = has_trans;
+    prev_trans_ = trans;
+    prev_has_pose_ = face.has_head_pose;
+    prev_q_ = face.head_quat;
+}
+
+HeadKinematicsSummary HeadKinematics::summary() const {
+    HeadKinematicsSummary s;
+    s.tv_mean = tv_.mean();
+    s.rv_mean = rv_.mean();
+    s.tv_rms = tv_.rms();
+    s.tv_peak = tv_.peak;
+    for (int i = 0; i < 3; ++i) {
+        s.rate_rms[i] = rate_[i].rms();
+        s.rate_peak[i] = rate_[i].peak;
+    }
+    s.ang_acc_rms = ang_acc_.rms();
+    s.ang_acc_peak = ang_acc_.peak;
+    return s;
+}
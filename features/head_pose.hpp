@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "../include/shared_structs.hpp"
+
+// (w, x, y, z) 단위 쿼터니언
+using Quaternion = std::array<double, 4>;
+
+// 3x3 회전 행렬 → 쿼터니언 (Shepperd 방식, w >= 0 로 정규화)
+Quaternion quat_from_rotation_matrix(const double m[3][3]);
+
+// 윈도우 하나에 대한 머리 움직임 요약.
+// 축은 MediaPipe facial transform 기준: x(pitch), y(yaw), z(roll). 각속도 단위 deg/s.
+struct HeadKinematicsSummary {
+    double tv_mean = 0.0;          // head_tv: 평균 이동 속도 (transform 단위/s)
+    double rv_mean = 0.0;          // head_rv: 평균 회전 속도 (deg/s)
+    double tv_rms = 0.0;
+    double tv_peak = 0.0;
+    std::array<double, 3> rate_rms{};    // pitch, yaw, roll
+    std::array<double, 3> rate_peak{};   // |ω| 축별 최대
+    double ang_acc_rms = 0.0;      // |α| (deg/s²)
+    double ang_acc_peak = 0.0;
+};
+
+// 프레임을 순서대로 넣으면 인접 프레임 쌍마다 속도/가속도를 누적한다.
+// 힙 할당 없이 고정 크기 상태만 사용.
+class HeadKinematics {
+public:
+    void reset() { *this = HeadKinematics(); }
+    void add(const FaceData& face);
+    HeadKinematicsSummary summary() const;
+
+private:
+    struct Moments {
+        double sum = 0.0;
+        double sum_sq = 0.0;
+        double peak = 0.0;
+        size_t count = 0;
+
+        void add(double v);
+        double mean() const;
+        double rms() const;
+    };
+
+    bool has_prev_ = false;
+    double prev_t_ = 0.0;
+    bool prev_has_pose_ = false;
+    Quaternion prev_q_{1.0, 0.0, 0.0, 0.0};
+    bool prev_has_trans_ = false;
+    std::array<double, 3> prev_trans_{};
+
+    bool has_prev_omega_ = false;
+    std::array<double, 3> prev_omega_{};   // deg/s
+    double prev_omega_dt_ = 0.0;
+
+    Moments tv_;
+    Moments rv_;
+    std::array<Moments, 3> rate_;
+    Moments ang_acc_;
+};
@@ -0,0 +1,168 @@
+#include "motion_spectrum.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // 이보다 긴 공백 (idle, 센서 끊김) 이면 처음부터 다시 (공백을 건너 이어 붙인 segment 는 스펙트럼이 틀어짐)
+    constexpr double MAX_SAMPLE_GAP = 1.0;
+
+    size_t power_of_two_at_least(size_t n) {
+        size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+}
+
+std::string spectrum_column_name(int band, int axis) {
+    return std::string(motion_spectrum_bands[band].name) + "_" + "xyz"[axis];
+}
+
+FftPlan::FftPlan(size_t n) : n_(power_of_two_at_least(n)) {
+    twiddles_.resize(n_ / 2);
+    for (size_t k = 0; k < n_ / 2; ++k) {
+        twiddles_[k] = std::polar(1.0, -2.0 * M_PI * k / n_);
+    }
+
+    int bits = 0;
+    while ((size_t{1} << bits) < n_) ++bits;
+    bit_reverse_.resize(n_);
+    for (size_t i = 0; i < n_; ++i) {
+        uint32_t r = 0;
+        for (int b = 0; b < bits; ++b) r |= ((i >> b) & 1u) << (bits - 1 - b);
+        bit_reverse_[i] = r;
+    }
+}
+
+void FftPlan::forward(std::complex<double>* data) const {
+    for (size_t i = 0; i < n_; ++i) {
+        if (i < bit_reverse_[i]) std::swap(data[i], data[bit_reverse_[i]]);
+    }
+    for (size_t len = 2; len <= n_; len <<= 1) {
+        const size_t half = len / 2;
+        const size_t step = n_ / len;
+        for (size_t i = 0; i < n_; i += len) {
+            for (size_t k = 0; k < half; ++k) {
+                std::complex<double> u = data[i + k];
+                std::complex<double> v = data[i + k + half] * twiddles_[k * step];
+                data[i + k] = u + v;
+                data[i + k + half] = u - v;
+            }
+        }
+    }
+}
+
+MotionSpectrum::MotionSpectrum(double fs, size_t segment, size_t hop, size_t average)
+    : fs_(fs),
+      segment_(power_of_two_at_least(segment)),
+      hop_(std::clamp<size_t>(hop, 1, segment_)),
+      average_(std::max<size_t>(1, average)),
+      plan_(segment_) {
+    window_.resize(segment_);
+    for (size_t i = 0; i < segment_; ++i) {
+        window_[i] = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / segment_);   // periodic Hann (75% 겹침에서 합이 일정)
+        window_power_ += window_[i] * window_[i];
+    }
+
+    // bin k 의 주파수 k·fs/N 이 [low, high) 인 것만 (DC 는 segment 평균을 빼서 0)
+    const double df = resolution_hz();
+    const size_t last = segment_ / 2 + 1;
+    for (int b = 0; b < MOTION_SPECTRUM_BANDS; ++b) {
+        const SpectrumBand& band = motion_spectrum_bands[b];
+        size_t lo = std::min(last, static_cast<size_t>(std::ceil(std::max(0.0, band.low_hz) / df)));
+        size_t hi = std::isinf(band.high_hz) ? last
+                                             : std::min(last, static_cast<size_t>(std::ceil(band.high_hz / df)));
+        bins_[b] = {lo, std::max(lo, hi)};
+    }
+
+    for (auto& axis : ring_) axis.assign(segment_, 0.0f);
+    xy_.resize(segment_);
+    z_.resize(segment_);
+    history_.resize(average_);
+}
+
+void MotionSpectrum::reset() {
+    for (auto& axis : ring_) std::fill(axis.begin(), axis.end(), 0.0f);
+    pos_ = 0;
+    filled_ = 0;
+    since_segment_ = 0;
+    history_pos_ = 0;
+    history_count_ = 0;
+    mean_ = {};
+    has_prev_ = false;
+}
+
+void MotionSpectrum::process(ImuData& sample) {
+    if (has_prev_ && std::abs(sample.source_timestamp - prev_t_) > MAX_SAMPLE_GAP) reset();
+    has_prev_ = true;
+    prev_t_ = sample.source_timestamp;
+
+    for (int i = 0; i < 3; ++i) ring_[i][pos_] = sample.accel[i];
+    pos_ = pos_ + 1 == segment_ ? 0 : pos_ + 1;
+    if (filled_ < segment_) ++filled_;
+
+    // 첫 segment 는 채워지자마자, 그 뒤로는 hop 마다
+    if (filled_ == segment_ && (++since_segment_ >= hop_ || history_count_ == 0)) {
+        since_segment_ = 0;
+        finish_segment();
+    }
+
+    for (int b = 0; b < MOTION_SPECTRUM_BANDS; ++b) {
+        for (int i = 0; i < 3; ++i) sample.band_power[b][i] = static_cast<float>(mean_[b][i]);
+    }
+    sample.spectrum_valid = history_count_ > 0;
+}
+
+void MotionSpectrum::finish_segment() {
+    const size_t n = segment_;
+
+    // ring_[pos_ ..] 가 가장 오래된 샘플. 축별 평균 (중력, 장착 기울기) 을 빼고 창을 곱한다
+    std::array<double, 3> mean{};
+    for (int i = 0; i < 3; ++i) {
+        for (float v : ring_[i]) mean[i] += v;
+        mean[i] /= n;
+    }
+    for (size_t k = 0; k < n; ++k) {
+        const size_t j = (pos_ + k) % n;
+        const double w = window_[k];
+        xy_[k] = {w * (ring_[0][j] - mean[0]), w * (ring_[1][j] - mean[1])};
+        z_[k] = {w * (ring_[2][j] - mean[2]), 0.0};
+    }
+
+    // 실수 두 축을 복소 FFT 하나로: Z = FFT(x + iy) → X_k = (Z_k + Z*_{n-k}) / 2, Y_k = (Z_k - Z*_{n-k}) / 2i
+    plan_.forward(xy_.data());
+    plan_.forward(z_.data());
+
+    // 단측 PSD P_k = c·|X_k|² / (fs·Σw²), 밴드 파워 = Σ P_k·(fs/n) = Σ c·|X_k|² / (n·Σw²)
+    const double scale = 1.0 / (n * window_power_);
+    BandPowers& powers = history_[history_pos_];
+    for (int b = 0; b < MOTION_SPECTRUM_BANDS; ++b) {
+        std::array<double, 3> sum{};
+        for (size_t k = bins_[b].first; k < bins_[b].second; ++k) {
+            const std::complex<double> zk = xy_[k];
+            const std::complex<double> zc = std::conj(xy_[(n - k) % n]);
+            const double c = (k == 0 || k == n / 2) ? 1.0 : 2.0;
+            sum[0] += c * std::norm(zk + zc) * 0.25;
+            sum[1] += c * std::norm(zk - zc) * 0.25;
+            sum[2] += c * std::norm(z_[k]);
+        }
+        for (int i = 0; i < 3; ++i) powers[b][i] = sum[i] * scale;
+    }
+    history_pos_ = history_pos_ + 1 == average_ ? 0 : history_pos_ + 1;
+    if (history_count_ < average_) ++history_count_;
+
+    // 평균은 매번 다시 더한다 (average 개뿐이고 누적 오차가 없음)
+    mean_ = {};
+    for (size_t h = 0; h < history_count_; ++h) {
+        for (int b = 0; b < MOTION_SPECTRUM_BANDS; ++b) {
+            for (int i = 0; i < 3; ++i) mean_[b][i] += history_[h][b][i] / history_count_;
+        }
+    }
+}
+
+void compute_spectrum_features(SampleSpan<ImuData> imu, SummaryRow& row) {
+    if (imu.empty() || !imu.back().spectrum_valid) return;
+    for (int b = 0; b < MOTION_SPECTRUM_BANDS; ++b) {
+        for (int i = 0; i < 3; ++i) row.set(spectrum_column(b, i), imu.back().band_power[b][i]);
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "summary_features.hpp"
+
+// 밴드 파워 구간 [low_hz, high_hz). summary 컬럼은 name_x / name_y / name_z
+struct SpectrumBand {
+    const char* name;
+    double low_hz;
+    double high_hz;
+};
+
+// 멀미 대역 (차체 흔들림 0.08~0.5Hz), 운전 조작, 노면 진동. 밴드를 바꾸려면 이 표만 (개수는 MOTION_SPECTRUM_BANDS)
+constexpr std::array<SpectrumBand, MOTION_SPECTRUM_BANDS> motion_spectrum_bands = {{
+    {"psd_low", 0.08, 0.5},
+    {"psd_mid", 0.5, 2.0},
+    {"psd_high", 2.0, std::numeric_limits<double>::infinity()},
+}};
+
+// "psd_low_x" (axis 0~2). 컬럼 번호는 spectrum_column (summary_features.hpp)
+std::string spectrum_column_name(int band, int axis);
+
+// 복소 radix-2 FFT (in-place). twiddle / bit-reverse 표는 생성할 때 한 번만 계산해서 segment 마다 재사용
+class FftPlan {
+public:
+    explicit FftPlan(size_t n);   // n = 2의 거듭제곱
+    void forward(std::complex<double>* data) const;
+    size_t size() const { return n_; }
+
+private:
+    size_t n_;
+    std::vector<std::complex<double>> twiddles_;   // exp(-2πik/n), k < n/2
+    std::vector<uint32_t> bit_reverse_;
+};
+
+// 100 Hz ImuData 스트림의 축별 Welch PSD → motion_spectrum_bands 밴드 파워.
+// Hann 창 segment 가 hop 샘플마다 하나씩 끝나고 (기본 4096 샘플 = 41 s, 75% 겹침 → 10 s 마다) 그때만 FFT 2번 (x+iy, z).
+// 최근 average 개 segment 의 밴드 파워 평균 = 그 PSD 들의 평균 (Welch) 을 밴드로 적분한 값 (선형이라 같음).
+// 샘플당은 링 버퍼 쓰기뿐이고 segment 당 비용이 고정 → 초당 비용 일정. 버퍼는 생성할 때 한 번만 할당.
+// 결과는 ImuData::band_power / spectrum_valid 에 채워진다.
+class MotionSpectrum {
+public:
+    explicit MotionSpectrum(double fs = 100.0, size_t segment = 4096, size_t hop = 1024, size_t average = 8);
+    void process(ImuData& sample);
+    void reset();
+
+    double resolution_hz() const { return fs_ / segment_; }
+
+private:
+    using BandPowers = std::array<std::array<double, 3>, MOTION_SPECTRUM_BANDS>;
+
+    void finish_segment();
+
+    double fs_;
+    size_t segment_, hop_, average_;
+    FftPlan plan_;
+    std::vector<double> window_;                        // Hann
+    double window_power_ = 0.0;                         // Σw²
+    std::array<std::pair<size_t, size_t>, MOTION_SPECTRUM_BANDS> bins_{};   // 밴드별 [첫 bin, 끝 bin)
+
+    std::array<std::vector<float>, 3> ring_;            // 최근 segment 샘플 (축별)
+    size_t pos_ = 0;
+    size_t filled_ = 0;
+    size_t since_segment_ = 0;
+    std::vector<std::complex<double>> xy_, z_;          // FFT 작업 버퍼
+
+    std::vector<BandPowers> history_;                   // 최근 average 개 segment
+    size_t history_pos_ = 0;
+    size_t history_count_ = 0;
+    BandPowers mean_{};
+
+    bool has_prev_ = false;
+    double prev_t_ = 0.0;
+};
+
+// psd_*_x / _y / _z 컬럼 (구간 마지막 샘플의 밴드 파워, 첫 segment 전이면 기본값)
+void compute_spectrum_features(SampleSpan<ImuData> imu, SummaryRow& row);
@@ -0,0 +1,120 @@
+#include "msdv.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "reduce_kernels.hpp"
+
+namespace {
+    // ISO 2631-1:1997 Table 3, Wf
+    constexpr double F1 = 0.08;                     // band-limiting high-pass
+    constexpr double F2 = 0.63;                     // band-limiting low-pass
+    constexpr double F4 = 0.25,   Q4 = 0.86;        // a-v transition (f3 = ∞)
+    constexpr double F5 = 0.0625, Q5 = 0.80;        // upward step
+    constexpr double F6 = 0.1,    Q6 = 0.80;
+    const double Q_BUTTER = 1.0 / std::sqrt(2.0);
+
+    // 아날로그 (B0 s² + B1 s + B2) / (A0 s² + A1 s + A2) → bilinear, f_warp 에서 주파수 일치
+    Biquad bilinear(double B0, double B1, double B2,
+                    double A0, double A1, double A2,
+                    double fs, double f_warp) {
+        double w = 2.0 * M_PI * f_warp;
+        double K = w / std::tan(w / (2.0 * fs));
+        double K2 = K * K;
+
+        double a0 = A0 * K2 + A1 * K + A2;
+        Biquad q;
+        q.b0 = (B0 * K2 + B1 * K + B2) / a0;
+        q.b1 = 2.0 * (B2 - B0 * K2) / a0;
+        q.b2 = (B0 * K2 - B1 * K + B2) / a0;
+        q.a1 = 2.0 * (A2 - A0 * K2) / a0;
+        q.a2 = (A0 * K2 - A1 * K + A2) / a0;
+        return q;
+    }
+
+    // 로깅 루프가 멈췄다 재개한 경우 한 샘플 간격으로 제한
+    constexpr double MAX_SAMPLE_GAP = 0.1;
+}
+
+WfFilter::WfFilter(double fs) {
+    const double w1 = 2.0 * M_PI * F1;
+    const double w2 = 2.0 * M_PI * F2;
+    const double w4 = 2.0 * M_PI * F4;
+    const double w5 = 2.0 * M_PI * F5;
+    const double w6 = 2.0 * M_PI * F6;
+
+    // Hh = s² / (s² + ω1 s/Q + ω1²)
+    sections_[0] = bilinear(1.0, 0.0, 0.0, 1.0, w1 / Q_BUTTER, w1 * w1, fs, F1);
+    // Hl = ω2² / (s² + ω2 s/Q + ω2²)
+    sections_[1] = bilinear(0.0, 0.0, w2 * w2, 1.0, w2 / Q_BUTTER, w2 * w2, fs, F2);
+    // Ht = ω4² / (s² + ω4 s/Q4 + ω4²)
+    sections_[2] = bilinear(0.0, 0.0, w4 * w4, 1.0, w4 / Q4, w4 * w4, fs, F4);
+    // Hs = (s² + ω5 s/Q5 + ω5²) / (s² + ω6 s/Q6 + ω6²)
+    // (Wf 표의 0.2 Hz 부근 이득 ≈ 1 에 맞추려면 (ω6/ω5)² 보정을 곱하지 않는다)
+    sections_[3] = bilinear(1.0, w5 / Q5, w5 * w5, 1.0, w6 / Q6, w6 * w6, fs, F6);
+}
+
+double WfFilter::process(double x) {
+    for (auto& s : sections_) x = s.process(x);
+    return x;
+}
+
+void WfFilter::reset() {
+    for (auto& s : sections_) s.reset();
+}
+
+MsdvAccumulator::MsdvAccumulator(double fs)
+    : fs_(fs), filters_{WfFilter(fs), WfFilter(fs), WfFilter(fs)} {}
+
+void MsdvAccumulator::process(ImuData& sample) {
+    double dt = 1.0 / fs_;
+    if (has_prev_) {
+        dt = std::clamp(sample.source_timestamp - prev_t_, 0.0, MAX_SAMPLE_GAP);
+    }
+    has_prev_ = true;
+    prev_t_ = sample.source_timestamp;
+
+    for (int i = 0; i < 3; ++i) {
+        double x = sample.accel[i];
+        double aw = filters_[i].process(x);
+        integral_[i] += aw * aw * dt;
+        sample.accel_wf[i] = static_cast<float>(aw);
+        sample.msdv_sq[i] = integral_[i];
+    }
+}
+
+void MsdvAccumulator::reset() {
+    for (auto& f : filters_) f.reset();
+    integral_ = {};
+    has_prev_ = false;
+}
+
+MsdvSummary compute_msdv_summary(SampleSpan<ImuData> imu) {
+    MsdvSummary s;
+    if (imu.empty()) return s;
+
+    thread_local std::vector<float> aw[3];
+    for (auto& ch : aw) ch.resize(imu.size());
+    for (size_t k = 0; k < imu.size(); ++k) {
+        for (int i = 0; i < 3; ++i) aw[i][k] = imu[k].accel_wf[i];
+    }
+
+    const float* channels[3] = {aw[0].data(), aw[1].data(), aw[2].data()};
+    ChannelStats stats[3];
+    reduce_channels(channels, 3, imu.size(), stats);
+
+    for (int i = 0; i < 3; ++i) {
+        s.aw_rms[i] = stats[i].rms;
+        s.msdv[i] = std::sqrt(imu.back().msdv_sq[i]);
+    }
+    return s;
+}
+
+void compute_msdv_features(SampleSpan<ImuData> imu, SummaryRow& row) {
+    MsdvSummary s = compute_msdv_summary(imu);
+    for (int i = 0; i < 3; ++i) {
+        row.set(COL_AW_RMS_X + i, s.aw_rms[i]);
+        row.set(COL_MSDV_X + i, s.msdv[i]);
+    }
+}
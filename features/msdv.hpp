@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+
+#include "summary_features.hpp"
+
+// 2차 IIR 구간 (transposed direct form II)
+struct Biquad {
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0;
+    double a1 = 0.0, a2 = 0.0;
+    double z1 = 0.0, z2 = 0.0;
+
+    double process(double x) {
+        double y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+        return y;
+    }
+    void reset() { z1 = z2 = 0.0; }
+};
+
+// ISO 2631-1 Wf (멀미) 주파수 가중: band-limiting HP/LP + a-v transition + upward step.
+// 4개 biquad 직렬, 샘플당 고정 비용.
+class WfFilter {
+public:
+    explicit WfFilter(double fs = 100.0);
+    double process(double x);
+    void reset();
+
+private:
+    std::array<Biquad, 4> sections_;
+};
+
+// 100 Hz ImuData 스트림에 Wf 가중을 걸고 축별 ∫aw² dt 를 계속 누적한다.
+// 결과는 ImuData::accel_wf / msdv_sq 에 채워진다.
+class MsdvAccumulator {
+public:
+    explicit MsdvAccumulator(double fs = 100.0);
+    void process(ImuData& sample);
+    void reset();
+
+private:
+    double fs_;
+    std::array<WfFilter, 3> filters_;
+    std::array<double, 3> integral_{};
+    bool has_prev_ = false;
+    double prev_t_ = 0.0;
+};
+
+// 윈도우 가중 RMS (m/s²) 와 누적 MSDV (m/s^1.5)
+struct MsdvSummary {
+    std::array<double, 3> aw_rms{};
+    std::array<double, 3> msdv{};
+};
+
+MsdvSummary compute_msdv_summary(SampleSpan<ImuData> imu);
+
+// aw_rms_* / msdv_* 컬럼
+void compute_msdv_features(SampleSpan<ImuData> imu, SummaryRow& row);
@@ -0,0 +1,204 @@
+#include "reduce_kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define REDUCE_HAVE_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define REDUCE_HAVE_NEON 1
+#endif
+
+namespace {
+    // 합/제곱합은 double 로 누적 (500 샘플 이상에서도 스칼라 버전과 같은 정밀도)
+    struct RawSums {
+        double sum;
+        double sum_sq;
+        float min;
+        float max;
+    };
+
+    using ReduceFn = RawSums (*)(const float*, size_t);
+
+    RawSums reduce_scalar(const float* x, size_t n) {
+        RawSums s{0.0, 0.0, x[0], x[0]};
+        for (size_t i = 0; i < n; ++i) {
+            double v = x[i];
+            s.sum += v;
+            s.sum_sq += v * v;
+            s.min = std::min(s.min, x[i]);
+            s.max = std::max(s.max, x[i]);
+        }
+        return s;
+    }
+
+#ifdef REDUCE_HAVE_X86
+    RawSums reduce_sse2(const float* x, size_t n) {
+        __m128d sum = _mm_setzero_pd();
+        __m128d sum_sq = _mm_setzero_pd();
+        __m128 vmin = _mm_set1_ps(x[0]);
+        __m128 vmax = vmin;
+
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128 v = _mm_loadu_ps(x + i);
+            __m128d lo = _mm_cvtps_pd(v);
+            __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+            sum = _mm_add_pd(sum, _mm_add_pd(lo, hi));
+            sum_sq = _mm_add_pd(sum_sq, _mm_add_pd(_mm_mul_pd(lo, lo), _mm_mul_pd(hi, hi)));
+            vmin = _mm_min_ps(vmin, v);
+            vmax = _mm_max_ps(vmax, v);
+        }
+
+        double sums[2], sqs[2];
+        float mins[4], maxs[4];
+        _mm_storeu_pd(sums, sum);
+        _mm_storeu_pd(sqs, sum_sq);
+        _mm_storeu_ps(mins, vmin);
+        _mm_storeu_ps(maxs, vmax);
+
+        RawSums s{sums[0] + sums[1], sqs[0] + sqs[1],
+                  *std::min_element(mins, mins + 4), *std::max_element(maxs, maxs + 4)};
+        for (; i < n; ++i) {
+            double v = x[i];
+            s.sum += v;
+            s.sum_sq += v * v;
+            s.min = std::min(s.min, x[i]);
+            s.max = std::max(s.max, x[i]);
+        }
+        return s;
+    }
+
+    __attribute__((target("avx2")))
+    RawSums reduce_avx2(const float* x, size_t n) {
+        __m256d sum = _mm256_setzero_pd();
+        __m256d sum_sq = _mm256_setzero_pd();
+        __m256 vmin = _mm256_set1_ps(x[0]);
+        __m256 vmax = vmin;
+
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 v = _mm256_loadu_ps(x + i);
+            __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+            __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+            sum = _mm256_add_pd(sum, _mm256_add_pd(lo, hi));
+            sum_sq = _mm256_add_pd(sum_sq, _mm256_add_pd(_mm256_mul_pd(lo, lo), _mm256_mul_pd(hi, hi)));
+            vmin = _mm256_min_ps(vmin, v);
+            vmax = _mm256_max_ps(vmax, v);
+        }
+
+        double sums[4], sqs[4];
+        float mins[8], maxs[8];
+        _mm256_storeu_pd(sums, sum);
+        _mm256_storeu_pd(sqs, sum_sq);
+        _mm256_storeu_ps(mins, vmin);
+        _mm256_storeu_ps(maxs, vmax);
+
+        RawSums s{sums[0] + sums[1] + sums[2] + sums[3], sqs[0] + sqs[1] + sqs[2] + sqs[3],
+                  *std::min_element(mins, mins + 8), *std::max_element(maxs, maxs + 8)};
+        for (; i < n; ++i) {
+            double v = x[i];
+            s.sum += v;
+            s.sum_sq += v * v;
+            s.min = std::min(s.min, x[i]);
+            s.max = std::max(s.max, x[i]);
+        }
+        return s;
+    }
+#endif
+
+#ifdef REDUCE_HAVE_NEON
+    RawSums reduce_neon(const float* x, size_t n) {
+        float64x2_t sum = vdupq_n_f64(0.0);
+        float64x2_t sum_sq = vdupq_n_f64(0.0);
+        float32x4_t vmin = vdupq_n_f32(x[0]);
+        float32x4_t vmax = vmin;
+
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            float32x4_t v = vld1q_f32(x + i);
+            float64x2_t lo = vcvt_f64_f32(vget_low_f32(v));
+            float64x2_t hi = vcvt_high_f64_f32(v);
+            sum = vaddq_f64(sum, vaddq_f64(lo, hi));
+            sum_sq = vfmaq_f64(sum_sq, lo, lo);
+            sum_sq = vfmaq_f64(sum_sq, hi, hi);
+            vmin = vminq_f32(vmin, v);
+            vmax = vmaxq_f32(vmax, v);
+        }
+
+        RawSums s{vaddvq_f64(sum), vaddvq_f64(sum_sq), vminvq_f32(vmin), vmaxvq_f32(vmax)};
+        for (; i < n; ++i) {
+            double v = x[i];
+            s.sum += v;
+            s.sum_sq += v * v;
+            s.min = std::min(s.min, x[i]);
+            s.max = std::max(s.max, x[i]);
+        }
+        return s;
+    }
+#endif
+
+    ChannelStats to_stats(const RawSums& s, size_t n) {
+        ChannelStats stats;
+        stats.mean = s.sum / n;
+        stats.rms = std::sqrt(s.sum_sq / n);
+        stats.variance = std::max(0.0, s.sum_sq / n - stats.mean * stats.mean);
+        stats.min = s.min;
+        stats.max = s.max;
+        return stats;
+    }
+
+    template <ReduceFn fn>
+    ChannelStats reduce_with(const float* values, size_t n) {
+        if (n == 0) return ChannelStats{};
+        return to_stats(fn(values, n), n);
+    }
+
+    const ReduceKernel& kernel() {
+        static const ReduceKernel choice = select_reduce_kernel(std::getenv("MOTIONSICK_REDUCE_KERNEL"));
+        return choice;
+    }
+}
+
+std::vector<ReduceKernel> available_reduce_kernels() {
+    std::vector<ReduceKernel> kernels = {{"scalar", reduce_with<reduce_scalar>}};
+#ifdef REDUCE_HAVE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) kernels.push_back({"sse2", reduce_with<reduce_sse2>});
+    if (__builtin_cpu_supports("avx2")) kernels.push_back({"avx2", reduce_with<reduce_avx2>});
+#endif
+#ifdef REDUCE_HAVE_NEON
+    kernels.push_back({"neon", reduce_with<reduce_neon>});  // aarch64 에서는 NEON 이 항상 있음
+#endif
+    return kernels;
+}
+
+ReduceKernel select_reduce_kernel(const char* forced) {
+    std::vector<ReduceKernel> kernels = available_reduce_kernels();
+    if (forced && std::strcmp(forced, "scalar") == 0) return kernels.front();
+    // 가장 빠른 것 (목록 끝) 부터, sse2 를 지정하면 avx2 는 건너뜀
+    for (auto it = kernels.rbegin(); it != kernels.rend(); ++it) {
+        if (forced && std::strcmp(forced, "sse2") == 0 && std::strcmp(it->name, "avx2") == 0) continue;
+        return *it;
+    }
+    return kernels.front();
+}
+
+ChannelStats reduce_channel(const float* values, size_t n) {
+    return kernel().reduce(values, n);
+}
+
+void reduce_channels(const float* const* channels, size_t n_channels, size_t n, ChannelStats* out) {
+    for (size_t c = 0; c < n_channels; ++c) {
+        out[c] = reduce_channel(channels[c], n);
+    }
+}
+
+const char* reduce_kernel_name() {
+    return kernel().name;
+}
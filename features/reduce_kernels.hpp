@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// 채널 하나에 대한 통계 (variance 는 모집단 분산)
+struct ChannelStats {
+    double mean = 0.0;
+    double rms = 0.0;
+    double variance = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+};
+
+// 채널 하나 (연속된 float n 개). n == 0 이면 전부 0.
+ChannelStats reduce_channel(const float* values, size_t n);
+
+// structure-of-arrays 입력: channels[c] 가 채널 c 의 샘플 n 개를 가리킨다
+void reduce_channels(const float* const* channels, size_t n_channels, size_t n, ChannelStats* out);
+
+// 실행 중 선택된 구현 이름: "avx2", "sse2", "neon", "scalar"
+// 환경변수 MOTIONSICK_REDUCE_KERNEL=scalar / sse2 로 낮춰서 비교 가능
+const char* reduce_kernel_name();
+
+// 구현 하나 (motionsick_kernel_bench 가 scalar 와 비교)
+struct ReduceKernel {
+    const char* name;
+    ChannelStats (*reduce)(const float* values, size_t n);
+};
+
+// 이 CPU 에서 돌릴 수 있는 구현들, scalar 가 첫 번째이고 뒤로 갈수록 빠름
+std::vector<ReduceKernel> available_reduce_kernels();
+
+// MOTIONSICK_REDUCE_KERNEL 값이 forced (nullptr = 없음) 일 때 reduce_channel 이 고르는 구현
+ReduceKernel select_reduce_kernel(const char* forced);
@@ -0,0 +1,165 @@
+#include "skin_roi.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace {
+    constexpr size_t MAX_POLYGONS = 8;        // face + holes
+    constexpr size_t MAX_CROSSINGS = 256;     // scanline 하나당
+
+    struct Crossing {
+        float x;
+        uint8_t poly;
+    };
+
+    // BGR 연속 구간의 채널 합 (sums: b, g, r)
+    void sum_bgr_span(const uint8_t* p, size_t n, uint64_t sums[3]) {
+        size_t i = 0;
+
+#if defined(__SSE2__)
+        // 16 픽셀(48 바이트)씩: 바이트 위치 % 3 으로 채널 마스크 → SAD 로 합산
+        static const struct Masks {
+            __m128i m[3][3];
+            Masks() {
+                for (int k = 0; k < 3; ++k) {
+                    for (int c = 0; c < 3; ++c) {
+                        alignas(16) uint8_t bytes[16];
+                        for (int b = 0; b < 16; ++b) bytes[b] = ((16 * k + b) % 3 == c) ? 0xFF : 0x00;
+                        m[k][c] = _mm_load_si128(reinterpret_cast<const __m128i*>(bytes));
+                    }
+                }
+            }
+        } masks;
+
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc[3] = {zero, zero, zero};
+        for (; i + 16 <= n; i += 16) {
+            const uint8_t* q = p + i * 3;
+            __m128i v[3] = {
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(q)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(q + 16)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(q + 32))
+            };
+            for (int c = 0; c < 3; ++c) {
+                for (int k = 0; k < 3; ++k) {
+                    acc[c] = _mm_add_epi64(acc[c], _mm_sad_epu8(_mm_and_si128(v[k], masks.m[k][c]), zero));
+                }
+            }
+        }
+        for (int c = 0; c < 3; ++c) {
+            alignas(16) uint64_t lanes[2];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc[c]);
+            sums[c] += lanes[0] + lanes[1];
+        }
+#elif defined(__aarch64__)
+        // vld3q_u8 가 16 픽셀을 채널별로 풀어줌. u16 누적은 64 회마다 비움 (오버플로 방지)
+        while (i + 16 <= n) {
+            uint16x8_t acc[3] = {vdupq_n_u16(0), vdupq_n_u16(0), vdupq_n_u16(0)};
+            for (int it = 0; it < 64 && i + 16 <= n; ++it, i += 16) {
+                uint8x16x3_t px = vld3q_u8(p + i * 3);
+                acc[0] = vpadalq_u8(acc[0], px.val[0]);
+                acc[1] = vpadalq_u8(acc[1], px.val[1]);
+                acc[2] = vpadalq_u8(acc[2], px.val[2]);
+            }
+            for (int c = 0; c < 3; ++c) sums[c] += vaddlvq_u16(acc[c]);
+        }
+#endif
+
+        for (; i < n; ++i) {
+            sums[0] += p[i * 3 + 0];
+            sums[1] += p[i * 3 + 1];
+            sums[2] += p[i * 3 + 2];
+        }
+    }
+}
+
+size_t skin_roi_mean_rgb(const uint8_t* bgr, int width, int height, int stride,
+                         const PolygonI16& face,
+                         const PolygonI16* holes, size_t n_holes,
+                         double out_rgb[3]) {
+    out_rgb[0] = out_rgb[1] = out_rgb[2] = 0.0;
+    if (!bgr || face.count < 3 || width <= 0 || height <= 0) return 0;
+
+    PolygonI16 polys[MAX_POLYGONS];
+    size_t n_polys = 0;
+    polys[n_polys++] = face;
+    for (size_t h = 0; h < n_holes && n_polys < MAX_POLYGONS; ++h) {
+        if (holes[h].count >= 3) polys[n_polys++] = holes[h];
+    }
+
+    // face bounding box 의 행만 훑는다
+    int y_min = height, y_max = -1;
+    for (size_t i = 0; i < face.count; ++i) {
+        y_min = std::min<int>(y_min, face.xy[2 * i + 1]);
+        y_max = std::max<int>(y_max, face.xy[2 * i + 1]);
+    }
+    y_min = std::max(y_min, 0);
+    y_max = std::min(y_max, height - 1);
+
+    uint64_t sums[3] = {0, 0, 0};   // b, g, r
+    size_t pixels = 0;
+
+    Crossing crossings[MAX_CROSSINGS];
+
+    // 픽셀 중심 = 정수 좌표 (cv2.fillPoly 와 같은 규칙)
+    for (int y = y_min; y <= y_max; ++y) {
+        const float yc = static_cast<float>(y);
+        size_t n_cross = 0;
+
+        for (size_t p = 0; p < n_polys; ++p) {
+            const PolygonI16& poly = polys[p];
+            for (size_t i = 0; i < poly.count; ++i) {
+                size_t j = (i + 1 == poly.count) ? 0 : i + 1;
+                float ax = poly.xy[2 * i], ay = poly.xy[2 * i + 1];
+                float bx = poly.xy[2 * j], by = poly.xy[2 * j + 1];
+                // 반열린 규칙: 꼭짓점이 scanline 위에 있어도 한 번만 센다
+                if ((ay <= yc) == (by <= yc)) continue;
+                if (n_cross == MAX_CROSSINGS) break;
+                crossings[n_cross++] = {ax + (yc - ay) * (bx - ax) / (by - ay), static_cast<uint8_t>(p)};
+            }
+        }
+
+        std::sort(crossings, crossings + n_cross,
+                  [](const Crossing& a, const Crossing& b) { return a.x < b.x; });
+
+        // even-odd: face 안이면서 어떤 hole 에도 들어있지 않은 구간
+        bool parity[MAX_POLYGONS] = {};
+        int holes_inside = 0;
+        bool inside = false;
+        float span_start = 0.0f;
+        const uint8_t* row = bgr + static_cast<size_t>(y) * stride;
+
+        for (size_t c = 0; c < n_cross; ++c) {
+            uint8_t p = crossings[c].poly;
+            parity[p] = !parity[p];
+            if (p != 0) holes_inside += parity[p] ? 1 : -1;
+
+            bool now_inside = parity[0] && holes_inside == 0;
+            if (now_inside == inside) continue;
+
+            if (now_inside) {
+                span_start = crossings[c].x;
+            } else {
+                int x0 = std::max(0, static_cast<int>(std::ceil(span_start)));
+                int x1 = std::min(width, static_cast<int>(std::ceil(crossings[c].x)));
+                if (x1 > x0) {
+                    sum_bgr_span(row + static_cast<size_t>(x0) * 3, static_cast<size_t>(x1 - x0), sums);
+                    pixels += static_cast<size_t>(x1 - x0);
+                }
+            }
+            inside = now_inside;
+        }
+    }
+
+    if (pixels == 0) return 0;
+    out_rgb[0] = static_cast<double>(sums[2]) / pixels;
+    out_rgb[1] = static_cast<double>(sums[1]) / pixels;
+    out_rgb[2] = static_cast<double>(sums[0]) / pixels;
+    return pixels;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 픽셀 좌표 다각형 (x0, y0, x1, y1, ...)
+struct PolygonI16 {
+    const int16_t* xy = nullptr;
+    size_t count = 0;   // 꼭짓점 수
+};
+
+// BGR8 이미지에서 face 다각형 안, holes(눈/입술) 밖 픽셀의 평균 RGB 를 한 번에 계산한다.
+// - scanline 마다 모든 다각형의 교차점을 구해 even-odd 규칙으로 구간을 만들고
+//   구간 안 픽셀(픽셀 중심 기준)만 SIMD 로 합산한다. 마스크 이미지를 만들지 않는다.
+// - 반환값: 포함된 픽셀 수 (0 이면 out_rgb 는 0)
+size_t skin_roi_mean_rgb(const uint8_t* bgr, int width, int height, int stride,
+                         const PolygonI16& face,
+                         const PolygonI16* holes, size_t n_holes,
+                         double out_rgb[3]);
@@ -0,0 +1,22 @@
+// skin_roi_mean_rgb 의 C 진입점 (libmotionsick_skin_roi.so, python/check_skin_roi.py 가 ctypes 로 부른다)
+
+#include "skin_roi.hpp"
+
+namespace {
+    constexpr int MAX_POLYGONS = 8;
+}
+
+// points = 다각형들의 (x, y) 를 이어 붙인 것, counts[i] = i 번째 다각형 꼭짓점 수. 0 번이 face, 나머지는 hole
+extern "C" size_t motionsick_skin_roi_mean_rgb(const uint8_t* bgr, int width, int height, int stride,
+                                               const int16_t* points, const uint16_t* counts, int n_polygons,
+                                               double* out_rgb) {
+    if (n_polygons < 1 || n_polygons > MAX_POLYGONS) return 0;
+
+    PolygonI16 polys[MAX_POLYGONS];
+    size_t offset = 0;
+    for (int p = 0; p < n_polygons; ++p) {
+        polys[p] = {points + offset * 2, counts[p]};
+        offset += counts[p];
+    }
+    return skin_roi_mean_rgb(bgr, width, height, stride, polys[0], polys + 1, n_polygons - 1, out_rgb);
+}
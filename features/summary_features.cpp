@@ -0,0 +1,351 @@
+#include "summary_features.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iterator>
+
+#include "head_pose.hpp"
+#include "motion_spectrum.hpp"
+#include "reduce_kernels.hpp"
+#include "../logger/estimate_heart_rate_from_rgb.hpp"
+
+namespace {
+    // 채널별로 모아두는 SoA 임시 버퍼 (tick 마다 재할당하지 않도록 스레드별로 재사용)
+    struct FeatureScratch {
+        std::vector<float> r, g, b;
+        std::vector<float> imu[6];
+        std::vector<float> blendshapes;       // blend_shape_keys.size() × stride
+        std::vector<size_t> blendshape_counts;
+        RppgScratch rppg;
+    };
+
+    FeatureScratch& scratch() {
+        thread_local FeatureScratch s;
+        return s;
+    }
+
+    // 로컬 ENU 궤적의 직선성 (주축 분산 비율, 0: 등방 ~ 1: 직선).
+    // lat-lon 회귀 R² 와 달리 진행 방향(남북/동서)에 무관하다.
+    double compute_straightness(SampleSpan<GpsData> gps) {
+        size_t n = 0;
+        double mean_e = 0.0, mean_n = 0.0;
+        for (const auto& g : gps) {
+            mean_e += g.east;
+            mean_n += g.north;
+            ++n;
+        }
+        if (n < 2) return 0.0;
+        mean_e /= n;
+        mean_n /= n;
+
+        double See = 0.0, Snn = 0.0, Sen = 0.0;
+        for (const auto& g : gps) {
+            double de = g.east - mean_e;
+            double dn = g.north - mean_n;
+            See += de * de;
+            Snn += dn * dn;
+            Sen += de * dn;
+        }
+
+        // 2x2 공분산 고유값 차이 / 합
+        double half_diff = 0.5 * (See - Snn);
+        double spread = std::sqrt(half_diff * half_diff + Sen * Sen);
+        return 2.0 * spread / (See + Snn + 1e-9);  // 1e-9: divide-by-zero 방지
+    }
+
+    // SummaryColumn 순서의 이름 (COL_PSD_FIRST 앞까지, 스펙트럼 / 얼굴 컬럼은 summary_headers 에서 생성)
+    constexpr const char* fixed_column_names[] = {
+        "timestamp",
+        "멀미", "불편함", "불안감",
+        "speed", "gps_speed", "trajectory",
+        "heading", "heading_rate", "long_acc", "lat_acc", "curvature",
+        "acc_rms_x", "acc_rms_y", "acc_rms_z", "roll_rate_rms", "pitch_rate_rms", "yaw_rate_rms",
+        "aw_rms_x", "aw_rms_y", "aw_rms_z", "msdv_x", "msdv_y", "msdv_z",
+        "can_speed", "steer_angle_rms", "steer_rate_rms", "accel_pedal_mean", "brake_pressure_mean", "brake_pressure_max"
+    };
+    static_assert(std::size(fixed_column_names) == COL_PSD_FIRST, "fixed_column_names must follow SummaryColumn");
+
+    // FaceColumn 순서의 이름 (FACE_BLENDSHAPE_FIRST 앞까지)
+    constexpr const char* face_column_names[] = {
+        "hr", "hr_snr", "hr_method", "r", "g", "b", "head_tv", "head_rv",
+        "head_tv_rms", "head_tv_peak",
+        "head_pitch_rate_rms", "head_yaw_rate_rms", "head_roll_rate_rms",
+        "head_pitch_rate_peak", "head_yaw_rate_peak", "head_roll_rate_peak",
+        "head_ang_acc_rms", "head_ang_acc_peak"
+    };
+    static_assert(std::size(face_column_names) == FACE_BLENDSHAPE_FIRST, "face_column_names must follow FaceColumn");
+}
+
+// _neutral 을 뺀 MediaPipe blendshape 전부 (blend_shape_keys[k] = BLENDSHAPE_NAMES[k + SUMMARY_BLENDSHAPE_FIRST])
+const std::vector<std::string> blend_shape_keys(std::begin(BLENDSHAPE_NAMES) + SUMMARY_BLENDSHAPE_FIRST,
+                                                std::end(BLENDSHAPE_NAMES));
+
+const std::vector<std::string> face_feature_keys = [] {
+    std::vector<std::string> k(std::begin(face_column_names), std::end(face_column_names));
+    k.insert(k.end(), std::begin(BLENDSHAPE_NAMES) + SUMMARY_BLENDSHAPE_FIRST, std::end(BLENDSHAPE_NAMES));
+    return k;
+}();
+
+std::string face_column_prefix(int source_id) {
+    if (source_id <= 0 || source_id >= MAX_FACE_SOURCES) return "";
+    return std::string(FACE_SOURCE_NAMES[source_id]) + "_";
+}
+
+// 이름은 시작할 때 한 번만 만든다 (행에는 컬럼 번호만)
+const std::vector<std::string> summary_headers = [] {
+    std::vector<std::string> h(std::begin(fixed_column_names), std::end(fixed_column_names));
+    // 밴드 파워 (motion_spectrum_bands 순서, 밴드마다 x, y, z)
+    for (int band = 0; band < MOTION_SPECTRUM_BANDS; ++band) {
+        for (int axis = 0; axis < 3; ++axis) h.push_back(spectrum_column_name(band, axis));
+    }
+    // 운전자 컬럼이 먼저, 추가 카메라는 뒤에 prefix 붙여서
+    for (int source = 0; source < MAX_FACE_SOURCES; ++source) {
+        std::string prefix = face_column_prefix(source);
+        for (const char* key : face_column_names) h.push_back(prefix + key);
+        for (int k = SUMMARY_BLENDSHAPE_FIRST; k < BLENDSHAPE_COUNT; ++k) h.push_back(prefix + BLENDSHAPE_NAMES[k]);
+    }
+    return h;
+}();
+
+const std::array<std::string, 3> toggle_columns = {"멀미", "불편함", "불안감"};
+
+void reserve_feature_scratch(size_t max_samples) {
+    FeatureScratch& sc = scratch();
+    sc.r.reserve(max_samples);
+    sc.g.reserve(max_samples);
+    sc.b.reserve(max_samples);
+    for (auto& ch : sc.imu) ch.reserve(max_samples);
+    sc.blendshapes.reserve(blend_shape_keys.size() * max_samples);
+    sc.blendshape_counts.reserve(blend_shape_keys.size());
+    sc.rppg.reserve(max_samples);
+}
+
+void ToggleLabeler::apply(SampleSpan<ToggleEvent> events, SummaryRow& row) {
+    std::array<int, 3> on_during = state_;
+    for (const auto& ev : events) {
+        if (ev.button < 0 || ev.button >= 3) continue;
+        state_[ev.button] = ev.state ? 1 : 0;
+        on_during[ev.button] |= state_[ev.button];
+    }
+    for (int i = 0; i < 3; ++i) row.set(COL_MOTION_SICK + i, on_during[i]);
+}
+
+void ToggleLabeler::advance(SampleSpan<ToggleEvent> events) {
+    for (const auto& ev : events) {
+        if (ev.button >= 0 && ev.button < 3) state_[ev.button] = ev.state ? 1 : 0;
+    }
+}
+
+void compute_face_features(SampleSpan<FaceData> faces, SummaryRow& row, int source) {
+    if (faces.size() < FACE_MIN_SAMPLES_FOR_FEATURES) return;
+
+    // 평균 RGB 추출
+    FeatureScratch& sc = scratch();
+    std::vector<float>& r_vals = sc.r;
+    std::vector<float>& g_vals = sc.g;
+    std::vector<float>& b_vals = sc.b;
+    r_vals.clear(); g_vals.clear(); b_vals.clear();
+    double rgb_start = 0.0, rgb_end = 0.0;
+    for (const auto& f : faces) {
+        if (f.has_rgb) {
+            if (r_vals.empty()) rgb_start = f.source_timestamp;
+            rgb_end = f.source_timestamp;
+            r_vals.push_back(f.avg_rgb[0]);
+            g_vals.push_back(f.avg_rgb[1]);
+            b_vals.push_back(f.avg_rgb[2]);
+        }
+    }
+    // rPPG 샘플링 주파수는 RGB 가 있는 프레임만으로 (공유메모리 miss 로 빠진 프레임은 세지 않음)
+    double fps = r_vals.size() >= 2 && rgb_end > rgb_start ? (r_vals.size() - 1) / (rgb_end - rgb_start) : 0.0;
+
+    if (!r_vals.empty()) {
+        const float* rgb[3] = {r_vals.data(), g_vals.data(), b_vals.data()};
+        ChannelStats rgb_stats[3];
+        reduce_channels(rgb, 3, r_vals.size(), rgb_stats);
+        row.set(face_column(source, FACE_R), rgb_stats[0].mean);
+        row.set(face_column(source, FACE_G), rgb_stats[1].mean);
+        row.set(face_column(source, FACE_B), rgb_stats[2].mean);
+    }
+
+    // POS / CHROM / GREEN 중 SNR 이 가장 높은 HR (필터링은 HeartRateSmoother 에서)
+    RppgEstimate pulse = estimate_heart_rate_from_rgb(r_vals, g_vals, b_vals, fps, sc.rppg);
+    row.set(face_column(source, FACE_HR), pulse.bpm);
+    row.set(face_column(source, FACE_HR_SNR), pulse.method >= 0 ? pulse.snr_db : 0.0);
+    row.set(face_column(source, FACE_HR_METHOD), pulse.method);
+
+    // 머리 이동/회전 속도 (쿼터니언 기반, 힙 할당 없음)
+    HeadKinematics head;
+    for (const auto& f : faces) head.add(f);
+    HeadKinematicsSummary hk = head.summary();
+
+    row.set(face_column(source, FACE_HEAD_TV), hk.tv_mean);
+    row.set(face_column(source, FACE_HEAD_RV), hk.rv_mean);
+    row.set(face_column(source, FACE_HEAD_TV_RMS), hk.tv_rms);
+    row.set(face_column(source, FACE_HEAD_TV_PEAK), hk.tv_peak);
+    for (int axis = 0; axis < 3; ++axis) {   // pitch, yaw, roll
+        row.set(face_column(source, FACE_HEAD_PITCH_RATE_RMS + axis), hk.rate_rms[axis]);
+        row.set(face_column(source, FACE_HEAD_PITCH_RATE_PEAK + axis), hk.rate_peak[axis]);
+    }
+    row.set(face_column(source, FACE_HEAD_ANG_ACC_RMS), hk.ang_acc_rms);
+    row.set(face_column(source, FACE_HEAD_ANG_ACC_PEAK), hk.ang_acc_peak);
+
+    // blend shapes: 키마다 한 채널 (프레임에 없는 키는 그 채널만 건너뜀)
+    const size_t n_keys = blend_shape_keys.size();
+    const size_t stride = faces.size();
+    sc.blendshapes.resize(n_keys * stride);
+    sc.blendshape_counts.assign(n_keys, 0);
+
+    for (const auto& face : faces) {
+        for (size_t k = 0; k < n_keys; ++k) {
+            float value = face.blendshapes[k + SUMMARY_BLENDSHAPE_FIRST];
+            if (std::isnan(value)) continue;
+            sc.blendshapes[k * stride + sc.blendshape_counts[k]++] = value;
+        }
+    }
+
+    for (size_t k = 0; k < n_keys; ++k) {
+        if (sc.blendshape_counts[k] == 0) continue;
+        row.set(face_column(source, FACE_BLENDSHAPE_FIRST + static_cast<int>(k)),
+                reduce_channel(&sc.blendshapes[k * stride], sc.blendshape_counts[k]).mean);
+    }
+}
+
+void compute_imu_features(SampleSpan<ImuData> imu, SummaryRow& row) {
+    FeatureScratch& sc = scratch();
+    for (auto& ch : sc.imu) ch.resize(imu.size());
+
+    // AoS → SoA (ax, ay, az, gx, gy, gz)
+    size_t n = 0;
+    for (const auto& s : imu) {
+        sc.imu[0][n] = s.accel[0]; sc.imu[1][n] = s.accel[1]; sc.imu[2][n] = s.accel[2];
+        sc.imu[3][n] = s.gyro[0];  sc.imu[4][n] = s.gyro[1];  sc.imu[5][n] = s.gyro[2];
+        ++n;
+    }
+
+    const float* channels[6];
+    for (int c = 0; c < 6; ++c) channels[c] = sc.imu[c].data();
+    ChannelStats stats[6];
+    reduce_channels(channels, 6, n, stats);
+
+    // acc_rms_x/y/z, roll/pitch/yaw_rate_rms 가 연속 컬럼
+    for (int c = 0; c < 6; ++c) row.set(COL_ACC_RMS_X + c, stats[c].rms);
+}
+
+void compute_gps_features(SampleSpan<GpsData> gps, SummaryRow& row) {
+    if (gps.empty()) return;
+
+    double speed_sum = 0.0;
+    for (const auto& g : gps) speed_sum += g.speed;
+    row.set(COL_GPS_SPEED, speed_sum / gps.size());   // speed 는 GPS + IMU 융합 (compute_fusion_features)
+
+    row.set(COL_TRAJECTORY, compute_straightness(gps));
+
+    // 선회/제동은 가장 최근 fix 의 순간값
+    const GpsData& last = gps.back();
+    if (last.kinematics_valid) {
+        row.set(COL_HEADING, last.heading);
+        row.set(COL_HEADING_RATE, last.heading_rate);
+        row.set(COL_LONG_ACC, last.long_acc);
+        row.set(COL_LAT_ACC, last.lat_acc);
+        row.set(COL_CURVATURE, last.curvature);
+    }
+}
+
+void compute_can_features(SampleSpan<CanData> can, SummaryRow& row) {
+    struct Channel {
+        size_t n = 0;
+        double sum = 0.0, sum_sq = 0.0, max = 0.0;
+
+        void add(float v) {
+            if (std::isnan(v)) return;
+            max = n ? std::max(max, static_cast<double>(v)) : v;
+            ++n;
+            sum += v;
+            sum_sq += static_cast<double>(v) * v;
+        }
+        double mean() const { return sum / n; }
+        double rms() const { return std::sqrt(sum_sq / n); }
+    };
+
+    Channel speed, angle, rate, pedal, brake;
+    for (const auto& c : can) {
+        speed.add(c.speed);
+        angle.add(c.steer_angle);
+        rate.add(c.steer_rate);
+        pedal.add(c.accel_pedal);
+        brake.add(c.brake_pressure);
+    }
+
+    if (speed.n) row.set(COL_CAN_SPEED, speed.mean());
+    if (angle.n) row.set(COL_STEER_ANGLE_RMS, angle.rms());
+    if (rate.n) row.set(COL_STEER_RATE_RMS, rate.rms());
+    if (pedal.n) row.set(COL_ACCEL_PEDAL_MEAN, pedal.mean());
+    if (brake.n) {
+        row.set(COL_BRAKE_PRESSURE_MEAN, brake.mean());
+        row.set(COL_BRAKE_PRESSURE_MAX, brake.max);
+    }
+}
+
+double HeartRateSmoother::update(double hr, double snr_db) {
+    if (hr <= 30 || hr >= 180) return 0.0;  // 유효한 범위 필터링
+    if (snr_db < HR_MIN_SNR_DB) return 0.0;  // 펄스가 잡음보다 약한 창 (조명 변화 등) 은 히스토리에 넣지 않음
+
+    history_[next_] = hr;  // 가득 찼으면 가장 오래된 값 자리
+    next_ = (next_ + 1) % HISTORY;
+    if (count_ < HISTORY) ++count_;
+
+    // 오래된 값부터 (더하는 순서를 예전 vector 버전과 같게)
+    const size_t first = count_ < HISTORY ? 0 : next_;
+    auto at = [this, first](size_t i) { return history_[(first + i) % HISTORY]; };
+
+    // 평균과 표준편차 계산
+    double sum = 0.0, sq_sum = 0.0;
+    for (size_t i = 0; i < count_; ++i) {
+        sum += at(i);
+        sq_sum += at(i) * at(i);
+    }
+    double mean = sum / count_;
+    double std_dev = std::sqrt(sq_sum / count_ - mean * mean);
+
+    // 이상치 제거 (mean ± std 범위 내 값만 평균)
+    double kept_sum = 0.0;
+    size_t kept = 0;
+    for (size_t i = 0; i < count_; ++i) {
+        double val = at(i);
+        if (val >= mean - std_dev && val <= mean + std_dev) {
+            kept_sum += val;
+            ++kept;
+        }
+    }
+
+    if (kept == 0) return 0.0;
+    return kept_sum / kept;
+}
+
+void format_summary_timestamp(double epoch_seconds, char* out) {
+    std::time_t t = static_cast<std::time_t>(epoch_seconds);
+    std::tm tm_buf{};
+    localtime_r(&t, &tm_buf);
+    if (std::strftime(out, SUMMARY_TIMESTAMP_SIZE, "%Y-%m-%d %H:%M:%S", &tm_buf) == 0) out[0] = '\0';
+}
+
+std::string format_summary_timestamp(double epoch_seconds) {
+    char buf[SUMMARY_TIMESTAMP_SIZE];
+    format_summary_timestamp(epoch_seconds, buf);
+    return buf;
+}
+
+void write_summary_header(std::ostream& out) {
+    for (size_t i = 0; i < summary_headers.size(); ++i) {
+        out << summary_headers[i];
+        if (i != summary_headers.size() - 1) out << ",";
+    }
+    out << "\n";
+}
+
+void write_summary_row(std::ostream& out, const char* timestamp, const SummaryRow& row) {
+    out << timestamp;
+    for (int c = COL_TIMESTAMP + 1; c < SUMMARY_COLUMN_COUNT; ++c) out << ',' << row[c];
+    out << '\n';
+}
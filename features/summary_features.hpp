@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <array>
+#include <bitset>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../include/shared_structs.hpp"
+
+// 연속된 샘플 구간 (C++17이라 std::span 대신 사용, 소유권 없음)
+template <typename T>
+struct SampleSpan {
+    const T* ptr = nullptr;
+    size_t count = 0;
+
+    SampleSpan() = default;
+    SampleSpan(const T* p, size_t n) : ptr(p), count(n) {}
+    SampleSpan(const std::vector<T>& v) : ptr(v.data()), count(v.size()) {}
+
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T& operator[](size_t i) const { return ptr[i]; }
+    const T& front() const { return ptr[0]; }
+    const T& back() const { return ptr[count - 1]; }
+};
+
+// summary 에 쓰는 blendshape 컬럼 (FaceData::blendshapes 의 SUMMARY_BLENDSHAPE_FIRST 번부터 순서대로)
+constexpr int SUMMARY_BLENDSHAPE_FIRST = 1;
+constexpr int SUMMARY_BLENDSHAPE_COUNT = BLENDSHAPE_COUNT - SUMMARY_BLENDSHAPE_FIRST;
+
+// summary_log.csv 컬럼 번호 (summary_headers 순서). 이름은 summary_features.cpp 의 표에서
+enum SummaryColumn : int {
+    COL_TIMESTAMP = 0,
+    COL_MOTION_SICK, COL_DISCOMFORT, COL_ANXIETY,       // 토글 (toggle_columns 순서)
+    COL_SPEED, COL_GPS_SPEED, COL_TRAJECTORY,
+    COL_HEADING, COL_HEADING_RATE, COL_LONG_ACC, COL_LAT_ACC, COL_CURVATURE,
+    COL_ACC_RMS_X, COL_ACC_RMS_Y, COL_ACC_RMS_Z, COL_ROLL_RATE_RMS, COL_PITCH_RATE_RMS, COL_YAW_RATE_RMS,
+    COL_AW_RMS_X, COL_AW_RMS_Y, COL_AW_RMS_Z, COL_MSDV_X, COL_MSDV_Y, COL_MSDV_Z,
+    COL_CAN_SPEED, COL_STEER_ANGLE_RMS, COL_STEER_RATE_RMS, COL_ACCEL_PEDAL_MEAN,
+    COL_BRAKE_PRESSURE_MEAN, COL_BRAKE_PRESSURE_MAX,
+    COL_PSD_FIRST,                                                  // 밴드마다 x, y, z (spectrum_column)
+    COL_FACE_FIRST = COL_PSD_FIRST + MOTION_SPECTRUM_BANDS * 3,     // 카메라마다 FACE_COLUMN_COUNT 개 (face_column)
+};
+
+// 카메라 하나의 얼굴 컬럼 (face_feature_keys 순서), 뒤에 blendshape 평균 SUMMARY_BLENDSHAPE_COUNT 개
+enum FaceColumn : int {
+    FACE_HR, FACE_HR_SNR, FACE_HR_METHOD, FACE_R, FACE_G, FACE_B, FACE_HEAD_TV, FACE_HEAD_RV,
+    FACE_HEAD_TV_RMS, FACE_HEAD_TV_PEAK,
+    FACE_HEAD_PITCH_RATE_RMS, FACE_HEAD_YAW_RATE_RMS, FACE_HEAD_ROLL_RATE_RMS,
+    FACE_HEAD_PITCH_RATE_PEAK, FACE_HEAD_YAW_RATE_PEAK, FACE_HEAD_ROLL_RATE_PEAK,
+    FACE_HEAD_ANG_ACC_RMS, FACE_HEAD_ANG_ACC_PEAK,
+    FACE_BLENDSHAPE_FIRST,
+};
+constexpr int FACE_COLUMN_COUNT = FACE_BLENDSHAPE_FIRST + SUMMARY_BLENDSHAPE_COUNT;
+constexpr int SUMMARY_COLUMN_COUNT = COL_FACE_FIRST + MAX_FACE_SOURCES * FACE_COLUMN_COUNT;
+
+constexpr int face_column(int source, int column) { return COL_FACE_FIRST + source * FACE_COLUMN_COUNT + column; }
+constexpr int spectrum_column(int band, int axis) { return COL_PSD_FIRST + band * 3 + axis; }
+
+// 1초 summary 한 줄. 값은 컬럼 번호로 찾는 고정 배열이라 만들고 합치는 동안 할당이 없다 (기본값 0)
+class SummaryRow {
+public:
+    double operator[](int column) const { return values_[column]; }
+    void set(int column, double value) {
+        values_[column] = value;
+        written_.set(column);
+    }
+    bool empty() const { return written_.none(); }
+    void clear() {
+        values_.fill(0.0);
+        written_.reset();
+    }
+    // other 에서 set 된 컬럼만 덮어쓴다 (작업별 행 → tick 행)
+    void merge(const SummaryRow& other) {
+        for (int c = 0; c < SUMMARY_COLUMN_COUNT; ++c) {
+            if (other.written_[c]) set(c, other.values_[c]);
+        }
+    }
+
+private:
+    std::array<double, SUMMARY_COLUMN_COUNT> values_{};
+    std::bitset<SUMMARY_COLUMN_COUNT> written_;
+};
+
+extern const std::vector<std::string> blend_shape_keys;
+extern const std::vector<std::string> summary_headers;   // SUMMARY_COLUMN_COUNT 개
+
+// compute_face_features 가 쓰는 컬럼 (prefix 없는 이름, FaceColumn 순서)
+extern const std::vector<std::string> face_feature_keys;
+
+// source 0(운전자)은 기존 컬럼명 그대로, 나머지는 "passenger_hr" 처럼 이름을 앞에 붙인다
+std::string face_column_prefix(int source_id);
+
+// face 특징은 버퍼에 이 개수 이상 쌓였을 때만 계산
+constexpr size_t FACE_MIN_SAMPLES_FOR_FEATURES = 100;
+
+// 이 스레드의 compute_*_features 임시 버퍼를 구간 최대 샘플 수만큼 미리 잡는다.
+// summary 풀 워커가 시작할 때 부르면 워밍업 뒤에 처음 작업을 받은 워커도 할당하지 않는다
+void reserve_feature_scratch(size_t max_samples);
+
+// face 구간 → r, g, b, hr(필터 전 원시값), head_tv, head_rv, blendshape 평균
+// 카메라 source 의 컬럼에 쓴다 (face_column)
+void compute_face_features(SampleSpan<FaceData> faces, SummaryRow& row, int source = 0);
+
+// IMU 구간 → acc_rms_*, *_rate_rms
+void compute_imu_features(SampleSpan<ImuData> imu, SummaryRow& row);
+
+// GPS 구간 → gps_speed (fix 평균), trajectory, 마지막 fix 의 heading / 가속도 / 곡률
+void compute_gps_features(SampleSpan<GpsData> gps, SummaryRow& row);
+
+// CAN 구간 → can_speed, steer_angle_rms, steer_rate_rms, accel_pedal_mean, brake_pressure_mean / max
+// 신호마다 받은 샘플 (NaN 이 아닌 것) 만, 하나도 없으면 그 컬럼은 기본값
+void compute_can_features(SampleSpan<CanData> can, SummaryRow& row);
+
+// 이보다 SNR 이 낮은 HR 추정치는 버린다 (백색 잡음만 있으면 약 -7 dB)
+constexpr double HR_MIN_SNR_DB = -3.0;
+
+// 최근 HR 추정치 30개에 대해 mean ± std 범위 밖 값을 버리고 평균
+class HeartRateSmoother {
+public:
+    static constexpr size_t HISTORY = 30;
+
+    // 유효 범위(30~180 bpm) 밖이거나 SNR 이 낮으면 히스토리를 건드리지 않고 0.0 반환
+    double update(double hr, double snr_db);
+    void reset() { count_ = 0; }
+
+private:
+    std::array<double, HISTORY> history_{};   // 링 버퍼, history_[next_] 가 가장 오래된 값 (가득 찼을 때)
+    size_t next_ = 0;
+    size_t count_ = 0;
+};
+
+// 토글 버튼 순서대로의 summary 컬럼명 (ToggleEvent::button 인덱스)
+extern const std::array<std::string, 3> toggle_columns;
+
+// 토글 이벤트 → 1초 tick 라벨. 구간 동안 한 번이라도 ON 이었으면 1 (tick 사이에 눌렀다 뗀 것도 남는다)
+class ToggleLabeler {
+public:
+    // 이전 tick 이후의 이벤트 (시간순) 를 반영해서 row 의 토글 컬럼을 채운다
+    void apply(SampleSpan<ToggleEvent> events, SummaryRow& row);
+    // 라벨 없이 상태만 따라간다 (첫 tick 이전 이벤트)
+    void advance(SampleSpan<ToggleEvent> events);
+
+private:
+    std::array<int, 3> state_{};
+};
+
+// "2025-06-24 13:01:32" (localtime)
+std::string format_summary_timestamp(double epoch_seconds);
+// 할당 없는 버전 (summary tick). out 은 SUMMARY_TIMESTAMP_SIZE 이상
+constexpr size_t SUMMARY_TIMESTAMP_SIZE = 32;
+void format_summary_timestamp(double epoch_seconds, char* out);
+
+void write_summary_header(std::ostream& out);
+void write_summary_row(std::ostream& out, const char* timestamp, const SummaryRow& row);
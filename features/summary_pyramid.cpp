@@ -0,0 +1,276 @@
+#include "summary_pyramid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <utility>
+
+#include "summary_features.hpp"
+
+namespace {
+    // 음수에서도 내림 (epoch 이전 시각은 없지만 인덱스 계산을 일관되게)
+    int64_t floor_div(int64_t a, int64_t b) {
+        int64_t q = a / b;
+        return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+    }
+
+    int64_t floor_mod(int64_t a, int64_t b) {
+        return a - floor_div(a, b) * b;
+    }
+
+    int64_t to_ms(double seconds) {
+        return static_cast<int64_t>(std::floor(seconds * 1000.0));
+    }
+
+    int64_t period_to_ms(double seconds) {
+        return static_cast<int64_t>(std::llround(seconds * 1000.0));
+    }
+
+    constexpr size_t IMU_COLUMN = 0;     // acc xyz, rate xyz, aw xyz
+    constexpr size_t FUSION_COLUMN = 9;  // speed, long_acc, lat_acc (GPS + IMU 융합, IMU 주기)
+    constexpr size_t GPS_COLUMN = 12;    // gps_speed
+    constexpr size_t CAN_COLUMN = 13;    // can_speed, steer_angle, steer_rate, accel_pedal, brake_pressure
+    constexpr size_t FACE_COLUMN = 18;   // 카메라마다 r, g, b, blendshapes
+
+    size_t face_stride() { return 3 + blend_shape_keys.size(); }
+}
+
+double PyramidStats::stddev() const {
+    if (count == 0) return 0.0;
+    double m = sum / count;
+    double var = sum_sq / count - m * m;
+    return var > 0.0 ? std::sqrt(var) : 0.0;
+}
+
+SummaryPyramid::SummaryPyramid(size_t column_count, const std::vector<double>& periods_sec, Sink sink, double window_sec)
+    : column_count_(column_count), sink_(std::move(sink)) {
+    for (double p : periods_sec) period_ms_.push_back(period_to_ms(p));
+    upper_.resize(period_ms_.size());
+    for (auto& open : upper_) open.columns.resize(column_count_);
+
+    // 창 길이만큼 버킷 + 경계에 걸친 하나
+    const int64_t window_ms = std::max<int64_t>(period_to_ms(window_sec), period_ms_.empty() ? 1 : period_ms_[0]);
+    const size_t slots = period_ms_.empty() ? 1 : static_cast<size_t>((window_ms + period_ms_[0] - 1) / period_ms_[0]) + 1;
+    base_.resize(slots);
+    for (auto& open : base_) open.columns.resize(column_count_);
+}
+
+bool SummaryPyramid::valid_periods(const std::vector<double>& periods_sec, std::string* error) {
+    auto fail = [error](const std::string& why) {
+        if (error) *error = why;
+        return false;
+    };
+    if (periods_sec.empty()) return fail("no levels");
+    int64_t prev = 0;
+    for (double p : periods_sec) {
+        int64_t ms = period_to_ms(p);
+        if (!(p > 0.0) || ms < 1 || std::fabs(p * 1000.0 - ms) > 1e-6) return fail("period must be a whole number of ms");
+        if (prev > 0 && (ms <= prev || ms % prev != 0)) return fail("each period must be a multiple of the previous one");
+        prev = ms;
+    }
+    return true;
+}
+
+void SummaryPyramid::add(double timestamp, size_t column, double value) {
+    if (column >= column_count_ || !std::isfinite(value)) return;
+    int64_t index = floor_div(to_ms(timestamp), period_ms_[0]);
+    const int64_t slots = static_cast<int64_t>(base_.size());
+    // 첫 advance 전에는 창이 열린 버킷을 따라 움직인다 (먼저 들어온 센서보다 오래된 샘플도 받도록)
+    if (closed_until_ == NOT_STARTED) {
+        closed_until_ = newest_ = index;
+    } else if (!advanced_ && index < closed_until_ && newest_ - index < slots) {
+        closed_until_ = index;
+    }
+    if (index < closed_until_ || index - closed_until_ >= slots) {
+        ++dropped_;
+        return;
+    }
+    Open& open = base_[static_cast<size_t>(floor_mod(index, slots))];
+    if (!open.active) {
+        open.active = true;
+        open.index = index;
+        std::fill(open.columns.begin(), open.columns.end(), PyramidStats{});
+    }
+    open.columns[column].add(value);
+    if (index > newest_) newest_ = index;
+}
+
+void SummaryPyramid::advance(double watermark) {
+    const int64_t wm = to_ms(watermark);
+    const int64_t base_end = floor_div(wm, period_ms_[0]);   // 이보다 작은 인덱스는 끝난 버킷
+
+    if (closed_until_ == NOT_STARTED || base_end > closed_until_) {
+        close_base_until(base_end);
+        closed_until_ = base_end;
+    }
+    advanced_ = true;
+
+    // 데이터가 끊겨도 위 레벨이 다음 샘플까지 열려있지 않게 (아래 레벨부터 닫아야 위로 합쳐진다)
+    for (size_t level = 1; level < upper_.size(); ++level) {
+        const Open& open = upper_[level];
+        if (open.active && (open.index + 1) * period_ms_[level] <= wm) close_upper(level);
+    }
+}
+
+void SummaryPyramid::flush() {
+    if (closed_until_ == NOT_STARTED) return;
+    const int64_t end = closed_until_ + static_cast<int64_t>(base_.size());
+    close_base_until(end);
+    closed_until_ = end;
+    for (size_t level = 1; level < upper_.size(); ++level) {
+        if (upper_[level].active) close_upper(level);
+    }
+}
+
+void SummaryPyramid::close_base_until(int64_t until) {
+    if (closed_until_ == NOT_STARTED) return;   // 아직 연 버킷 없음
+    // 열린 버킷은 [closed_until_, closed_until_ + 링 크기) 안에만 있다
+    const int64_t slots = static_cast<int64_t>(base_.size());
+    const int64_t end = std::min(until, closed_until_ + slots);
+    for (int64_t index = closed_until_; index < end; ++index) {
+        Open& open = base_[static_cast<size_t>(floor_mod(index, slots))];
+        if (open.active && open.index == index) close_base(open);
+    }
+}
+
+void SummaryPyramid::close_base(Open& open) {
+    open.active = false;
+    const int64_t start_ms = open.index * period_ms_[0];
+    sink_(0, start_ms / 1000.0, open.columns);
+    merge_up(1, start_ms, open.columns);
+}
+
+void SummaryPyramid::merge_up(size_t level, int64_t child_start_ms, const std::vector<PyramidStats>& columns) {
+    if (level >= upper_.size()) return;
+
+    Open& open = upper_[level];
+    int64_t index = floor_div(child_start_ms, period_ms_[level]);
+    if (open.active && open.index != index) close_upper(level);
+    if (!open.active) {
+        open.active = true;
+        open.index = index;
+        std::fill(open.columns.begin(), open.columns.end(), PyramidStats{});
+    }
+    for (size_t c = 0; c < column_count_; ++c) open.columns[c].merge(columns[c]);
+}
+
+void SummaryPyramid::close_upper(size_t level) {
+    Open& open = upper_[level];
+    open.active = false;
+    const int64_t start_ms = open.index * period_ms_[level];
+    sink_(level, start_ms / 1000.0, open.columns);
+    merge_up(level + 1, start_ms, open.columns);
+}
+
+const std::vector<std::string>& pyramid_columns() {
+    // blend_shape_keys 는 다른 TU 의 전역이라 처음 쓸 때 만든다 (정적 초기화 순서)
+    static const std::vector<std::string> columns = [] {
+        std::vector<std::string> c = {
+            "acc_x", "acc_y", "acc_z", "roll_rate", "pitch_rate", "yaw_rate",
+            "aw_x", "aw_y", "aw_z",
+            "speed", "long_acc", "lat_acc",
+            "gps_speed",
+            "can_speed", "steer_angle", "steer_rate", "accel_pedal", "brake_pressure"
+        };
+        for (int source = 0; source < MAX_FACE_SOURCES; ++source) {
+            std::string prefix = face_column_prefix(source);
+            for (const char* key : {"r", "g", "b"}) c.push_back(prefix + key);
+            for (const auto& key : blend_shape_keys) c.push_back(prefix + key);
+        }
+        return c;
+    }();
+    return columns;
+}
+
+void pyramid_add(SummaryPyramid& pyramid, const ImuData& imu) {
+    for (size_t i = 0; i < 3; ++i) {
+        pyramid.add(imu.source_timestamp, IMU_COLUMN + i, imu.accel[i]);
+        pyramid.add(imu.source_timestamp, IMU_COLUMN + 3 + i, imu.gyro[i]);
+        pyramid.add(imu.source_timestamp, IMU_COLUMN + 6 + i, imu.accel_wf[i]);
+    }
+    if (imu.fused_valid) {
+        pyramid.add(imu.source_timestamp, FUSION_COLUMN, imu.fused_speed);
+        pyramid.add(imu.source_timestamp, FUSION_COLUMN + 1, imu.fused_long_acc);
+        pyramid.add(imu.source_timestamp, FUSION_COLUMN + 2, imu.fused_lat_acc);
+    }
+}
+
+void pyramid_add(SummaryPyramid& pyramid, const GpsData& gps) {
+    pyramid.add(gps.source_timestamp, GPS_COLUMN, gps.speed);
+}
+
+void pyramid_add(SummaryPyramid& pyramid, const CanData& can) {
+    const float values[] = {can.speed, can.steer_angle, can.steer_rate, can.accel_pedal, can.brake_pressure};
+    for (size_t i = 0; i < 5; ++i) {
+        if (!std::isnan(values[i])) pyramid.add(can.source_timestamp, CAN_COLUMN + i, values[i]);
+    }
+}
+
+void pyramid_add(SummaryPyramid& pyramid, const FaceData& face) {
+    if (face.source_id < 0 || face.source_id >= MAX_FACE_SOURCES) return;
+    const size_t base = FACE_COLUMN + face.source_id * face_stride();
+
+    if (face.has_rgb) {
+        for (size_t i = 0; i < 3; ++i) pyramid.add(face.source_timestamp, base + i, face.avg_rgb[i]);
+    }
+    for (size_t k = 0; k < blend_shape_keys.size(); ++k) {
+        float value = face.blendshapes[k + SUMMARY_BLENDSHAPE_FIRST];
+        if (!std::isnan(value)) pyramid.add(face.source_timestamp, base + 3 + k, value);
+    }
+}
+
+const std::vector<double> default_pyramid_periods = {0.1, 1.0, 10.0, 60.0};
+
+bool parse_pyramid_periods(const std::string& text, std::vector<double>& periods, std::string* error) {
+    std::vector<double> parsed;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        char* end = nullptr;
+        double p = std::strtod(item.c_str(), &end);
+        if (item.empty() || end == item.c_str() || *end != '\0') {
+            if (error) *error = "not a number: \"" + item + "\"";
+            return false;
+        }
+        parsed.push_back(p);
+    }
+    if (!SummaryPyramid::valid_periods(parsed, error)) return false;
+    periods = std::move(parsed);
+    return true;
+}
+
+void write_pyramid_header(std::ostream& out) {
+    out << "timestamp";
+    for (const auto& col : pyramid_columns()) {
+        out << "," << col << "_n," << col << "_mean," << col << "_std," << col << "_min," << col << "_max";
+    }
+    out << "\n";
+}
+
+void write_pyramid_row(std::ostream& out, double start, double period_sec, const std::vector<PyramidStats>& columns) {
+    char timestamp[SUMMARY_TIMESTAMP_SIZE];
+    format_summary_timestamp(start, timestamp);
+    out << timestamp;
+    if (period_to_ms(period_sec) % 1000 != 0) {
+        char ms[8];
+        std::snprintf(ms, sizeof(ms), ".%03d", static_cast<int>(to_ms(start) % 1000));
+        out << ms;
+    }
+    for (const auto& c : columns) {
+        if (c.count == 0) {
+            out << ",0,,,,";
+        } else {
+            out << "," << c.count << "," << c.mean() << "," << c.stddev() << "," << c.min << "," << c.max;
+        }
+    }
+    out << "\n";
+}
+
+std::string pyramid_level_label(double period_sec) {
+    int64_t ms = period_to_ms(period_sec);
+    if (ms % 60000 == 0) return std::to_string(ms / 60000) + "min";
+    if (ms % 1000 == 0) return std::to_string(ms / 1000) + "s";
+    return std::to_string(ms) + "ms";
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../include/shared_structs.hpp"
+
+// 합칠 수 있는 컬럼 통계. 두 구간의 PyramidStats 를 merge 하면 두 구간 샘플을 한 번에 add 한 것과 같다
+struct PyramidStats {
+    uint64_t count = 0;
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double v) {
+        ++count;
+        sum += v;
+        sum_sq += v * v;
+        if (v < min) min = v;
+        if (v > max) max = v;
+    }
+
+    void merge(const PyramidStats& other) {
+        count += other.count;
+        sum += other.sum;
+        sum_sq += other.sum_sq;
+        if (other.min < min) min = other.min;
+        if (other.max > max) max = other.max;
+    }
+
+    double mean() const { return count ? sum / count : 0.0; }
+    double stddev() const;   // 모표준편차
+};
+
+// 다중 해상도 요약 (예: 0.1초 / 1초 / 10초 / 1분).
+// - 샘플은 가장 짧은 주기의 버킷에만 들어가고, 위 레벨은 아래 레벨의 닫힌 버킷을 합쳐서 만든다 (샘플 재스캔 없음)
+// - 주기는 ms 단위로 앞 레벨의 정수배여야 하고, 버킷 경계는 epoch 기준으로 정렬된다
+// - 센서마다 도착 지연이 달라서 가장 짧은 버킷은 advance(watermark) 가 지나갈 때 닫는다
+// - 열린 가장 짧은 버킷은 닫힌 위치부터 window_sec 만큼의 고정 링 (생성할 때 다 잡아 둠 → add / advance 는 할당 없음)
+// - 샘플이 하나도 없던 버킷은 내보내지 않는다
+class SummaryPyramid {
+public:
+    // 닫힌 버킷 하나 (level: periods 인덱스, start: 버킷 시작 epoch 초, columns: 컬럼별 통계)
+    using Sink = std::function<void(size_t level, double start, const std::vector<PyramidStats>& columns)>;
+
+    // window_sec: 마지막 watermark 뒤로 열어 둘 수 있는 구간 (도착 지연 + tick 간격보다 길게)
+    SummaryPyramid(size_t column_count, const std::vector<double>& periods_sec, Sink sink, double window_sec = 8.0);
+
+    // 주기 목록 검사 (비어있지 않고, 1ms 이상, 오름차순 정수배). 틀리면 error 에 이유
+    static bool valid_periods(const std::vector<double>& periods_sec, std::string* error = nullptr);
+
+    // 이미 닫힌 버킷이나 열린 창보다 앞선 버킷의 샘플은 버린다 (dropped).
+    // 첫 advance 전에는 그때까지 받은 가장 오래된 샘플이 창의 시작
+    void add(double timestamp, size_t column, double value);
+
+    // watermark (epoch 초) 이전에 끝나는 버킷을 모든 레벨에서 닫는다
+    void advance(double watermark);
+
+    // 열린 버킷을 전부 닫는다 (종료 시)
+    void flush();
+
+    size_t levels() const { return period_ms_.size(); }
+    double period(size_t level) const { return period_ms_[level] / 1000.0; }
+    uint64_t dropped() const { return dropped_; }
+
+private:
+    struct Open {
+        bool active = false;
+        int64_t index = 0;
+        std::vector<PyramidStats> columns;
+    };
+
+    static constexpr int64_t NOT_STARTED = std::numeric_limits<int64_t>::min();
+
+    // base 인덱스 [closed_until_, until) 중 열린 버킷을 순서대로 닫는다
+    void close_base_until(int64_t until);
+    void close_base(Open& open);
+    void merge_up(size_t level, int64_t child_start_ms, const std::vector<PyramidStats>& columns);
+    void close_upper(size_t level);
+
+    size_t column_count_;
+    std::vector<int64_t> period_ms_;
+    Sink sink_;
+
+    std::vector<Open> base_;    // 열린 가장 짧은 버킷 링 (인덱스 % 크기), [closed_until_, closed_until_ + 크기) 만
+    std::vector<Open> upper_;   // level 1.. 레벨마다 열린 버킷 하나
+    int64_t closed_until_ = NOT_STARTED;   // 이보다 작은 base 인덱스는 닫힘
+    int64_t newest_ = NOT_STARTED;         // 받은 가장 늦은 base 인덱스
+    bool advanced_ = false;
+    uint64_t dropped_ = 0;
+};
+
+// 라이브 로거가 피라미드에 넣는 샘플 채널 (컬럼 순서).
+// IMU 원시값 / Wf 가중 가속도, 융합 속도 / 종·횡가속도, GPS 속도, 카메라별 평균 RGB 와 blendshape (운전자 외에는 face_column_prefix)
+const std::vector<std::string>& pyramid_columns();
+
+void pyramid_add(SummaryPyramid& pyramid, const ImuData& imu);
+void pyramid_add(SummaryPyramid& pyramid, const GpsData& gps);
+void pyramid_add(SummaryPyramid& pyramid, const CanData& can);   // NaN 신호는 건너뜀
+void pyramid_add(SummaryPyramid& pyramid, const FaceData& face);
+
+// 기본 레벨: 10Hz / 1Hz / 10초 / 1분
+extern const std::vector<double> default_pyramid_periods;
+
+// "0.1,1,10,60" → {0.1, 1, 10, 60}. 숫자가 아니거나 valid_periods 를 통과 못하면 false
+bool parse_pyramid_periods(const std::string& text, std::vector<double>& periods, std::string* error = nullptr);
+
+// 레벨 CSV: timestamp(버킷 시작, 1초 미만 주기는 ms 까지), 컬럼마다 _n, _mean, _std, _min, _max.
+// 샘플이 없던 컬럼은 n=0 이고 나머지는 빈 칸
+void write_pyramid_header(std::ostream& out);
+void write_pyramid_row(std::ostream& out, double start, double period_sec, const std::vector<PyramidStats>& columns);
+
+// 파일명 / 로그용 레벨 이름: "100ms", "1s", "10s", "1min"
+std::string pyramid_level_label(double period_sec);
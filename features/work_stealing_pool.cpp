@@ -0,0 +1,129 @@
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+    // 현재 스레드가 속한 풀과 워커 번호 (풀 밖의 스레드는 nullptr)
+    thread_local const WorkStealingPool* tl_pool = nullptr;
+    thread_local size_t tl_index = 0;
+}
+
+void WorkStealingPool::TaskRing::push_back(Task&& task) {
+    if (size_ == slots_.size()) {
+        // 가득 차면 두 배로 (순서대로 옮겨서 head_ = 0)
+        std::vector<Task> grown(std::max<size_t>(16, slots_.size() * 2));
+        for (size_t i = 0; i < size_; ++i) grown[i] = std::move(slots_[(head_ + i) % slots_.size()]);
+        slots_.swap(grown);
+        head_ = 0;
+    }
+    slots_[(head_ + size_) % slots_.size()] = std::move(task);
+    ++size_;
+}
+
+WorkStealingPool::Task WorkStealingPool::TaskRing::pop_back() {
+    Task& slot = slots_[(head_ + size_ - 1) % slots_.size()];
+    Task task = std::move(slot);
+    slot = nullptr;   // 캡처한 것 (shared_ptr 등) 을 바로 놓는다
+    --size_;
+    return task;
+}
+
+WorkStealingPool::Task WorkStealingPool::TaskRing::pop_front() {
+    Task& slot = slots_[head_];
+    Task task = std::move(slot);
+    slot = nullptr;
+    head_ = (head_ + 1) % slots_.size();
+    --size_;
+    return task;
+}
+
+WorkStealingPool::WorkStealingPool(size_t num_threads, Task on_thread_start)
+    : on_thread_start_(std::move(on_thread_start)) {
+    if (num_threads == 0) num_threads = 1;
+
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < num_threads; ++i) {
+        threads_.emplace_back(&WorkStealingPool::worker_loop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stop_ = true;
+    }
+    wake_cv_.notify_all();
+    for (auto& t : threads_) t.join();
+}
+
+void WorkStealingPool::submit(Task task) {
+    // 워커 안에서 제출하면 자기 deque, 밖에서면 라운드로빈
+    size_t index = (tl_pool == this)
+        ? tl_index
+        : next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+
+    pending_.fetch_add(1);
+    queued_.fetch_add(1);  // pop 보다 먼저 올려야 음수로 내려가지 않음
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->tasks.push_back(std::move(task));
+    }
+
+    // wake_mutex_ 를 잡고 깨워야 대기 조건 검사와의 경쟁에서 신호를 잃지 않음
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    wake_cv_.notify_one();
+}
+
+void WorkStealingPool::wait_idle() {
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    idle_cv_.wait(lock, [this]() { return pending_.load() == 0; });
+}
+
+bool WorkStealingPool::pop_local(size_t index, Task& task) {
+    Worker& w = *workers_[index];
+    std::lock_guard<std::mutex> lock(w.mutex);
+    if (w.tasks.empty()) return false;
+    task = w.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t thief, Task& task) {
+    const size_t n = workers_.size();
+    for (size_t k = 1; k < n; ++k) {
+        Worker& victim = *workers_[(thief + k) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+        task = victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::worker_loop(size_t index) {
+    tl_pool = this;
+    tl_index = index;
+    if (on_thread_start_) on_thread_start_();
+
+    while (true) {
+        Task task;
+        if (pop_local(index, task) || steal(index, task)) {
+            queued_.fetch_sub(1);
+            task();
+
+            if (pending_.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+                idle_cv_.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait(lock, [this]() { return stop_.load() || queued_.load() > 0; });
+        if (stop_ && queued_.load() == 0) break;
+    }
+
+    tl_pool = nullptr;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 워커마다 자기 deque 를 갖는 work-stealing 스레드 풀.
+// - 워커 안에서 submit 하면 자기 deque 뒤에 넣고, 자기 것은 뒤에서(LIFO) 꺼낸다.
+// - 할 일이 없으면 다른 워커 deque 의 앞에서(FIFO) 훔쳐온다.
+// - deque 는 늘어나기만 하는 링이라 작업 수가 한 번 찍은 최대를 넘지 않으면 submit 이 할당하지 않는다
+//   (작업 자체도 포인터 두 개 크기 이하면 std::function 안에 들어감 → summary tick 이 할당 없이 제출)
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    // on_thread_start: 워커마다 시작할 때 한 번 (스레드 이름, thread_local 버퍼 미리 잡기 등)
+    explicit WorkStealingPool(size_t num_threads = std::thread::hardware_concurrency(), Task on_thread_start = nullptr);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(Task task);
+
+    // 제출된 모든 작업(작업 안에서 다시 제출된 것 포함)이 끝날 때까지 대기
+    void wait_idle();
+
+    size_t size() const { return workers_.size(); }
+
+private:
+    // 양쪽에서 꺼내는 작업 링 (std::deque 는 블록 경계를 지날 때마다 블록을 할당 / 해제)
+    class TaskRing {
+    public:
+        bool empty() const { return size_ == 0; }
+        void push_back(Task&& task);
+        Task pop_back();
+        Task pop_front();
+
+    private:
+        std::vector<Task> slots_;
+        size_t head_ = 0;   // 맨 앞 작업 위치
+        size_t size_ = 0;
+    };
+
+    struct Worker {
+        TaskRing tasks;
+        std::mutex mutex;
+    };
+
+    void worker_loop(size_t index);
+    bool pop_local(size_t index, Task& task);
+    bool steal(size_t thief, Task& task);
+
+    Task on_thread_start_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<size_t> queued_{0};    // deque 에 들어있는 작업 수
+    std::atomic<size_t> pending_{0};   // 아직 끝나지 않은 작업 수
+    std::atomic<size_t> next_worker_{0};
+    std::atomic<bool> stop_{false};
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable idle_cv_;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// 장시간 세션에서 힙이 조각나지 않도록 센서 / DB 루프는 워밍업 뒤에 할당하지 않아야 한다. 그걸 확인하는 빌드.
+// - 빌드 옵션 MOTIONSICK_ALLOC_CHECK (MOTIONSICK_ALLOC_CHECK=1): 전역 operator new 를 바꿔서 스레드별로 센다
+// - SteadyStateLoop 하나 = 루프 하나. 한 바퀴를 Iteration 으로 감싸면 그 안에서 이 스레드가 한 할당 수를 본다
+// - warmup 바퀴가 지난 뒤에 할당하면 "[Alloc] ..." 을 찍고 abort (fatal=false 면 세기만 함)
+// - 꺼진 빌드에서는 둘 다 빈 클래스
+//
+//   static SteadyStateLoop steady("imu.sample");
+//   SteadyStateLoop::Iteration iteration(steady);
+
+#ifndef MOTIONSICK_ALLOC_CHECK
+#define MOTIONSICK_ALLOC_CHECK 0
+#endif
+
+#if MOTIONSICK_ALLOC_CHECK
+
+// 이 스레드가 지금까지 한 operator new 횟수
+uint64_t alloc_count_this_thread();
+
+class SteadyStateLoop {
+public:
+    // name 은 문자열 상수. 프로그램 끝까지 살아 있어야 한다 (보통 함수 안 static)
+    explicit SteadyStateLoop(const char* name, uint64_t warmup_iterations = 100, bool fatal = true);
+
+    class Iteration {
+    public:
+        explicit Iteration(SteadyStateLoop& loop) : loop_(loop), start_(alloc_count_this_thread()) {}
+        ~Iteration() { loop_.finish(alloc_count_this_thread() - start_); }
+
+        Iteration(const Iteration&) = delete;
+        Iteration& operator=(const Iteration&) = delete;
+
+    private:
+        SteadyStateLoop& loop_;
+        uint64_t start_;
+    };
+
+private:
+    friend void alloc_check_report();
+    void finish(uint64_t allocations);
+
+    const char* name_;
+    uint64_t warmup_;
+    bool fatal_;
+    std::atomic<uint64_t> iterations_{0};
+    std::atomic<uint64_t> steady_allocations_{0};   // 워밍업 뒤
+    SteadyStateLoop* next_ = nullptr;               // 보고용 목록
+};
+
+// 루프별 바퀴 수 / 워밍업 뒤 할당 수 (종료할 때)
+void alloc_check_report();
+
+#else
+
+class SteadyStateLoop {
+public:
+    constexpr explicit SteadyStateLoop(const char*, uint64_t = 100, bool = true) {}
+
+    class Iteration {
+    public:
+        constexpr explicit Iteration(SteadyStateLoop&) {}
+    };
+};
+
+inline void alloc_check_report() {}
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ring_read.hpp"
+
+// summary tick(쓰기 스레드 1개) → UI 타이머(읽기 1개) 로 넘기는 고정 크기 기록. 락 없음.
+// 쓰기 쪽은 오래된 값을 덮어쓰기만 하고 읽기 쪽을 기다리지 않는다.
+template <size_t N>
+class PlotHistory {
+public:
+    static constexpr size_t capacity = N;
+
+    void push(float v) {
+        uint64_t seq = written_.load(std::memory_order_relaxed);
+        values_[seq % N].store(v, std::memory_order_relaxed);
+        written_.store(seq + 1, std::memory_order_release);
+    }
+
+    uint64_t written() const { return written_.load(std::memory_order_acquire); }
+
+    // since 이후에 들어온 값을 out 뒤에 붙이고 새 위치를 반환 (N 개보다 많이 밀렸으면 최근 N 개만)
+    uint64_t read_since(uint64_t since, std::vector<float>& out) const {
+        return ring_read_since<N>(written_, since, out, [this](uint64_t s) {
+            return values_[s % N].load(std::memory_order_relaxed);
+        });
+    }
+
+private:
+    std::array<std::atomic<float>, N> values_{};
+    std::atomic<uint64_t> written_{0};
+};
+
+// 화면 sparkline 용 1초 summary 값 (30분)
+constexpr size_t PLOT_HISTORY_SIZE = 30 * 60;
+
+struct PlotFeed {
+    PlotHistory<PLOT_HISTORY_SIZE> hr;        // bpm (필터 후, 0 = 추정 실패)
+    PlotHistory<PLOT_HISTORY_SIZE> acc_rms;   // m/s², |(acc_rms_x, y, z)|
+    PlotHistory<PLOT_HISTORY_SIZE> speed;     // km/h
+};
+
+extern PlotFeed plot_feed;
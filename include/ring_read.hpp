@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 쓰기 1개 / 읽기 여러 개인 고정 크기 링(ToggleEventLog, PlotHistory)의 공통 읽기.
+// 쓰기 쪽: slot[seq % N] 을 채운 뒤 written = seq + 1 (release).
+// 읽기 쪽: since 이후 [begin, end) 를 load(seq) 로 out 뒤에 붙이고 end 를 반환한다.
+// N 개보다 밀렸으면 최근 N 개만 읽고, 읽는 동안 덮어쓰였을 수 있는 앞부분은 버린다 (버린 개수는 lost 에 더함).
+template <size_t N, typename T, typename Load>
+uint64_t ring_read_since(const std::atomic<uint64_t>& written, uint64_t since, std::vector<T>& out, Load load,
+                         uint64_t* lost = nullptr) {
+    uint64_t end = written.load(std::memory_order_acquire);
+    uint64_t begin = (end - since > N) ? end - N : since;
+    size_t first = out.size();
+    for (uint64_t s = begin; s < end; ++s) out.push_back(load(s));
+
+    // slot 읽기가 아래 written 읽기보다 늦게 보이지 않도록
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t after = written.load(std::memory_order_relaxed);
+
+    // written == after 이면 쓰기 쪽이 seq after 를, 즉 slot(after - N) 을 쓰는 중일 수 있다
+    // → seq <= after - N 인 slot 은 덮어쓰였다고 본다
+    if (after + 1 > begin + N) {
+        uint64_t overwritten = after + 1 - (begin + N);
+        if (overwritten > end - begin) overwritten = end - begin;
+        out.erase(out.begin() + first, out.begin() + first + static_cast<size_t>(overwritten));
+        begin += overwritten;
+    }
+    if (lost) *lost += begin - since;
+    return end;
+}
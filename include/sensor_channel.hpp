@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "trace.hpp"
+
+// 센서 하나 = traits 구조체 하나. 버퍼 / 스냅샷 / DB 기록 / summary 작업은 traits 를 보고 컴파일 타임에 묶인다 (가상 호출 없음).
+//
+// traits 가 정하는 것 (SensorTraitsBase 를 상속하면 기본값이 있는 항목은 생략 가능):
+//   using Sample                 샘플 구조체 (source_timestamp, seq 필요)
+//   name                         로그 / 통계용 이름
+//   sources                      독립 스트림 수 (카메라별 얼굴처럼). 기본 1
+//   capacity                     source 별 버퍼 최대 샘플 수
+//   source_name(source)          작업 통계용 이름. 기본 name
+//   insert_span, db_span, summary_span   trace span 이름
+//   table, create_sql, insert_sql, migrate_sql   DB 스키마 (migrate_sql 은 실패해도 무시, 기본 없음)
+//   bind(stmt, sample, text)     insert_sql 에 bind (text: 문자열 컬럼용 재사용 버퍼)
+//   after_insert(db, inserted)   tick 에 새로 기록한 구간으로 추가 기록. 기본 없음
+//   compute_features(span, row, source)   1초 summary 컬럼
+//   add_to_pyramid(pyramid, sample)       요약 피라미드. 기본 없음
+
+class DatabaseLogger;
+class SummaryPyramid;
+template <typename T> struct SampleSpan;
+
+struct SensorTraitsBase {
+    static constexpr int sources = 1;
+    static constexpr const char* migrate_sql = nullptr;
+
+    template <typename Sample>
+    static void after_insert(DatabaseLogger&, SampleSpan<Sample>) {}
+    template <typename Sample>
+    static void add_to_pyramid(SummaryPyramid&, const Sample&) {}
+};
+
+// 타입만 넘길 때 (generic lambda 인자)
+template <typename Traits>
+struct SensorTag {
+    using traits = Traits;
+};
+
+// 채널 하나의 source 별 복사본. 처음부터 capacity + 1 만큼 잡혀 있어서 스냅샷을 덮어써도 할당하지 않는다
+template <typename Traits>
+struct SensorSnapshot {
+    using traits = Traits;
+    using Sample = typename Traits::Sample;
+
+    SensorSnapshot() {
+        for (auto& samples : source) samples.reserve(Traits::capacity + 1);
+    }
+
+    std::vector<Sample>& operator[](int i) { return source[i]; }
+    const std::vector<Sample>& operator[](int i) const { return source[i]; }
+
+    std::array<std::vector<Sample>, Traits::sources> source;
+};
+
+// source 별 최근 capacity 개 샘플 (센서 스레드가 push, DB / summary 가 snapshot)
+template <typename Traits>
+class SensorChannel {
+public:
+    using Sample = typename Traits::Sample;
+    using Snapshot = SensorSnapshot<Traits>;
+
+    // 시작할 때 최대 크기로 (push 후 erase 하므로 +1). 이후 push 마다 힙 할당 없음
+    SensorChannel() {
+        for (auto& samples : buffers_) samples.reserve(Traits::capacity + 1);
+    }
+
+    SensorChannel(const SensorChannel&) = delete;
+    SensorChannel& operator=(const SensorChannel&) = delete;
+
+    void push(const Sample& sample, int source = 0) {
+        TraceSpan span(Traits::insert_span, sample.seq);
+        std::lock_guard<std::mutex> lock(mutexes_[source]);
+        auto& samples = buffers_[source];
+        samples.push_back(sample);
+        if (samples.size() > Traits::capacity) {
+            samples.erase(samples.begin());  // 오래된 것 제거
+        }
+    }
+
+    void clear(int source = 0) {
+        std::lock_guard<std::mutex> lock(mutexes_[source]);
+        buffers_[source].clear();
+    }
+
+    // 가장 최근 샘플 하나만 (다른 센서 스레드에서 주기적으로 확인할 때). 비었으면 false
+    bool latest(Sample& out, int source = 0) const {
+        std::lock_guard<std::mutex> lock(mutexes_[source]);
+        if (buffers_[source].empty()) return false;
+        out = buffers_[source].back();
+        return true;
+    }
+
+    // source 마다 따로 잠그고 복사 (source 끼리는 같은 시점이 아닐 수 있음)
+    void snapshot(Snapshot& out) const {
+        for (int source = 0; source < Traits::sources; ++source) {
+            std::lock_guard<std::mutex> lock(mutexes_[source]);
+            out[source] = buffers_[source];
+        }
+    }
+
+private:
+    std::array<std::vector<Sample>, Traits::sources> buffers_;
+    mutable std::array<std::mutex, Traits::sources> mutexes_;
+};
+
+// 센서 목록. 채널 순서대로 source 를 이어 붙인 번호 (0 ~ source_count-1) 가 summary 작업 번호
+//   using Sensors = SensorRegistry<FaceSensor, ImuSensor, GpsSensor>;
+//   sensors.channel<ImuSensor>().push(data);
+//   Sensors::for_each(snapshots, [](auto& snapshot) { using T = typename std::decay_t<decltype(snapshot)>::traits; ... });
+template <typename... Traits>
+class SensorRegistry {
+public:
+    static constexpr size_t channel_count = sizeof...(Traits);
+    static constexpr int source_count = (Traits::sources + ...);
+    static constexpr size_t max_snapshot_size = std::max({(Traits::capacity + 1)...});   // source 하나 스냅샷의 최대 샘플 수
+
+    using Snapshots = std::tuple<SensorSnapshot<Traits>...>;
+
+    template <typename T>
+    SensorChannel<T>& channel() { return std::get<SensorChannel<T>>(channels_); }
+    template <typename T>
+    const SensorChannel<T>& channel() const { return std::get<SensorChannel<T>>(channels_); }
+
+    // 채널 순서 (DB statement 배열 인덱스 등)
+    template <typename T>
+    static constexpr size_t index_of() {
+        constexpr bool match[] = {std::is_same_v<T, Traits>...};
+        for (size_t i = 0; i < channel_count; ++i) {
+            if (match[i]) return i;
+        }
+        return channel_count;
+    }
+
+    // T 의 source 0 번의 전체 번호
+    template <typename T>
+    static constexpr int first_source() {
+        constexpr int sources[] = {Traits::sources...};
+        int offset = 0;
+        for (size_t i = 0; i < index_of<T>(); ++i) offset += sources[i];
+        return offset;
+    }
+
+    void snapshot(Snapshots& out) const {
+        (channel<Traits>().snapshot(std::get<SensorSnapshot<Traits>>(out)), ...);
+    }
+
+    // f(SensorTag<T>{}) 를 채널 순서대로
+    template <typename F>
+    static void for_each_sensor(F&& f) {
+        (f(SensorTag<Traits>{}), ...);
+    }
+
+    // f(SensorSnapshot<T>&) 를 채널 순서대로
+    template <typename F>
+    static void for_each(Snapshots& snapshots, F&& f) {
+        (f(std::get<SensorSnapshot<Traits>>(snapshots)), ...);
+    }
+    template <typename F>
+    static void for_each(const Snapshots& snapshots, F&& f) {
+        (f(std::get<SensorSnapshot<Traits>>(snapshots)), ...);
+    }
+
+    // 전체 source 번호 → f(SensorTag<T>{}, T 안에서의 source)
+    template <typename F>
+    static void with_source(int index, F&& f) {
+        int offset = 0;
+        auto visit = [&](auto tag) {
+            using T = typename decltype(tag)::traits;
+            if (index >= offset && index < offset + T::sources) f(tag, index - offset);
+            offset += T::sources;
+        };
+        (visit(SensorTag<Traits>{}), ...);
+    }
+
+private:
+    std::tuple<SensorChannel<Traits>...> channels_;
+};
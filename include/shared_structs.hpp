@@ -1,6 +1,9 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <vector>
 #include <array>
 #include <atomic>
@@ -9,25 +12,122 @@
 #include <mutex>
 #include <string>
 
+// 얼굴 스트림(카메라) 구분. 0 = 운전자 (기존 단일 카메라), 나머지는 summary 에서 컬럼 prefix 로 구분
+constexpr int MAX_FACE_SOURCES = 2;
+constexpr const char* FACE_SOURCE_NAMES[MAX_FACE_SOURCES] = {"driver", "passenger"};
+
+// MediaPipe face_blendshapes 카테고리 (모델 출력 순서) = FaceData::blendshapes 인덱스
+constexpr int BLENDSHAPE_COUNT = 52;
+constexpr const char* BLENDSHAPE_NAMES[BLENDSHAPE_COUNT] = {
+    "_neutral",
+    "browDownLeft", "browDownRight", "browInnerUp", "browOuterUpLeft", "browOuterUpRight",
+    "cheekPuff", "cheekSquintLeft", "cheekSquintRight", "eyeBlinkLeft", "eyeBlinkRight",
+    "eyeLookDownLeft", "eyeLookDownRight", "eyeLookInLeft", "eyeLookInRight",
+    "eyeLookOutLeft", "eyeLookOutRight", "eyeLookUpLeft", "eyeLookUpRight",
+    "eyeSquintLeft", "eyeSquintRight", "eyeWideLeft", "eyeWideRight",
+    "jawForward", "jawLeft", "jawOpen", "jawRight",
+    "mouthClose", "mouthDimpleLeft", "mouthDimpleRight", "mouthFrownLeft", "mouthFrownRight",
+    "mouthFunnel", "mouthLeft", "mouthLowerDownLeft", "mouthLowerDownRight",
+    "mouthPressLeft", "mouthPressRight", "mouthPucker", "mouthRight",
+    "mouthRollLower", "mouthRollUpper", "mouthShrugLower", "mouthShrugUpper",
+    "mouthSmileLeft", "mouthSmileRight", "mouthStretchLeft", "mouthStretchRight",
+    "mouthUpperUpLeft", "mouthUpperUpRight", "noseSneerLeft", "noseSneerRight"
+};
+
+// 이름 → BLENDSHAPE_NAMES 인덱스, 모르는 이름이면 -1
+inline int blendshape_index(const char* name, size_t len) {
+    for (int i = 0; i < BLENDSHAPE_COUNT; ++i) {
+        if (std::strlen(BLENDSHAPE_NAMES[i]) == len && std::memcmp(BLENDSHAPE_NAMES[i], name, len) == 0) return i;
+    }
+    return -1;
+}
+
+using BlendshapeArray = std::array<float, BLENDSHAPE_COUNT>;
+
+// 프레임에 없던 blendshape 는 NaN
+constexpr BlendshapeArray no_blendshapes() {
+    BlendshapeArray a{};
+    for (size_t i = 0; i < a.size(); ++i) a[i] = std::numeric_limits<float>::quiet_NaN();
+    return a;
+}
+
+// 샘플 구조체는 고정 크기 (힙 할당 없음) → 버퍼 / 스냅샷 복사가 memcpy 수준이고 장시간 세션에서 힙이 조각나지 않는다
 struct FaceData {
     double source_timestamp;
-    std::unordered_map<std::string, float> blendshapes;
-    std::vector<float> avg_rgb;             // size 3: [r, g, b]
-    std::vector<std::vector<float>> rotation_matrix; // 3x3 matrix
-    std::vector<float> translation_vector;  // size 3
+    int source_id = 0;                      // FACE_SOURCE_NAMES 인덱스
+    uint64_t seq = 0;                       // 샘플 순번 (trace 용, producer 의 frame_id). 0 = 없음
+    BlendshapeArray blendshapes = no_blendshapes();
+    std::array<float, 3> avg_rgb{};         // [r, g, b]
+    std::array<std::array<float, 3>, 3> rotation_matrix{};
+    std::array<float, 3> translation_vector{};
+    std::array<double, 4> head_quat{1.0, 0.0, 0.0, 0.0};  // rotation_matrix → (w, x, y, z), 수신 시 1회 변환
+    bool has_rgb = false;
+    bool has_head_pose = false;             // rotation_matrix / head_quat 유효
+    bool has_translation = false;
 };
 
+// MotionSpectrum 밴드 개수 (밴드 표는 features/motion_spectrum.hpp 의 motion_spectrum_bands)
+constexpr int MOTION_SPECTRUM_BANDS = 3;
+
 struct ImuData {
     double source_timestamp;
-    std::vector<float> accel;
-    std::vector<float> gyro;
+    uint64_t seq = 0;                    // 샘플 순번 (trace 용)
+    std::array<float, 3> accel{};        // m/s²
+    std::array<float, 3> gyro{};         // deg/s
+
+    // MsdvAccumulator 가 채움 (ISO 2631-1 Wf 가중)
+    std::array<float, 3> accel_wf{};     // m/s²
+    std::array<double, 3> msdv_sq{};     // 세션 시작부터 누적 ∫aw² dt
+
+    // MotionSpectrum 이 채움 (축별 Welch PSD 의 밴드 파워, segment 가 끝날 때마다 갱신)
+    std::array<std::array<float, 3>, MOTION_SPECTRUM_BANDS> band_power{};   // (m/s²)², [band][축]
+    bool spectrum_valid = false;         // 첫 segment 이후
+
+    // GpsImuFusion 이 채움 (GPS fix 사이를 IMU 로 적분, IMU 주기)
+    float fused_speed = 0.0f;            // km/h
+    float fused_heading = 0.0f;          // deg, 북=0 시계방향 (GpsData::heading 과 같은 기준)
+    float fused_long_acc = 0.0f;         // m/s², 가속이 양수 (accel bias 보정)
+    float fused_lat_acc = 0.0f;          // m/s², 우회전이 양수
+    bool fused_valid = false;            // 첫 GPS fix 이후 (speed / 가속도)
+    bool fused_heading_valid = false;    // 주행 중 GPS heading 을 한 번이라도 받은 뒤
 };
 
 struct GpsData {
     double source_timestamp;
+    uint64_t seq = 0;            // fix 순번 (trace 용)
     double lat;
     double lon;
     double speed;
+
+    // GpsKinematics 가 채움 (첫 fix 기준 로컬 ENU)
+    double east = 0.0;           // m
+    double north = 0.0;          // m
+    double heading = 0.0;        // deg, 북=0 시계방향
+    double heading_rate = 0.0;   // deg/s
+    double long_acc = 0.0;       // m/s²
+    double lat_acc = 0.0;        // m/s², 우회전이 양수
+    double curvature = 0.0;      // 1/m
+    bool kinematics_valid = false;
+};
+
+// 차량 CAN 신호. CanReceiver 가 신호별 최신값을 CAN_SAMPLE_RATE_HZ 로 묶어서 한 샘플로 저장
+// 아직 못 받았거나 끊긴 (CAN_SIGNAL_TIMEOUT_SEC) 신호는 NaN
+struct CanData {
+    double source_timestamp;
+    uint64_t seq = 0;                 // 샘플 순번 (trace 용)
+    float speed = std::numeric_limits<float>::quiet_NaN();           // km/h (차속, 휠속 기반)
+    float steer_angle = std::numeric_limits<float>::quiet_NaN();     // deg, 좌회전 양수
+    float steer_rate = std::numeric_limits<float>::quiet_NaN();      // deg/s
+    float accel_pedal = std::numeric_limits<float>::quiet_NaN();     // %
+    float brake_pressure = std::numeric_limits<float>::quiet_NaN();  // bar (마스터 실린더)
+};
+
+// 토글 버튼(멀미/불편함/불안감) 한 번 누를 때마다 하나
+struct ToggleEvent {
+    double timestamp = 0.0;   // 벽시계 초 (다른 테이블과 같은 축, 세션 중 시계 보정에 흔들리지 않음)
+    double monotonic = 0.0;   // steady_clock 초, 클릭 순간
+    int button = 0;           // 0 멀미, 1 불편함, 2 불안감
+    int state = 0;            // 누른 뒤 상태 (1 = ON)
 };
 
 enum class SensorType {
@@ -40,15 +140,6 @@ struct DBWriteRequest {
     std::vector<ImuData> imu_batch;
 };
 
-extern std::vector<FaceData> face_buffer;
-extern std::mutex face_buffer_mutex;
-
-extern std::vector<ImuData> imu_buffer;
-extern std::mutex imu_buffer_mutex;
-
-extern const int FACE_BUFFER_MAX_SIZE;
-extern const int IMU_BUFFER_MAX_SIZE;
-
 extern std::atomic<double> last_face_detected_time;
 
 // 각 버튼 상태를 독립적으로 atomic하게 관리
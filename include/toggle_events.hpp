@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ring_read.hpp"
+#include "shared_structs.hpp"
+
+// GUI 스레드(쓰기 1개)가 토글 클릭을 기록하는 고정 크기 이벤트 로그. 락 없음.
+// 읽는 쪽(DB 기록, CSV tick)은 각자 위치를 들고 read_since 로 따라간다 → GUI 는 I/O 를 기다리지 않는다.
+class ToggleEventLog {
+public:
+    static constexpr size_t capacity = 256;   // 1초 tick 사이에 이만큼 누를 일은 없다 (넘치면 읽는 쪽이 센다)
+
+    ToggleEventLog() {
+        // 벽시계 = monotonic + offset (시작 시 한 번만 맞춘다)
+        wall_offset_ = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count()
+                     - monotonic_now();
+    }
+
+    static double monotonic_now() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // GUI 스레드에서만 호출
+    void record(int button, int state) {
+        double mono = monotonic_now();
+        uint64_t seq = written_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[seq % capacity];
+        slot.monotonic.store(mono, std::memory_order_relaxed);
+        slot.button.store(button, std::memory_order_relaxed);
+        slot.state.store(state, std::memory_order_relaxed);
+        written_.store(seq + 1, std::memory_order_release);
+    }
+
+    uint64_t written() const { return written_.load(std::memory_order_acquire); }
+
+    // since 이후 이벤트를 out 뒤에 붙이고 새 위치를 반환 (capacity 보다 밀렸으면 최근 것만, 놓친 개수는 lost 에)
+    uint64_t read_since(uint64_t since, std::vector<ToggleEvent>& out, uint64_t* lost = nullptr) const {
+        return ring_read_since<capacity>(written_, since, out, [this](uint64_t s) {
+            const Slot& slot = slots_[s % capacity];
+            ToggleEvent ev;
+            ev.monotonic = slot.monotonic.load(std::memory_order_relaxed);
+            ev.timestamp = ev.monotonic + wall_offset_;
+            ev.button = slot.button.load(std::memory_order_relaxed);
+            ev.state = slot.state.load(std::memory_order_relaxed);
+            return ev;
+        }, lost);
+    }
+
+private:
+    struct Slot {
+        std::atomic<double> monotonic{0.0};
+        std::atomic<int> button{0};
+        std::atomic<int> state{0};
+    };
+
+    std::array<Slot, capacity> slots_;
+    std::atomic<uint64_t> written_{0};
+    double wall_offset_ = 0.0;
+};
+
+extern ToggleEventLog toggle_event_log;
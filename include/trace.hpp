@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 샘플 하나가 카메라 → 수신 → 파싱 → 버퍼 → summary tick → DB 까지 어디서 시간을 쓰는지 보는 span 기록.
+// - 빌드 옵션 MOTIONSICK_TRACING (MOTIONSICK_TRACE=1) 이 꺼져 있으면 TraceSpan 은 빈 클래스 → 코드가 남지 않는다
+// - 켜져 있어도 --trace 로 trace_start() 하기 전에는 span 하나에 atomic load 한 번
+// - 스레드마다 고정 크기 링 버퍼 (락 없음, 가득 차면 오래된 것부터 덮어씀). 등록할 때만 mutex
+// - trace_write_chrome_json(): Chrome trace-event JSON (Perfetto / chrome://tracing 에서 열림)
+// seq 는 샘플 순번 (FaceData / ImuData / GpsData::seq). 0 이면 없음, 구간이면 [seq_first, seq_last]
+
+#ifndef MOTIONSICK_TRACE
+#define MOTIONSICK_TRACE 0
+#endif
+
+constexpr size_t TRACE_EVENTS_PER_THREAD = 1 << 16;
+
+#if MOTIONSICK_TRACE
+
+extern std::atomic<bool> trace_active;
+
+inline bool trace_enabled() { return trace_active.load(std::memory_order_relaxed); }
+
+// 트레이스 시계 (steady, ns)
+int64_t trace_now_ns();
+// 벽시계 epoch 초 → 트레이스 시계 (producer 가 보낸 시각용)
+int64_t trace_from_wall(double epoch_seconds);
+
+void trace_record(const char* name, int64_t start_ns, int64_t end_ns, uint64_t seq_first = 0, uint64_t seq_last = 0);
+
+// 이 스레드의 트랙 이름 (name 은 문자열 상수)
+void trace_thread_name(const char* name);
+
+void trace_start();
+// 지금까지 기록된 span 을 JSON 으로. 기록 중인 스레드가 있어도 됨 (덮어쓰이는 중인 이벤트는 건너뜀)
+bool trace_write_chrome_json(const std::string& path);
+
+// 범위가 끝날 때 span 하나 기록. name 은 문자열 상수 ("face.parse" 처럼 "분류.이름")
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, uint64_t seq_first = 0, uint64_t seq_last = 0)
+        : name_(name), seq_first_(seq_first), seq_last_(seq_last) {
+        if (trace_enabled()) start_ns_ = trace_now_ns();
+    }
+    ~TraceSpan() {
+        if (start_ns_ >= 0) trace_record(name_, start_ns_, trace_now_ns(), seq_first_, seq_last_);
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    // 범위 안에서 알게 된 샘플 순번
+    void set_seq(uint64_t seq_first, uint64_t seq_last = 0) {
+        seq_first_ = seq_first;
+        seq_last_ = seq_last;
+    }
+
+private:
+    const char* name_;
+    uint64_t seq_first_;
+    uint64_t seq_last_;
+    int64_t start_ns_ = -1;
+};
+
+#else
+
+inline bool trace_enabled() { return false; }
+inline int64_t trace_now_ns() { return 0; }
+inline int64_t trace_from_wall(double) { return 0; }
+inline void trace_record(const char*, int64_t, int64_t, uint64_t = 0, uint64_t = 0) {}
+inline void trace_thread_name(const char*) {}
+void trace_start();
+bool trace_write_chrome_json(const std::string& path);
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char*, uint64_t = 0, uint64_t = 0) {}
+    void set_seq(uint64_t, uint64_t = 0) {}
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "../include/alloc_check.hpp"
+
+#if MOTIONSICK_ALLOC_CHECK
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    // 스레드 시작 전에 0 으로 초기화되는 POD 라 operator new 안에서 써도 안전
+    thread_local uint64_t thread_allocations = 0;
+
+    std::atomic<SteadyStateLoop*> loops{nullptr};
+
+    void* counted_alloc(std::size_t size) {
+        ++thread_allocations;
+        return std::malloc(size ? size : 1);
+    }
+
+    void* counted_aligned_alloc(std::size_t size, std::align_val_t align) {
+        ++thread_allocations;
+        std::size_t alignment = static_cast<std::size_t>(align);
+        if (alignment < sizeof(void*)) alignment = sizeof(void*);
+        void* p = nullptr;
+        if (posix_memalign(&p, alignment, size ? size : 1) != 0) return nullptr;
+        return p;
+    }
+}
+
+uint64_t alloc_count_this_thread() {
+    return thread_allocations;
+}
+
+SteadyStateLoop::SteadyStateLoop(const char* name, uint64_t warmup_iterations, bool fatal)
+    : name_(name), warmup_(warmup_iterations), fatal_(fatal) {
+    // 보고용 목록에 끼운다 (할당 없이)
+    next_ = loops.load(std::memory_order_relaxed);
+    while (!loops.compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
+void SteadyStateLoop::finish(uint64_t allocations) {
+    uint64_t iteration = iterations_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (iteration <= warmup_ || allocations == 0) return;
+
+    steady_allocations_.fetch_add(allocations, std::memory_order_relaxed);
+    // iostream 은 할당할 수 있으니 stdio 로
+    std::fprintf(stderr, "[Alloc] %s: %llu allocation(s) in iteration %llu (after %llu warm-up iterations)\n",
+                 name_, static_cast<unsigned long long>(allocations), static_cast<unsigned long long>(iteration),
+                 static_cast<unsigned long long>(warmup_));
+    if (fatal_) std::abort();
+}
+
+void alloc_check_report() {
+    for (SteadyStateLoop* loop = loops.load(std::memory_order_acquire); loop; loop = loop->next_) {
+        std::fprintf(stderr, "[Alloc] %s: %llu iterations, %llu allocations after warm-up\n", loop->name_,
+                     static_cast<unsigned long long>(loop->iterations_.load(std::memory_order_relaxed)),
+                     static_cast<unsigned long long>(loop->steady_allocations_.load(std::memory_order_relaxed)));
+    }
+}
+
+void* operator new(std::size_t size) {
+    void* p = counted_alloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    void* p = counted_alloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_alloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    void* p = counted_aligned_alloc(size, align);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+    void* p = counted_aligned_alloc(size, align);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+#endif
@@ -3,376 +3,411 @@
 #include <chrono>
 #include <mutex>
 #include <vector>
-#include <cmath>
 #include <iostream>
-#include <numeric>
-#include <map>
 #include <atomic>
-#include <iomanip>
-#include <algorithm>
+#include <sstream>
 #include <filesystem> 
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
 
 #include "../include/shared_structs.hpp"
-#include "estimate_heart_rate_from_rgb.hpp"
-
-extern std::vector<FaceData> face_buffer;
-extern std::mutex face_buffer_mutex;
-extern std::vector<ImuData> imu_buffer;
-extern std::mutex imu_buffer_mutex;
-extern std::vector<GpsData> gps_buffer;
-extern std::mutex gps_buffer_mutex;
+#include "../features/summary_features.hpp"
+#include "csv_logger.hpp"
+#include "../sensors/idle_monitor.hpp"
+#include "../include/plot_feed.hpp"
+#include "../include/toggle_events.hpp"
+#include "feature_publisher.hpp"
+#include "../include/trace.hpp"
+#include "../include/alloc_check.hpp"
+
+PlotFeed plot_feed;
+
+// tick 하나의 입력 스냅샷과 작업별 결과. 작업은 자기 rows[task] 에만 쓴다
+struct SummaryCsvLogger::TickState {
+    Sensors::Snapshots snapshots;
+
+    std::array<SummaryRow, TASK_COUNT> rows;
+    std::array<bool, TASK_COUNT> submitted{};
+    std::array<bool, TASK_COUNT> done{};
+    std::array<bool, TASK_COUNT> counted{};   // 시간이 task_timing_ 에 반영됨
+    std::array<double, TASK_COUNT> ms{};
+    int remaining = 0;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+};
 
 namespace {
-    double compute_rms(const std::vector<float>& values) {
-        if (values.empty()) return 0.0;
-        double sum_sq = 0.0;
-        for (float v : values) sum_sq += v * v;
-        return std::sqrt(sum_sq / values.size());
+    // 시각순 버퍼에서 fed_until 이후 샘플만 넣는다
+    template <typename Traits, typename T>
+    void feed_new_samples(SummaryPyramid& pyramid, const std::vector<T>& samples, double& fed_until) {
+        auto it = std::upper_bound(samples.begin(), samples.end(), fed_until,
+                                   [](double t, const T& s) { return t < s.source_timestamp; });
+        for (; it != samples.end(); ++it) Traits::add_to_pyramid(pyramid, *it);
+        if (!samples.empty()) fed_until = std::max(fed_until, samples.back().source_timestamp);
     }
-    
-    // 1차 선형회귀로 R^2 계산
-    double compute_r2(const std::vector<double>& x, const std::vector<double>& y) {
-        if (x.size() != y.size() || x.empty()) return 0.0;
-
-        const size_t n = x.size();
-        double mean_x = std::accumulate(x.begin(), x.end(), 0.0) / n;
-        double mean_y = std::accumulate(y.begin(), y.end(), 0.0) / n;
-
-        double Sxy = 0.0, Sxx = 0.0, Syy = 0.0;
-        for (size_t i = 0; i < n; ++i) {
-            double dx = x[i] - mean_x;
-            double dy = y[i] - mean_y;
-            Sxy += dx * dy;
-            Sxx += dx * dx;
-            Syy += dy * dy;
-        }
 
-        double r2 = (Sxy * Sxy) / (Sxx * Syy + 1e-9);  // 1e-9: divide-by-zero 방지
-        return r2;
+    // 트레이스용: 스냅샷에 든 샘플 순번 구간
+    template <typename T>
+    void trace_seq_range(TraceSpan& span, const std::vector<T>& samples) {
+        if (!samples.empty()) span.set_seq(samples.front().seq, samples.back().seq);
     }
 }
 
-const std::vector<std::string> blend_shape_keys = {
-        "browDownLeft", "browDownRight", "browInnerUp", "browOuterUpLeft", "browOuterUpRight",
-        "cheekPuff", "cheekSquintLeft", "cheekSquintRight", "eyeBlinkLeft", "eyeBlinkRight",
-        "eyeLookDownLeft", "eyeLookDownRight", "eyeLookInLeft", "eyeLookInRight",
-        "eyeLookOutLeft", "eyeLookOutRight", "eyeLookUpLeft", "eyeLookUpRight",
-        "eyeSquintLeft", "eyeSquintRight", "eyeWideLeft", "eyeWideRight",
-        "jawForward", "jawLeft", "jawOpen", "jawRight",
-        "mouthClose", "mouthDimpleLeft", "mouthDimpleRight", "mouthFrownLeft", "mouthFrownRight",
-        "mouthFunnel", "mouthLeft", "mouthLowerDownLeft", "mouthLowerDownRight",
-        "mouthPressLeft", "mouthPressRight", "mouthPucker", "mouthRight",
-        "mouthRollLower", "mouthRollUpper", "mouthShrugLower", "mouthShrugUpper",
-        "mouthSmileLeft", "mouthSmileRight", "mouthStretchLeft", "mouthStretchRight",
-        "mouthUpperUpLeft", "mouthUpperUpRight", "noseSneerLeft", "noseSneerRight"
-    };
-
-// ✅ Correct: use brace-enclosed initializer and concat using constructor
-const std::vector<std::string> headers = [] {
-    std::vector<std::string> h = {
-        "timestamp", 
-        "멀미", "불편함", "불안감", 
-        "speed", "trajectory",
-        "acc_rms_x", "acc_rms_y", "acc_rms_z", "roll_rate_rms", "pitch_rate_rms", "yaw_rate_rms",
-        "hr", "r", "g", "b", "head_tv", "head_rv"
-    };
-    h.insert(h.end(), blend_shape_keys.begin(), blend_shape_keys.end());
-    return h;
-}();
-
-void start_csv_logger(std::atomic<bool>& running, 
-                    std::shared_ptr<std::array<std::atomic<int>, 3>> toggle_state,
-                    const std::string& log_path) {
-    std::thread csv_thread([&running, toggle_state, log_path]() {
-        std::ofstream file(log_path, std::ios::app);
-        if (!file.is_open()) return;
+SummaryCsvLogger::SummaryCsvLogger(const std::string& log_path, const std::vector<double>& pyramid_periods)
+    : file_(log_path, std::ios::app) {
+    toggle_batch_.reserve(ToggleEventLog::capacity);
+    for (int i = 0; i < TASK_COUNT + 1; ++i) states_.push_back(std::make_unique<TickState>());
+    if (pyramid_periods.empty()) return;
 
-        static std::vector<double> heart_rate_list;
+    std::string error;
+    if (!SummaryPyramid::valid_periods(pyramid_periods, &error)) {
+        std::cerr << "[CSV] Invalid summary pyramid levels: " << error << std::endl;
+        return;
+    }
 
-        while (running) {
+    // 레벨마다 writer 하나 (summary_100ms.csv, summary_1s.csv, ...)
+    std::filesystem::path dir = std::filesystem::path(log_path).parent_path();
+    for (double period : pyramid_periods) {
+        std::string path = (dir / ("summary_" + pyramid_level_label(period) + ".csv")).string();
+        pyramid_writers_.push_back(std::make_unique<PyramidCsvWriter>(path, period));
+    }
+    pyramid_ = std::make_unique<SummaryPyramid>(pyramid_columns().size(), pyramid_periods,
+        [this](size_t level, double start, const std::vector<PyramidStats>& columns) {
+            pyramid_writers_[level]->write(start, columns);
+        }, PYRAMID_WINDOW_SEC);
+}
 
-            // ✅ 얼굴 감지 후 60초가 지났다면 skip
-            double now = std::chrono::duration<double>(
-                std::chrono::system_clock::now().time_since_epoch()
-            ).count();
+SummaryCsvLogger::~SummaryCsvLogger() {
+    if (!pyramid_) return;
+    pyramid_->flush();
+    for (auto& writer : pyramid_writers_) writer->flush();
+}
 
-            if (now - last_face_detected_time.load() > 60.0) {
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-                continue;
-            }
+void SummaryCsvLogger::feed_pyramid(const TickState& state, double now) {
+    if (!pyramid_) return;
+    TraceSpan span("summary.pyramid");
 
-            // 현재 시간 기록 (초 단위)
-            auto now_time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-            std::tm* now_tm = std::localtime(&now_time_t);
-
-            std::ostringstream timestamp_str;
-            timestamp_str << std::put_time(now_tm, "%Y-%m-%d %H:%M:%S");
-            std::string timestamp = timestamp_str.str();  // "2025-06-24 13:01:32"
-
-            // ✅ 토글 상태 스냅샷
-            int toggle0 = (*toggle_state)[0].load();
-            int toggle1 = (*toggle_state)[1].load();
-            int toggle2 = (*toggle_state)[2].load();  
-            
-            // 기본값 세팅
-            std::map<std::string, double> row;   
-            row["멀미"] = toggle0;
-            row["불편함"] = toggle1;
-            row["불안감"] = toggle2;
-            row["speed"] = 0.0;
-            row["tragectory"] = 0.0;
-
-            row["acc_rms_x"] = 0.0;
-            row["acc_rms_y"] = 0.0;
-            row["acc_rms_z"] = 0.0;
-            row["roll_rate_rms"] = 0.0;
-            row["pitch_rate_rms"] = 0.0;
-            row["yaw_rate_rms"] = 0.0;
-
-            row["hr"] = 0.0;
-            row["r"] = 0.0;
-            row["g"] = 0.0;
-            row["b"] = 0.0;
-
-            row["head_tv"] = 0.0;
-            row["head_rv"] = 0.0;
-
-            // blendshapes 기본값 0.0으로 초기화
-            for (const auto& key : blend_shape_keys) {
-                row[key] = 0.0;
-            }
+    // 시작 직후 / idle 에서 돌아온 뒤의 밀린 샘플은 창에 다 안 들어가므로 이번 tick 자리 (now + 1초까지) 만 남기고 먼저 닫는다.
+    // 평소에는 지난 watermark 가 이보다 뒤라서 아무것도 닫지 않는다
+    pyramid_->advance(now - PYRAMID_WINDOW_SEC + 1.0);
 
-            // Get sensor sanpshot
-            std::vector<FaceData> face_snapshot;
-            std::vector<ImuData> imu_snapshot;
-            std::vector<GpsData> gps_snapshot;
+    Sensors::for_each(state.snapshots, [this](const auto& snapshot) {
+        using T = typename std::decay_t<decltype(snapshot)>::traits;
+        for (int source = 0; source < T::sources; ++source) {
+            feed_new_samples<T>(*pyramid_, snapshot[source], fed_until_[Sensors::first_source<T>() + source]);
+        }
+    });
 
-            {
-                std::lock_guard<std::mutex> lock(face_buffer_mutex);
-                face_snapshot = face_buffer;
-            }
+    pyramid_->advance(now - PYRAMID_LAG_SEC);
+    for (auto& writer : pyramid_writers_) writer->flush();
+}
 
-            {
-                std::lock_guard<std::mutex> lock(imu_buffer_mutex);
-                imu_snapshot = imu_buffer;
-            }
+const char* SummaryCsvLogger::task_name(int task) {
+    const char* name = "";
+    Sensors::with_source(task, [&name](auto tag, int source) {
+        name = decltype(tag)::traits::source_name(source);
+    });
+    return name;
+}
 
-            {
-                std::lock_guard<std::mutex> lock(gps_buffer_mutex);
-                gps_snapshot = gps_buffer;
-            }
+// 풀 워커마다 한 번: 스레드별 특징 버퍼를 스냅샷 최대 크기로 잡아 둔다 (워밍업 뒤에 처음 일하는 워커도 할당 없음)
+void SummaryCsvLogger::init_worker() {
+    trace_thread_name("summary-pool");
+    reserve_feature_scratch(Sensors::max_snapshot_size);
+}
 
-            // 전제: face_snapshot 은 150개 이상일 때만 처리
-            if (face_snapshot.size() > 99) {
-                double t_start = face_snapshot.front().source_timestamp;
-                double t_end = face_snapshot.back().source_timestamp;
-                double elapsed = t_end - t_start;
-
-                double fps = face_snapshot.size() / elapsed;
-                
-                // std::cout << "[fps] Estimated fps: " << fps << std::endl;
-
-                // 평균 RGB 추출
-                std::vector<float> r_vals, g_vals, b_vals;
-                for (const auto& f : face_snapshot) {
-                    if (f.avg_rgb.size() == 3) {
-                        r_vals.push_back(f.avg_rgb[0]);
-                        g_vals.push_back(f.avg_rgb[1]);
-                        b_vals.push_back(f.avg_rgb[2]);
-                    }
-                }
+void SummaryCsvLogger::run_task(TickState* state, int task) {
+    // 워커 스레드의 작업도 워밍업 뒤 할당 없음 (summary.tick 은 tick 스레드만 센다). 워커끼리 공유
+    static SteadyStateLoop steady("summary.task");
+    SteadyStateLoop::Iteration steady_iteration(steady);
+
+    auto t0 = std::chrono::steady_clock::now();
+    SummaryRow& row = state->rows[task];
+
+    // 작업 번호 → 센서 / source (컴파일 타임에 펼쳐진 비교 몇 개)
+    Sensors::with_source(task, [&](auto tag, int source) {
+        using T = typename decltype(tag)::traits;
+        const auto& samples = std::get<SensorSnapshot<T>>(state->snapshots)[source];
+        TraceSpan span(T::summary_span);
+        trace_seq_range(span, samples);
+        T::compute_features(samples, row, source);
+    });
 
-                double r_mean = std::accumulate(r_vals.begin(), r_vals.end(), 0.0f) / r_vals.size();
-                double g_mean = std::accumulate(g_vals.begin(), g_vals.end(), 0.0f) / g_vals.size();
-                double b_mean = std::accumulate(b_vals.begin(), b_vals.end(), 0.0f) / b_vals.size();
-                row["r"] = r_mean;
-                row["g"] = g_mean;
-                row["b"] = b_mean;
-
-                // POS 알고리즘을 통해 HR 계산
-                double hr = estimate_heart_rate_from_rgb(r_vals, g_vals, b_vals, fps);
-
-                // 심박수 리스트에 추가
-                if (hr > 30 && hr < 180) { // 유효한 범위 필터링
-                    heart_rate_list.push_back(hr);
-                    if (heart_rate_list.size() > 30) {
-                        heart_rate_list.erase(heart_rate_list.begin());  // 오래된 값 제거
-                    }
-
-                    // 평균과 표준편차 계산
-                    double mean = std::accumulate(heart_rate_list.begin(), heart_rate_list.end(), 0.0) / heart_rate_list.size();
-
-                    double sq_sum = std::inner_product(heart_rate_list.begin(), heart_rate_list.end(), heart_rate_list.begin(), 0.0);
-                    double std_dev = std::sqrt(sq_sum / heart_rate_list.size() - mean * mean);
-
-                    // 이상치 제거 (mean ± std 범위 내 값 필터링)
-                    std::vector<double> filtered;
-                    for (double val : heart_rate_list) {
-                        if (val >= mean - std_dev && val <= mean + std_dev) {
-                            filtered.push_back(val);
-                        }
-                    }
-
-                    double hr_filtered = 0.0;
-                    if (!filtered.empty()) {
-                        hr_filtered = std::accumulate(filtered.begin(), filtered.end(), 0.0) / filtered.size();
-                    }
-                    // std::cout << "[HR] Estimated Heart Rate: " << hr_filtered << " bpm" << std::endl;
-                    row["hr"] = hr_filtered; // Update HR value
-                } 
-                
-
-                // Rotation & Translation 속도 계산
-                std::vector<double> translation_speeds, rotation_speeds;
-                for (size_t i = 1; i < face_snapshot.size(); ++i) {
-                    double dt = face_snapshot[i].source_timestamp - face_snapshot[i-1].source_timestamp;
-                    if (dt <= 0) continue;
-
-                    // Translation 속도
-                    const auto& t1 = face_snapshot[i-1].translation_vector;
-                    const auto& t2 = face_snapshot[i].translation_vector;
-                    if (t1.size() != 3 || t2.size() != 3) continue;
-
-                    double dx = t2[0] - t1[0];
-                    double dy = t2[1] - t1[1];
-                    double dz = t2[2] - t1[2];
-                    double trans_speed = std::sqrt(dx*dx + dy*dy + dz*dz) / dt;
-                    translation_speeds.push_back(trans_speed);
-
-                    // Rotation 속도
-                    const auto& r1 = face_snapshot[i-1].rotation_matrix;
-                    const auto& r2 = face_snapshot[i].rotation_matrix;
-
-                    if (r1.size() == 3 && r2.size() == 3 &&
-                        r1[0].size() == 3 && r2[0].size() == 3) {
-                        // 상대 회전 행렬 R_delta = R2 * R1^T
-                        std::vector<std::vector<double>> r1_T(3, std::vector<double>(3));
-                        for (int r = 0; r < 3; ++r)
-                            for (int c = 0; c < 3; ++c)
-                                r1_T[r][c] = r1[c][r];
-
-                        std::vector<std::vector<double>> r_delta(3, std::vector<double>(3, 0.0));
-                        for (int r = 0; r < 3; ++r)
-                            for (int c = 0; c < 3; ++c)
-                                for (int k = 0; k < 3; ++k)
-                                    r_delta[r][c] += r2[r][k] * r1_T[k][c];
-
-                        // Trace 이용해서 회전 각도 계산
-                        double trace = r_delta[0][0] + r_delta[1][1] + r_delta[2][2];
-                        double angle_rad = std::acos(std::clamp((trace - 1.0) / 2.0, -1.0, 1.0));
-                        double angle_deg_per_sec = angle_rad * 180.0 / M_PI / dt;
-
-                        rotation_speeds.push_back(angle_deg_per_sec);
-                    }
-                }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->ms[task] = ms;
+    state->done[task] = true;
+    if (--state->remaining == 0) state->cv.notify_one();
+}
 
-                double avg_tv = translation_speeds.empty() ? 0.0 :
-                    std::accumulate(translation_speeds.begin(), translation_speeds.end(), 0.0) / translation_speeds.size();
-                double avg_rv = rotation_speeds.empty() ? 0.0 :
-                    std::accumulate(rotation_speeds.begin(), rotation_speeds.end(), 0.0) / rotation_speeds.size();
-
-                row["head_tv"] = avg_tv;
-                row["head_rv"] = avg_rv;
-                
-                // blend shapes
-                std::unordered_map<std::string, std::vector<float>> blendshape_values;
-
-                for (const auto& face : face_snapshot) {
-                    for (const auto& [key, value] : face.blendshapes) {
-                        blendshape_values[key].push_back(value);
-                    }
+void SummaryCsvLogger::tick() {
+    // ✅ 얼굴 감지 후 60초가 지났다면 skip (idle)
+    double now = std::chrono::duration<double>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+
+    if (idle_monitor.refresh(now)) return;
+
+    TraceSpan tick_span("summary.tick");
+    TickState* state = nullptr;
+    {
+        // 행은 컬럼 번호 배열, 상태 / 스냅샷 / 작업 큐는 미리 잡혀 있어서 워밍업 뒤에는 할당하지 않는다
+        static SteadyStateLoop steady("summary.tick", 10);
+        SteadyStateLoop::Iteration steady_iteration(steady);
+        const auto tick_start = std::chrono::steady_clock::now();
+        const auto deadline = tick_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(TICK_DEADLINE_SEC));
+
+        char timestamp[SUMMARY_TIMESTAMP_SIZE];
+        format_summary_timestamp(now, timestamp);   // "2025-06-24 13:01:32"
+
+        // ✅ 아직 도는 작업이 없는 상태를 고른다. 도는 작업은 이번 tick 에서 건너뛴다
+        std::array<bool, TASK_COUNT> busy{};
+        for (auto& candidate : states_) {
+            std::lock_guard<std::mutex> lock(candidate->mutex);
+            std::lock_guard<std::mutex> timing_lock(timing_mutex_);
+            bool running = false;
+            for (int t = 0; t < TASK_COUNT; ++t) {
+                if (candidate->submitted[t] && !candidate->done[t]) {
+                    busy[t] = true;
+                    running = true;
                 }
-
-                for (const auto& [key, values] : blendshape_values) {
-                    if (!values.empty()) {
-                        double sum = std::accumulate(values.begin(), values.end(), 0.0);
-                        row[key] = sum / values.size();
-                    } 
+                // deadline 을 넘겨 늦게 끝난 작업 시간도 통계에 넣는다
+                if (candidate->done[t] && !candidate->counted[t]) {
+                    task_timing_[t].add(candidate->ms[t]);
+                    candidate->counted[t] = true;
                 }
             }
+            if (!running && !state) state = candidate.get();
+        }
 
-            // IMU sensor
-            std::vector<float> ax, ay, az, gx, gy, gz;
-            for (const auto& imu : imu_snapshot) {
-                ax.push_back(imu.accel[0]); ay.push_back(imu.accel[1]); az.push_back(imu.accel[2]);
-                gx.push_back(imu.gyro[0]);  gy.push_back(imu.gyro[1]);  gz.push_back(imu.gyro[2]);
+        // Get sensor sanpshot (작업들이 읽는 동안 tick 스레드는 건드리지 않는다)
+        sensors.snapshot(state->snapshots);
+
+        // ✅ 작업 그래프: 센서 / source 마다 서로 독립 → 풀에 던지고 행 쓰기 전에 join
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->remaining = 0;
+            for (int t = 0; t < TASK_COUNT; ++t) {
+                state->rows[t].clear();
+                state->submitted[t] = !busy[t];
+                state->done[t] = false;
+                state->counted[t] = false;
+                if (state->submitted[t]) ++state->remaining;
             }
-
-            double ax_rms = compute_rms(ax);
-            double ay_rms = compute_rms(ay);
-            double az_rms = compute_rms(az);
-            double gx_rms = compute_rms(gx);
-            double gy_rms = compute_rms(gy);
-            double gz_rms = compute_rms(gz);
-
-            row["acc_rms_x"] = ax_rms;
-            row["acc_rms_y"] = ay_rms;
-            row["acc_rms_z"] = az_rms;
-            row["roll_rate_rms"] = gx_rms;
-            row["pitch_rate_rms"] = gy_rms;
-            row["yaw_rate_rms"] = gz_rms;
-
-            // GPS
-            std::vector<double> speed, lat, lon;
-
-            for (const auto& gps : gps_snapshot) {
-                speed.push_back(gps.speed);
-                lat.push_back(gps.lat);
-                lon.push_back(gps.lon);
+        }
+        for (int t = 0; t < TASK_COUNT; ++t) {
+            if (state->submitted[t]) {
+                pool_.submit([state, t]() { run_task(state, t); });   // 포인터 + int: std::function 안에 들어감
             }
+        }
 
-            double average_speed = 0.0;
-            if (!speed.empty()) {
-                double sum = std::accumulate(speed.begin(), speed.end(), 0.0);
-                average_speed = sum / speed.size();
-                row["speed"] = average_speed;
-            }
+        std::array<bool, TASK_COUNT> finished{};
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->cv.wait_until(lock, deadline, [state]() { return state->remaining == 0; });
+            finished = state->done;
+        }
 
-            // R² 계산 (lat = f(lon) 또는 lon = f(lat), 둘 다 가능)
-            double r2 = compute_r2(lon, lat);  // 또는 compute_r2(lat, lon);
-            row["tragectory"] = r2;
-            
-            // Writing to File
-            for (size_t i = 0; i < headers.size(); ++i) {
-                const std::string& col = headers[i];
-                if (col == "timestamp") {
-                    file << timestamp;
-                } else {
-                    double value = row.count(col) ? row[col] : 0.0;
-                    file << value;
+        // 기본값 세팅 후 끝난 작업 결과만 합친다
+        SummaryRow row;
+
+        // ✅ 토글 컬럼: 지난 tick 이후 클릭 이벤트에서 (이 1초 동안 ON 이었던 적이 있으면 1)
+        toggle_batch_.clear();
+        toggle_cursor_ = toggle_event_log.read_since(toggle_cursor_, toggle_batch_);
+        toggle_labeler_.apply(toggle_batch_, row);
+
+        for (int t = 0; t < TASK_COUNT; ++t) {
+            if (finished[t]) row.merge(state->rows[t]);
+        }
+
+        // HR 스무딩은 tick 순서대로 한 스레드에서 (히스토리가 있으므로)
+        for (int source = 0; source < FaceSensor::sources; ++source) {
+            const int task = Sensors::first_source<FaceSensor>() + source;
+            if (!finished[task] || state->rows[task].empty()) continue;
+            const int hr = face_column(source, FACE_HR);
+            row.set(hr, hr_smoothers_[source].update(row[hr], row[face_column(source, FACE_HR_SNR)]));
+        }
+
+        // Writing to File
+        {
+            TraceSpan span("summary.write_row");
+            write_summary_row(file_, timestamp, row);
+            file_.flush();
+        }
+
+        // 구독 중인 프로세스에 같은 행을 바로 (구독자가 없으면 아무것도 안 함)
+        feature_publisher.publish_summary(now, row);
+
+        // 화면 그래프용 (UI 는 plot_feed 만 읽는다)
+        plot_feed.hr.push(static_cast<float>(row[face_column(0, FACE_HR)]));
+        plot_feed.acc_rms.push(static_cast<float>(std::sqrt(
+            row[COL_ACC_RMS_X] * row[COL_ACC_RMS_X] + row[COL_ACC_RMS_Y] * row[COL_ACC_RMS_Y] +
+            row[COL_ACC_RMS_Z] * row[COL_ACC_RMS_Z])));
+        plot_feed.speed.push(static_cast<float>(row[COL_SPEED]));
+
+        // 작업별 시간 / deadline 초과 기록
+        double latency_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tick_start).count();
+        std::array<bool, TASK_COUNT> missed{};
+        bool any_missed = false;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            std::lock_guard<std::mutex> timing_lock(timing_mutex_);
+            row_latency_.add(latency_ms);
+            for (int t = 0; t < TASK_COUNT; ++t) {
+                if (busy[t]) {
+                    ++task_timing_[t].skipped;
+                } else if (!finished[t]) {
+                    ++task_timing_[t].missed;
+                    missed[t] = any_missed = true;
+                } else if (!state->counted[t]) {
+                    task_timing_[t].add(state->ms[t]);
+                    state->counted[t] = true;
                 }
+            }
+        }
+        if (any_missed) {
+            std::cerr << "[CSV] " << timestamp << ": deadline " << TICK_DEADLINE_SEC * 1000.0 << " ms missed by ";
+            const char* separator = "";
+            for (int t = 0; t < TASK_COUNT; ++t) {
+                if (!missed[t]) continue;
+                std::cerr << separator << task_name(t);
+                separator = ", ";
+            }
+            std::cerr << " (columns left at defaults)" << std::endl;
+        }
+    }
+
+    // 피라미드는 행을 쓴 뒤에 (열린 버킷은 생성 시 잡은 고정 링, 레벨 CSV 한 줄도 할당 없음)
+    static SteadyStateLoop pyramid_steady("summary.pyramid", 10);
+    SteadyStateLoop::Iteration pyramid_iteration(pyramid_steady);
+    feed_pyramid(*state, now);
+}
 
-                if (i != headers.size() - 1) file << ",";
+void SummaryCsvLogger::report_timings() {
+    std::lock_guard<std::mutex> lock(timing_mutex_);
+    if (row_latency_.runs == 0) return;
+
+    char buf[128];
+    std::ostringstream line;
+    std::snprintf(buf, sizeof(buf), "[Stats] summary tick: row latency avg %.1f ms, max %.1f ms",
+                  row_latency_.total_ms / row_latency_.runs, row_latency_.max_ms);
+    line << buf;
+    for (int t = 0; t < TASK_COUNT; ++t) {
+        const Timing& timing = task_timing_[t];
+        if (timing.runs == 0 && timing.missed == 0 && timing.skipped == 0) continue;
+        std::snprintf(buf, sizeof(buf), "; %s avg %.2f max %.2f ms", task_name(t),
+                      timing.runs ? timing.total_ms / timing.runs : 0.0, timing.max_ms);
+        line << buf;
+        if (timing.missed) line << ", missed " << timing.missed;
+        if (timing.skipped) line << ", skipped " << timing.skipped;
+    }
+    std::cout << line.str() << std::endl;
+
+    row_latency_ = Timing{};
+    task_timing_.fill(Timing{});
+}
+
+void start_csv_logger(std::atomic<bool>& running, const std::string& log_path, bool print_stats,
+                      const std::vector<double>& pyramid_periods) {
+    std::thread csv_thread([&running, log_path, print_stats, pyramid_periods]() {
+        trace_thread_name("csv");
+        SummaryCsvLogger logger(log_path, pyramid_periods);
+        if (!logger.is_open()) return;
+
+        // sleep_for(1s) 를 tick 뒤에 하면 tick 시간만큼 주기가 밀리므로 절대 시각에 맞춰 잔다
+        auto next_tick = std::chrono::steady_clock::now();
+        auto next_report = next_tick + std::chrono::seconds(10);
+        while (running) {
+            logger.tick();
+
+            if (print_stats && std::chrono::steady_clock::now() >= next_report) {
+                logger.report_timings();
+                next_report = std::chrono::steady_clock::now() + std::chrono::seconds(10);
             }
-            file << "\n";
-            file.flush();
 
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            // idle 이면 얼굴이 돌아올 때까지 잠들고, 아니면 1초 주기
+            if (idle_monitor.idle()) {
+                if (!idle_monitor.wait_until_active()) break;
+                next_tick = std::chrono::steady_clock::now();
+            } else {
+                next_tick += std::chrono::seconds(1);
+                auto now = std::chrono::steady_clock::now();
+                if (next_tick < now) next_tick = now;   // 밀린 tick 은 몰아서 하지 않는다
+                std::this_thread::sleep_until(next_tick);
+            }
         }
     });
 
     csv_thread.detach();    
 }
 
-// CSV 파일 초기화
-void initialize_csv(const std::string& log_path) {       
-    
-    bool file_exists = std::filesystem::exists(log_path);
+namespace {
+    // 헤더가 같은 기존 파일은 이어 쓰고, 컬럼 구성이 바뀐 파일은 옆으로 옮긴 뒤 새로 헤더를 쓴다
+    void prepare_csv_file(const std::string& log_path, const std::string& header) {
+        namespace fs = std::filesystem;
 
-    std::ofstream file(log_path, std::ios::app);
-    if (!file.is_open()) {
-        std::cerr << "⚠️ Failed to open CSV log file: " << log_path << std::endl;
-        return;
-    }
+        bool file_exists = fs::exists(log_path);
+
+        // 컬럼 구성이 바뀐 기존 파일에는 이어 쓰지 않고 옆으로 옮겨둔다
+        if (file_exists) {
+            std::string first_line;
+            {
+                std::ifstream in(log_path);
+                std::getline(in, first_line);
+            }
 
-    if (!file_exists) {
-        for (size_t i = 0; i < headers.size(); ++i) {
-            file << headers[i];
-            if (i != headers.size() - 1) file << ",";
+            if (first_line + "\n" != header) {
+                fs::path p(log_path);
+                std::string suffix = format_summary_timestamp(
+                    std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count());
+                std::replace(suffix.begin(), suffix.end(), ' ', '_');
+                std::replace(suffix.begin(), suffix.end(), ':', '-');
+                fs::path rotated = p.parent_path() / (p.stem().string() + "_" + suffix + p.extension().string());
+
+                std::error_code ec;
+                fs::rename(p, rotated, ec);
+                if (ec) {
+                    std::cerr << "⚠️ CSV header changed but failed to rotate " << log_path << ": " << ec.message() << std::endl;
+                } else {
+                    std::cout << "✅ CSV header changed, previous log moved to " << rotated << std::endl;
+                    file_exists = false;
+                }
+            }
+        }
+
+        std::ofstream file(log_path, std::ios::app);
+        if (!file.is_open()) {
+            std::cerr << "⚠️ Failed to open CSV log file: " << log_path << std::endl;
+            return;
+        }
+
+        if (!file_exists) {
+            file << header;
+            file.flush();
+            std::cout << "✅ CSV header written to " << log_path << std::endl;
         }
-        file << "\n";
-        file.flush();
-        std::cout << "✅ CSV header written to " << log_path << std::endl;
     }
 }
 
+// CSV 파일 초기화
+void initialize_csv(const std::string& log_path) {
+    std::ostringstream header;
+    write_summary_header(header);
+    prepare_csv_file(log_path, header.str());
+}
+
+PyramidCsvWriter::PyramidCsvWriter(const std::string& path, double period)
+    : period_(period) {
+    std::ostringstream header;
+    write_pyramid_header(header);
+    prepare_csv_file(path, header.str());
+    file_.open(path, std::ios::app);
+}
+
+void PyramidCsvWriter::write(double start, const std::vector<PyramidStats>& columns) {
+    write_pyramid_row(file_, start, period_, columns);
+}
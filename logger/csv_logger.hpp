@@ -3,14 +3,108 @@
 #ifndef CSV_LOGGER_HPP
 #define CSV_LOGGER_HPP
 
+#include <algorithm>
 #include <atomic>
 #include <array>
+#include <fstream>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../include/shared_structs.hpp"
+#include "../features/summary_features.hpp"
+#include "../features/summary_pyramid.hpp"
+#include "../features/work_stealing_pool.hpp"
+#include "../sensors/sensor_registry.hpp"
 
 void initialize_csv(const std::string& log_path);
-void start_csv_logger(std::atomic<bool>& running, 
-    std::shared_ptr<std::array<std::atomic<int>, 3>> toggle_state,
-    const std::string& log_path);
+// print_stats: 10초마다 summary tick 작업별 시간 출력 (--stats)
+// pyramid_periods: 다중 해상도 요약 레벨 (비어있으면 끔)
+void start_csv_logger(std::atomic<bool>& running, const std::string& log_path, bool print_stats = false,
+                      const std::vector<double>& pyramid_periods = {});
+
+// 요약 피라미드 레벨 하나 = CSV 파일 하나 (summary_<label>.csv, 헤더가 바뀌면 예전 파일은 옆으로 옮김)
+class PyramidCsvWriter {
+public:
+    PyramidCsvWriter(const std::string& path, double period);
+
+    bool is_open() const { return file_.is_open(); }
+    void write(double start, const std::vector<PyramidStats>& columns);
+    void flush() { file_.flush(); }
+
+private:
+    std::ofstream file_;
+    double period_;
+};
+
+// summary_log.csv 에 1초마다 한 줄 (start_csv_logger 스레드와 이벤트 루프 모드가 같이 씀)
+// 센서 / source 별 (카메라별 얼굴, IMU, GPS) 특징은 tick 마다 작은 고정 풀에서 독립 작업으로 돌리고, 모두 끝나거나
+// deadline(TICK_DEADLINE_SEC) 이 되면 합쳐서 쓴다. 못 끝낸 작업의 컬럼은 기본값으로 나간다.
+class SummaryCsvLogger {
+public:
+    static constexpr double TICK_DEADLINE_SEC = 0.5;   // tick 시작 → 행 기록 상한
+    static constexpr size_t POOL_THREADS = 3;          // 4코어 Pi: UI / 센서 몫으로 한 코어 남김
+
+    static constexpr double PYRAMID_LAG_SEC = 2.0;     // 늦게 도착하는 얼굴 프레임을 기다리는 시간
+    static constexpr double PYRAMID_WINDOW_SEC = 5.0;  // 열어 두는 가장 짧은 버킷 구간: 지연 + tick 간격 + 시계 차이 1초
+
+    // pyramid_periods 가 있으면 log_path 옆에 레벨마다 summary_<label>.csv 를 쓴다
+    explicit SummaryCsvLogger(const std::string& log_path, const std::vector<double>& pyramid_periods = {});
+    ~SummaryCsvLogger();
+
+    bool is_open() const { return file_.is_open(); }
+
+    // 최근 60초 안에 얼굴이 감지되지 않았으면 (idle) 아무것도 쓰지 않는다
+    void tick();
+
+    // 지난 report 이후 작업별 평균 / 최대 시간과 deadline 초과 횟수를 한 줄로 출력
+    void report_timings();
+
+private:
+    // 작업 번호 = Sensors 의 전체 source 번호 (카메라별 얼굴, IMU(+MSDV), GPS)
+    static constexpr int TASK_COUNT = Sensors::source_count;
+
+    struct TickState;
+
+    struct Timing {
+        uint64_t runs = 0;
+        uint64_t missed = 0;    // deadline 안에 못 끝냄
+        uint64_t skipped = 0;   // 지난 tick 의 같은 작업이 아직 돌고 있어서 건너뜀
+        double total_ms = 0.0;
+        double max_ms = 0.0;
+
+        void add(double ms) {
+            ++runs;
+            total_ms += ms;
+            max_ms = std::max(max_ms, ms);
+        }
+    };
+
+    static void init_worker();
+    static void run_task(TickState* state, int task);
+    // 지난 tick 이후 새 샘플만 피라미드에 넣고 watermark 까지 닫는다 (행을 쓴 뒤 tick 스레드에서, 스냅샷은 읽기만 함)
+    void feed_pyramid(const TickState& state, double now);
+    static const char* task_name(int task);
+
+    std::ofstream file_;
+    uint64_t toggle_cursor_ = 0;       // toggle_event_log 읽은 위치
+    std::vector<ToggleEvent> toggle_batch_;
+    ToggleLabeler toggle_labeler_;     // 토글 컬럼은 클릭 이벤트에서 계산
+    std::array<HeartRateSmoother, MAX_FACE_SOURCES> hr_smoothers_;  // 카메라별 HR 히스토리
+
+    std::unique_ptr<SummaryPyramid> pyramid_;
+    std::vector<std::unique_ptr<PyramidCsvWriter>> pyramid_writers_;   // 레벨마다 하나
+    std::array<double, Sensors::source_count> fed_until_{};   // 피라미드에 넣은 마지막 샘플 시각 (작업 번호별)
+
+    // tick 상태는 처음에 TASK_COUNT + 1 개를 만들어 두고 돌려 쓴다. deadline 을 넘긴 작업은 끝날 때까지 자기 상태를 쥐고
+    // 그동안 같은 작업은 다시 제출하지 않으므로 잡혀 있는 상태는 많아야 TASK_COUNT 개 → 빈 상태가 항상 하나 있다
+    std::vector<std::unique_ptr<TickState>> states_;
+    WorkStealingPool pool_{POOL_THREADS, &init_worker};   // states_ 보다 먼저 소멸 (남은 작업을 끝내고 join)
+
+    std::mutex timing_mutex_;   // tick 스레드 ↔ report_timings (스레드 모드는 같은 스레드)
+    std::array<Timing, TASK_COUNT> task_timing_;
+    Timing row_latency_;
+};
 
 #endif // CSV_LOGGER_HPP
@@ -1,108 +1,146 @@
 #include "database_logger.hpp"
-#include <sstream>
 #include <iostream>
+#include <chrono>
+#include "../include/toggle_events.hpp"
+#include "../features/summary_features.hpp"
+
+ToggleEventLog toggle_event_log;
 
 DatabaseLogger::DatabaseLogger(const std::string& db_path) {
+    session_start = std::chrono::duration<double>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
     if (sqlite3_open(db_path.c_str(), &db)) {
         std::cerr << "[DB] Failed to open: " << sqlite3_errmsg(db) << std::endl;
         db = nullptr;
     } else {
         createTablesIfNotExist();
+        prepareStatements();
     }
 }
 
 DatabaseLogger::~DatabaseLogger() {
-    if (db) sqlite3_close(db);
+    if (!db) return;
+    commitBatch();
+    for (sqlite3_stmt* stmt : sample_stmts) sqlite3_finalize(stmt);
+    for (sqlite3_stmt* stmt : {msdv_stmt, toggle_stmt}) sqlite3_finalize(stmt);
+    sqlite3_close(db);
 }
 
 void DatabaseLogger::createTablesIfNotExist() {
-    const char* face_sql = R"(
-        CREATE TABLE IF NOT EXISTS face_data (
+    // 세션별 ISO 2631-1 MSDV (누적) 와 윈도우 가중 RMS
+    const char* msdv_sql = R"(
+        CREATE TABLE IF NOT EXISTS msdv_data (
+            session_start REAL,
             timestamp REAL,
-            r REAL, g REAL, b REAL,
-            blendshapes TEXT
+            aw_rms_x REAL, aw_rms_y REAL, aw_rms_z REAL,
+            msdv_x REAL, msdv_y REAL, msdv_z REAL
         );
     )";
 
-    const char* imu_sql = R"(
-        CREATE TABLE IF NOT EXISTS imu_data (
+    // 토글 버튼 클릭 (상태가 아니라 이벤트, 클릭 순간 시각)
+    const char* toggle_sql = R"(
+        CREATE TABLE IF NOT EXISTS toggle_events (
+            session_start REAL,
             timestamp REAL,
-            ax REAL, ay REAL, az REAL,
-            gx REAL, gy REAL, gz REAL
+            monotonic REAL,
+            button INTEGER,
+            label TEXT,
+            state INTEGER
         );
     )";
 
-    const char* gps_sql = R"(
-        CREATE TABLE IF NOT EXISTS gps_data (
-            timestamp REAL,
-            lat REAL,
-            lon REAL,
-            speed REAL
-        );
+    // 센서 테이블은 traits 에서 (migrate_sql 은 예전 DB 용, 이미 적용됐으면 실패하고 무시됨)
+    std::string index_sql;
+    Sensors::for_each_sensor([&](auto tag) {
+        using T = typename decltype(tag)::traits;
+        sqlite3_exec(db, T::create_sql, nullptr, nullptr, nullptr);
+        if (T::migrate_sql) sqlite3_exec(db, T::migrate_sql, nullptr, nullptr, nullptr);
+        index_sql += std::string("CREATE INDEX IF NOT EXISTS ") + T::table + "_timestamp ON " + T::table + " (timestamp);\n";
+    });
+    sqlite3_exec(db, msdv_sql, nullptr, nullptr, nullptr);
+    sqlite3_exec(db, toggle_sql, nullptr, nullptr, nullptr);
+
+    // 시간 구간 조회용 인덱스 (예전 DB 는 처음 열 때 한 번 만들어짐)
+    index_sql += R"(
+        CREATE INDEX IF NOT EXISTS msdv_data_timestamp ON msdv_data (timestamp);
+        CREATE INDEX IF NOT EXISTS toggle_events_timestamp ON toggle_events (timestamp);
     )";
-
-    sqlite3_exec(db, face_sql, nullptr, nullptr, nullptr);
-    sqlite3_exec(db, imu_sql, nullptr, nullptr, nullptr);
-    sqlite3_exec(db, gps_sql, nullptr, nullptr, nullptr);
+    char* err = nullptr;
+    if (sqlite3_exec(db, index_sql.c_str(), nullptr, nullptr, &err) != SQLITE_OK) {
+        std::cerr << "[DB] Failed to create indexes: " << (err ? err : "") << std::endl;
+        sqlite3_free(err);
+    }
 }
 
-void DatabaseLogger::insertFaceData(const FaceData& data) {
-   
-    try {
-        if (!db) return;
-
-        std::ostringstream bs_json;
-        bs_json << "{";
-        for (const auto& kv : data.blendshapes) {
-            bs_json << "\"" << kv.first << "\":" << kv.second << ",";
+void DatabaseLogger::prepareStatements() {
+    // 샘플마다 SQL 문자열을 만들지 않도록 INSERT 는 열 때 한 번 준비해두고 bind 만 한다
+    struct Statement { sqlite3_stmt** stmt; const char* sql; };
+    std::vector<Statement> statements = {
+        {&msdv_stmt, "INSERT INTO msdv_data VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8);"},
+        {&toggle_stmt, "INSERT INTO toggle_events VALUES (?1, ?2, ?3, ?4, ?5, ?6);"},
+    };
+    Sensors::for_each_sensor([&](auto tag) {
+        using T = typename decltype(tag)::traits;
+        statements.push_back({&sample_stmts[Sensors::index_of<T>()], T::insert_sql});
+    });
+    for (auto& s : statements) {
+        if (sqlite3_prepare_v2(db, s.sql, -1, s.stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "[DB] Failed to prepare \"" << s.sql << "\": " << sqlite3_errmsg(db) << std::endl;
+            *s.stmt = nullptr;
         }
-        std::string bs_str = bs_json.str();
-        if (!data.blendshapes.empty()) bs_str.pop_back();  // remove last comma
-        bs_str += "}";
-
-        std::string sql = "INSERT INTO face_data VALUES (" +
-            std::to_string(data.source_timestamp) + "," +
-            std::to_string(data.avg_rgb[0]) + "," +
-            std::to_string(data.avg_rgb[1]) + "," +
-            std::to_string(data.avg_rgb[2]) + ",'" +
-            bs_str + "');";
-
-        sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
-    } catch (const std::exception& e) {
-        std::cerr << "[DB] Error inserting face data: " << e.what() << std::endl;
     }
-    
+
+    // face 한 줄의 blendshapes JSON (키 52개 × ~25자)
+    bind_text.reserve(2048);
 }
 
-void DatabaseLogger::insertImuData(const ImuData& data) {
-    try {
-        if (!db) return;
+bool DatabaseLogger::step(sqlite3_stmt* stmt, const char* what) {
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    if (!ok) std::cerr << "[DB] Error inserting " << what << ": " << sqlite3_errmsg(db) << std::endl;
+    sqlite3_reset(stmt);
+    return ok;
+}
 
-        std::string sql = "INSERT INTO imu_data VALUES (" +
-            std::to_string(data.source_timestamp) + "," +
-            std::to_string(data.accel[0]) + "," + std::to_string(data.accel[1]) + "," + std::to_string(data.accel[2]) + "," +
-            std::to_string(data.gyro[0]) + "," + std::to_string(data.gyro[1]) + "," + std::to_string(data.gyro[2]) + ");";
+void DatabaseLogger::beginBatch() {
+    if (db && !in_batch) in_batch = sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr) == SQLITE_OK;
+}
 
-        sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
-    } catch (const std::exception& e) {
-        std::cerr << "[DB] Error inserting IMU data: " << e.what() << std::endl;
+void DatabaseLogger::commitBatch() {
+    if (!db || !in_batch) return;
+    if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "[DB] Commit failed: " << sqlite3_errmsg(db) << std::endl;
     }
+    in_batch = false;
 }
 
-void DatabaseLogger::insertGpsData(const GpsData& data) {
-    try {
-        if (!db) return;
-
-        std::string sql = "INSERT INTO gps_data VALUES (" +
-            std::to_string(data.source_timestamp) + "," +
-            std::to_string(data.lat) + "," +
-            std::to_string(data.lon) + "," +
-            std::to_string(data.speed) + ");";
+void DatabaseLogger::insertMsdvData(const MsdvSummary& msdv, double timestamp) {
+    if (!msdv_stmt) return;
 
-        sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
-    } catch (const std::exception& e) {
-        std::cerr << "[DB] Error inserting GPS data: " << e.what() << std::endl;
+    sqlite3_bind_double(msdv_stmt, 1, session_start);
+    sqlite3_bind_double(msdv_stmt, 2, timestamp);
+    for (int i = 0; i < 3; ++i) {
+        sqlite3_bind_double(msdv_stmt, 3 + i, msdv.aw_rms[i]);
+        sqlite3_bind_double(msdv_stmt, 6 + i, msdv.msdv[i]);
     }
+    step(msdv_stmt, "MSDV data");
 }
 
-
+void DatabaseLogger::insertToggleEvents(const std::vector<ToggleEvent>& events) {
+    if (!toggle_stmt || events.empty()) return;
+
+    // 배치 안이면 그 트랜잭션에 같이, 아니면 클릭들만 한 트랜잭션으로
+    const bool own_batch = !in_batch;
+    if (own_batch) beginBatch();
+    for (const auto& ev : events) {
+        if (ev.button < 0 || ev.button >= 3) continue;
+        sqlite3_bind_double(toggle_stmt, 1, session_start);
+        sqlite3_bind_double(toggle_stmt, 2, ev.timestamp);
+        sqlite3_bind_double(toggle_stmt, 3, ev.monotonic);
+        sqlite3_bind_int(toggle_stmt, 4, ev.button);
+        sqlite3_bind_text(toggle_stmt, 5, toggle_columns[ev.button].c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int(toggle_stmt, 6, ev.state);
+        step(toggle_stmt, "toggle event");
+    }
+    if (own_batch) commitBatch();
+}
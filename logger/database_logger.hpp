@@ -1,20 +1,50 @@
 #pragma once
 #include <sqlite3.h>
 #include <string>
+#include <vector>
 #include "../include/shared_structs.hpp"
+#include "../features/msdv.hpp"
+#include "../sensors/sensor_registry.hpp"
+#include "sample_query.hpp"
 
 class DatabaseLogger {
 public:
     DatabaseLogger(const std::string& db_path);
     ~DatabaseLogger();
 
-    void insertFaceData(const FaceData& data);
-    void insertImuData(const ImuData& data);
-    void insertGpsData(const GpsData& data);
-    void insertToggleState(const std::array<int, 3>& state, double timestamp);
+    // 센서 샘플 한 줄 (T = Sensors 의 traits, 테이블 / 컬럼은 traits 가 정함)
+    template <typename T>
+    void insert(const typename T::Sample& sample) {
+        sqlite3_stmt* stmt = sample_stmts[Sensors::index_of<T>()];
+        if (!stmt) return;
+        T::bind(stmt, sample, bind_text);
+        step(stmt, T::table);
+    }
+    // 토글 클릭 이벤트를 한 트랜잭션으로 기록
+    void insertToggleEvents(const std::vector<ToggleEvent>& events);
+    void insertMsdvData(const MsdvSummary& msdv, double timestamp);
+
+    // 그 사이의 insert 를 한 트랜잭션으로 (aggregator tick 한 번 = 커밋 한 번)
+    void beginBatch();
+    void commitBatch();
+
+    // t0 <= timestamp <= t1 구간 (timestamp 인덱스 사용). T = FaceData, ImuData, GpsData, ToggleEvent
+    //   for (const auto& s : db_logger.query<ImuData>(now - 30.0, now)) ...
+    template <typename T>
+    SampleQuery<T> query(double t0, double t1) const { return SampleQuery<T>(db, t0, t1); }
 
 private:
     sqlite3* db;
+    double session_start;  // 이 로거 인스턴스(=세션) 시작 시각
+    bool in_batch = false;
+
+    // 열 때 한 번 준비하는 INSERT (샘플마다 bind → step → reset)
+    std::array<sqlite3_stmt*, Sensors::channel_count> sample_stmts{};   // Sensors 채널 순서
+    sqlite3_stmt* msdv_stmt = nullptr;
+    sqlite3_stmt* toggle_stmt = nullptr;
+    std::string bind_text;   // 문자열 컬럼 (face blendshapes JSON) 재사용 버퍼
 
     void createTablesIfNotExist();
+    void prepareStatements();
+    bool step(sqlite3_stmt* stmt, const char* what);
 };
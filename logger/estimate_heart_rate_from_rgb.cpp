@@ -5,125 +5,219 @@
 #include <numeric>
 #include <complex>
 
-// Butterworth bandpass filter (2nd order)
-std::vector<double> butter_bandpass_filter(const std::vector<double>& signal, double fs, double lowcut, double highcut) {
-    const double nyq = 0.5 * fs;
-    const double low = lowcut / nyq;
-    const double high = highcut / nyq;
-
-    if (low >= 1.0 || high >= 1.0 || signal.size() < 5) return signal;
-
-    std::vector<double> y(signal.size(), 0.0);
-    double a0, a1, a2, b0, b1, b2;
-    
-    // 2nd order Butterworth (precomputed for bilinear transform)
-    double ita = 1.0 / std::tan(M_PI * (high - low) / 2.0);
-    double q = std::sqrt(2.0);  // Q-factor for Butterworth
-    b0 = 1.0 / (1.0 + q * ita + ita * ita);
-    b1 = 2.0 * b0;
-    b2 = b0;
-    a0 = 1.0;
-    a1 = 2.0 * b0 * (ita * ita - 1.0);
-    a2 = b0 * (1.0 - q * ita + ita * ita);
-
-    std::vector<double> x = signal;
-    for (size_t i = 2; i < signal.size(); ++i) {
-        y[i] = b0 * x[i] + b1 * x[i-1] + b2 * x[i-2]
-             - a1 * y[i-1] - a2 * y[i-2];
+namespace {
+    // biquad 하나를 제자리에 (direct form I, 신호 앞은 0)
+    void biquad_in_place(std::vector<double>& x, double b0, double b1, double b2, double a1, double a2) {
+        double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+        for (double& v : x) {
+            double y = b0 * v + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+            x2 = x1; x1 = v;
+            y2 = y1; y1 = y;
+            v = y;
+        }
     }
-    return y;
 }
 
-// Robust standard deviation
-double robust_std(const std::vector<double>& data) {
-    std::vector<double> temp = data;
-    std::nth_element(temp.begin(), temp.begin() + temp.size()/2, temp.end());
-    double median = temp[temp.size()/2];
+// Butterworth bandpass: 2차 고역 (lowcut) → 2차 저역 (highcut), bilinear 변환 (RBJ cookbook, Q = 1/√2).
+// 예전 계수는 (high - low) 를 차단으로 하는 저역통과라서 0.8~2.5Hz 라고 해도 실제로는 1.7Hz 위를 깎았다
+void butter_bandpass_filter(const std::vector<double>& signal, double fs, double lowcut, double highcut,
+                            std::vector<double>& out) {
+    if (&out != &signal) out.assign(signal.begin(), signal.end());
+    if (lowcut <= 0.0 || highcut >= 0.5 * fs || lowcut >= highcut || signal.size() < 5) return;
+
+    const double q = 1.0 / std::sqrt(2.0);
+    {
+        const double w0 = 2.0 * M_PI * lowcut / fs;
+        const double c = std::cos(w0), alpha = std::sin(w0) / (2.0 * q), a0 = 1.0 + alpha;
+        biquad_in_place(out, (1.0 + c) / 2.0 / a0, -(1.0 + c) / a0, (1.0 + c) / 2.0 / a0, -2.0 * c / a0, (1.0 - alpha) / a0);
+    }
+    {
+        const double w0 = 2.0 * M_PI * highcut / fs;
+        const double c = std::cos(w0), alpha = std::sin(w0) / (2.0 * q), a0 = 1.0 + alpha;
+        biquad_in_place(out, (1.0 - c) / 2.0 / a0, (1.0 - c) / a0, (1.0 - c) / 2.0 / a0, -2.0 * c / a0, (1.0 - alpha) / a0);
+    }
+}
 
-    std::vector<double> abs_dev;
-    for (double d : data) abs_dev.push_back(std::abs(d - median));
+// Robust standard deviation (scratch 하나로 중앙값 → 절대편차의 중앙값)
+double robust_std(const std::vector<double>& data, std::vector<double>& scratch) {
+    scratch.assign(data.begin(), data.end());
+    std::nth_element(scratch.begin(), scratch.begin() + scratch.size()/2, scratch.end());
+    double median = scratch[scratch.size()/2];
 
-    std::nth_element(abs_dev.begin(), abs_dev.begin() + abs_dev.size()/2, abs_dev.end());
-    double mad = abs_dev[abs_dev.size()/2];
+    for (size_t i = 0; i < data.size(); ++i) scratch[i] = std::abs(data[i] - median);
+
+    std::nth_element(scratch.begin(), scratch.begin() + scratch.size()/2, scratch.end());
+    double mad = scratch[scratch.size()/2];
 
     return 1.4826 * mad;
 }
 
-// POS algorithm core
-std::vector<double> pos_algorithm(const std::vector<std::vector<double>>& rgb_data, double fps) {
-    std::vector<double> x, y, s;
-
-    for (const auto& rgb : rgb_data) {
-        x.push_back(3.0 * rgb[0] - 2.0 * rgb[1]);
-        y.push_back(1.5 * rgb[0] + rgb[1] - 1.5 * rgb[2]);
+namespace {
+    // bandpass 통과대역 = peak 탐색 / SNR 대역 (대역 밖에서 깎인 bin 이 잡음 바닥을 낮추거나 2배음을 지우지 않게)
+    constexpr double HR_BAND_LOW = 0.7;    // Hz (42 bpm)
+    constexpr double HR_BAND_HIGH = 4.0;   // Hz (240 bpm). 2배음은 120 bpm 까지 대역 안
+
+    // 채널 / 평균 - 1 (조명 세기 제거) 후 최소제곱 직선 제거 (천천히 변하는 조명 / 자세)
+    void normalize_detrend(const std::vector<float>& in, std::vector<double>& out) {
+        size_t n = in.size();
+        out.resize(n);
+        double mean = std::accumulate(in.begin(), in.end(), 0.0) / n;
+        if (mean == 0.0) mean = 1e-6;
+
+        double t_mean = 0.5 * (n - 1);
+        double sum_ty = 0.0, sum_tt = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = in[i] / mean - 1.0;
+            double t = i - t_mean;
+            sum_ty += t * out[i];
+            sum_tt += t * t;
+        }
+        double slope = sum_tt > 0.0 ? sum_ty / sum_tt : 0.0;
+        double offset = std::accumulate(out.begin(), out.end(), 0.0) / n;
+        for (size_t i = 0; i < n; ++i) out[i] -= offset + slope * (i - t_mean);
     }
 
-    double std_x = robust_std(x);
-    double std_y = robust_std(y);
-    if (std_y == 0) std_y = 1e-6;
-
-    double alpha = std_x / std_y;
-    alpha = std::clamp(alpha, 0.3, 3.0);
-
-    for (size_t i = 0; i < x.size(); ++i) {
-        s.push_back(x[i] - alpha * y[i]);
+    double std_dev(const std::vector<double>& v) {
+        double mean = std::accumulate(v.begin(), v.end(), 0.0) / v.size();
+        double sq = 0.0;
+        for (double x : v) sq += (x - mean) * (x - mean);
+        return std::sqrt(sq / v.size());
     }
 
-    return butter_bandpass_filter(s, fps, 0.8, 2.5);
+    // 방법별 투영 계수: s[i] = c[0] R[i] + c[1] G[i] + c[2] B[i] (bandpass 된 채널 기준)
+    std::array<double, 3> projection(RppgMethod method, RppgScratch& sc) {
+        const auto& R = sc.rgb[0];
+        const auto& G = sc.rgb[1];
+        const auto& B = sc.rgb[2];
+        std::vector<double>& tmp_x = sc.tmp_x;
+        std::vector<double>& tmp_y = sc.tmp_y;
+        size_t n = R.size();
+        tmp_x.resize(n);
+        tmp_y.resize(n);
+
+        switch (method) {
+        case RppgMethod::POS: {
+            // S1 = G - B, S2 = -2R + G + B, h = S1 + (σ1/σ2) S2
+            for (size_t i = 0; i < n; ++i) {
+                tmp_x[i] = G[i] - B[i];
+                tmp_y[i] = -2.0 * R[i] + G[i] + B[i];
+            }
+            double sy = std_dev(tmp_y);
+            double alpha = sy > 0.0 ? std_dev(tmp_x) / sy : 0.0;
+            return {-2.0 * alpha, 1.0 + alpha, -1.0 + alpha};
+        }
+        case RppgMethod::CHROM: {
+            // X = 3R - 2G, Y = 1.5R + G - 1.5B, S = X - αY (α 는 robust std 비, 예전과 같은 범위 제한)
+            for (size_t i = 0; i < n; ++i) {
+                tmp_x[i] = 3.0 * R[i] - 2.0 * G[i];
+                tmp_y[i] = 1.5 * R[i] + G[i] - 1.5 * B[i];
+            }
+            double std_y = robust_std(tmp_y, sc.robust);
+            if (std_y == 0) std_y = 1e-6;
+            double alpha = std::clamp(robust_std(tmp_x, sc.robust) / std_y, 0.3, 3.0);
+            return {3.0 - 1.5 * alpha, -2.0 - alpha, 1.5 * alpha};
+        }
+        case RppgMethod::GREEN:
+        default:
+            return {0.0, 1.0, 0.0};
+        }
+    }
 }
 
-double estimate_heart_rate_from_rgb(const std::vector<float>& r,
-                                    const std::vector<float>& g,
-                                    const std::vector<float>& b,
-                                    double fps) {
-    size_t n = r.size();
-    if (n < static_cast<size_t>(fps * 5)) return 0.0;
-
-    std::vector<std::vector<double>> rgb_data(n, std::vector<double>(3));
-    double r_mean = std::accumulate(r.begin(), r.end(), 0.0f) / r.size();
-    double g_mean = std::accumulate(g.begin(), g.end(), 0.0f) / g.size();
-    double b_mean = std::accumulate(b.begin(), b.end(), 0.0f) / b.size();
+RppgEstimate estimate_heart_rate_from_rgb(const std::vector<float>& r,
+                                          const std::vector<float>& g,
+                                          const std::vector<float>& b,
+                                          double fps,
+                                          RppgScratch& sc,
+                                          std::array<RppgEstimate, RPPG_METHOD_COUNT>* per_method) {
+    RppgEstimate best;
+    if (per_method) per_method->fill(RppgEstimate{});
 
-    for (size_t i = 0; i < n; ++i) {
-        rgb_data[i][0] = r[i] - r_mean;
-        rgb_data[i][1] = g[i] - g_mean;
-        rgb_data[i][2] = b[i] - b_mean;
+    size_t n = r.size();
+    if (fps <= 0.0 || n < static_cast<size_t>(fps * 5) || g.size() != n || b.size() != n) return best;
+
+    // 1. 공통 전처리: 정규화 + detrend + bandpass (채널당 한 번, sc.rgb 안에서)
+    auto& rgb = sc.rgb;
+    const std::vector<float>* channels[3] = {&r, &g, &b};
+    for (int c = 0; c < 3; ++c) {
+        normalize_detrend(*channels[c], rgb[c]);
+        butter_bandpass_filter(rgb[c], fps, HR_BAND_LOW, HR_BAND_HIGH, rgb[c]);
     }
 
-    std::vector<double> signal = pos_algorithm(rgb_data, fps);
-
-    // Remove mean
-    double mean = std::accumulate(signal.begin(), signal.end(), 0.0) / signal.size();
-    for (auto& v : signal) v -= mean;
-
-    // FFT
-    size_t len = signal.size();
-    std::vector<std::complex<double>> fft(len);
-    for (size_t k = 0; k < len; ++k) {
-        std::complex<double> sum = 0;
-        for (size_t n = 0; n < len; ++n) {
-            double angle = 2 * M_PI * k * n / len;
-            sum += std::polar(signal[n], -angle);
+    // 2. 공통 스펙트럼: 관심 대역 bin 만 채널별 DFT (방법별 스펙트럼은 이것의 선형 결합)
+    size_t k_lo = static_cast<size_t>(std::ceil(HR_BAND_LOW * n / fps));
+    size_t k_hi = std::min(static_cast<size_t>(std::floor(HR_BAND_HIGH * n / fps)), n / 2);
+    if (k_lo < 1) k_lo = 1;
+    if (k_hi < k_lo) return best;
+    size_t bins = k_hi - k_lo + 1;
+
+    auto& spectrum = sc.spectrum;
+    for (auto& sp : spectrum) sp.resize(bins);
+    for (size_t k = k_lo; k <= k_hi; ++k) {
+        const std::complex<double> step = std::polar(1.0, -2.0 * M_PI * k / n);
+        std::complex<double> w = 1.0;
+        std::complex<double> acc[3] = {};
+        for (size_t i = 0; i < n; ++i) {
+            acc[0] += rgb[0][i] * w;
+            acc[1] += rgb[1][i] * w;
+            acc[2] += rgb[2][i] * w;
+            w *= step;
         }
-        fft[k] = sum;
+        for (int c = 0; c < 3; ++c) spectrum[c][k - k_lo] = acc[c];
     }
 
-    std::vector<double> freqs(len / 2 + 1);
-    for (size_t i = 0; i < freqs.size(); ++i) {
-        freqs[i] = i * fps / len;
-    }
+    // 3. 방법별: 투영 계수 → 파워 스펙트럼 → peak + SNR
+    std::array<RppgEstimate, RPPG_METHOD_COUNT> estimates;
+    std::vector<double>& power = sc.power;
+    power.resize(bins);
+    for (int m = 0; m < RPPG_METHOD_COUNT; ++m) {
+        std::array<double, 3> coef = projection(static_cast<RppgMethod>(m), sc);
+
+        size_t peak = 0;
+        double total = 0.0;
+        for (size_t j = 0; j < bins; ++j) {
+            std::complex<double> s = coef[0] * spectrum[0][j] + coef[1] * spectrum[1][j] + coef[2] * spectrum[2][j];
+            power[j] = std::norm(s);
+            total += power[j];
+            if (power[j] > power[peak]) peak = j;
+        }
 
-    double max_val = 0.0;
-    double peak_freq = 0.0;
-    for (size_t i = 0; i < freqs.size(); ++i) {
-        if (freqs[i] >= 0.7 && freqs[i] <= 4.0) {
-            double magnitude = std::abs(fft[i]);
-            if (magnitude > max_val) {
-                max_val = magnitude;
-                peak_freq = freqs[i];
+        // 기본 주파수 ±1 bin 과 (대역 안이면) 2배음 ±1 bin 을 신호로
+        double signal = 0.0;
+        size_t k_peak = peak + k_lo;
+        for (size_t k : {k_peak, 2 * k_peak}) {
+            for (size_t kk = (k > k_lo ? k - 1 : k_lo); kk <= std::min(k + 1, k_hi); ++kk) {
+                if (kk < k_lo || kk > k_hi) continue;
+                if (k == 2 * k_peak && kk <= k_peak + 1) continue;   // 기본 주파수와 겹치면 한 번만
+                signal += power[kk - k_lo];
             }
         }
+        double noise = total - signal;
+
+        RppgEstimate est;
+        est.method = m;
+        est.bpm = std::round(k_peak * fps / n * 60.0 * 10.0) / 10.0;   // BPM with 0.1 precision
+        est.snr_db = (signal > 0.0 && noise > 0.0) ? 10.0 * std::log10(signal / noise)
+                   : (signal > 0.0 ? 99.0 : -99.0);
+        estimates[m] = est;
     }
-
-    return round(peak_freq * 60.0 * 10.0) / 10.0; // BPM with 0.1 precision
+    if (per_method) *per_method = estimates;
+
+    // 4. 선택: 다른 방법 하나 이상과 (1.5 bin 안에서) 같은 주파수를 낸 것 중 SNR 최대.
+    //    조명 깜빡임 같은 주기적 artifact 는 GREEN 에서 SNR 이 높게 나오지만 POS / CHROM 은 상쇄하므로
+    //    일치하는 게 없으면 조명에 강한 POS / CHROM 중에서 고른다
+    const double agree_bpm = 1.5 * fps / n * 60.0;
+    for (int m = 0; m < RPPG_METHOD_COUNT; ++m) {
+        bool agrees = false;
+        for (int o = 0; o < RPPG_METHOD_COUNT; ++o) {
+            if (o != m && std::abs(estimates[o].bpm - estimates[m].bpm) <= agree_bpm) agrees = true;
+        }
+        if (agrees && (best.method < 0 || estimates[m].snr_db > best.snr_db)) best = estimates[m];
+    }
+    if (best.method < 0) {
+        const RppgEstimate& pos = estimates[static_cast<int>(RppgMethod::POS)];
+        const RppgEstimate& chrom = estimates[static_cast<int>(RppgMethod::CHROM)];
+        best = pos.snr_db >= chrom.snr_db ? pos : chrom;
+    }
+    return best;
 }
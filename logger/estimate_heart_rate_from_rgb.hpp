@@ -1,7 +1,55 @@
 #pragma once
+#include <array>
+#include <complex>
+#include <cstddef>
 #include <vector>
 
-double estimate_heart_rate_from_rgb(const std::vector<float>& r,
-                                    const std::vector<float>& g,
-                                    const std::vector<float>& b,
-                                    double fps);
+// rPPG 펄스 추출 방법 (summary 의 hr_method 값)
+enum class RppgMethod : int {
+    POS = 0,     // Wang 2017, plane-orthogonal-to-skin
+    CHROM = 1,   // de Haan 2013, chrominance (예전 pos_algorithm 의 투영)
+    GREEN = 2    // 정규화된 G 채널
+};
+constexpr int RPPG_METHOD_COUNT = 3;
+
+struct RppgEstimate {
+    double bpm = 0.0;        // 0 = 추정 실패 (샘플 부족)
+    double snr_db = -99.0;   // bandpass 통과대역 (0.7~4Hz) 안에서 (기본 주파수 + 2배음 주변) / 나머지 에너지
+    int method = -1;         // RppgMethod
+};
+
+// estimate_heart_rate_from_rgb 의 중간 버퍼. 호출하는 쪽이 들고 재사용하면 (summary 는 스레드별 FeatureScratch)
+// 창 길이가 reserve 한 크기를 넘지 않는 한 추정이 할당하지 않는다
+struct RppgScratch {
+    std::array<std::vector<double>, 3> rgb;                    // 정규화 + detrend + bandpass 된 채널
+    std::array<std::vector<std::complex<double>>, 3> spectrum; // 관심 대역 bin 만
+    std::vector<double> tmp_x, tmp_y, power;
+    std::vector<double> robust;                                // robust_std 의 중앙값 / MAD 계산용
+
+    void reserve(size_t max_samples) {
+        for (auto& v : rgb) v.reserve(max_samples);
+        for (auto& v : spectrum) v.reserve(max_samples / 2 + 1);
+        tmp_x.reserve(max_samples);
+        tmp_y.reserve(max_samples);
+        power.reserve(max_samples / 2 + 1);
+        robust.reserve(max_samples);
+    }
+};
+
+// Butterworth bandpass (2차 HP → 2차 LP) 결과를 out 에 (out 이 signal 과 같아도 됨).
+// 차단 주파수가 맞지 않거나 샘플이 5개 미만이면 signal 을 그대로 복사
+void butter_bandpass_filter(const std::vector<double>& signal, double fs, double lowcut, double highcut,
+                            std::vector<double>& out);
+
+// 1.4826 × MAD. scratch 는 계산용 (data 와 같은 길이로 덮어씀)
+double robust_std(const std::vector<double>& data, std::vector<double>& scratch);
+
+// 세 방법을 같은 RGB 창에서 돌리고, 다른 방법과 주파수가 일치하는 것 중 SNR 이 가장 높은 추정치를 반환.
+// 정규화 / detrend / bandpass / DFT 는 RGB 채널에 한 번만 하고, 방법별로는 채널 스펙트럼의 선형 결합만 한다.
+// per_method 를 주면 방법별 결과도 채운다.
+RppgEstimate estimate_heart_rate_from_rgb(const std::vector<float>& r,
+                                          const std::vector<float>& g,
+                                          const std::vector<float>& b,
+                                          double fps,
+                                          RppgScratch& scratch,
+                                          std::array<RppgEstimate, RPPG_METHOD_COUNT>* per_method = nullptr);
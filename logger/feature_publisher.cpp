@@ -0,0 +1,322 @@
+#include "feature_publisher.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+FeaturePublisher feature_publisher;
+
+namespace {
+    constexpr int MAX_EVENTS = 16;
+    constexpr size_t HEADER_BYTES = 16;
+
+    void write_header(char* out, uint32_t len, uint16_t topic, double timestamp) {
+        const uint16_t reserved = 0;
+        std::memcpy(out, &len, 4);
+        std::memcpy(out + 4, &topic, 2);
+        std::memcpy(out + 6, &reserved, 2);
+        std::memcpy(out + 8, &timestamp, 8);
+    }
+
+    // SUMMARY 프레임 컬럼 (timestamp 제외한 summary_headers)
+    std::string schema_text() {
+        std::string text = "summary:";
+        for (size_t i = 1; i < summary_headers.size(); ++i) {
+            if (i > 1) text += ",";
+            text += summary_headers[i];
+        }
+        return text;
+    }
+}
+
+FeaturePublisher::~FeaturePublisher() {
+    for (const auto& [fd, sub] : subscribers_) close(fd);
+    if (epoll_fd_ >= 0) close(epoll_fd_);
+    if (server_fd_ >= 0) {
+        close(server_fd_);
+        unlink(path_.c_str());
+    }
+}
+
+bool FeaturePublisher::open(const std::string& path) {
+    struct sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "[PubSub] Socket path too long: " << path << std::endl;
+        return false;
+    }
+
+    server_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (server_fd_ < 0) {
+        std::cerr << "[PubSub] socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    unlink(path.c_str());   // 지난 실행이 남긴 소켓 파일
+
+    if (bind(server_fd_, (struct sockaddr*)&address, sizeof(address)) < 0 ||
+        listen(server_fd_, SOMAXCONN) < 0) {
+        std::cerr << "[PubSub] Failed to listen on " << path << ": " << std::strerror(errno) << std::endl;
+        close(server_fd_);
+        server_fd_ = -1;
+        return false;
+    }
+    path_ = path;
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        std::cerr << "[PubSub] epoll_create1 failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = server_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, server_fd_, &ev);
+
+    std::cout << "[PubSub] Publishing live features on " << path << std::endl;
+    return true;
+}
+
+bool FeaturePublisher::poll(int timeout_ms) {
+    struct epoll_event events[MAX_EVENTS];
+    int n = epoll_wait(epoll_fd_, events, MAX_EVENTS, timeout_ms);
+    if (n < 0) {
+        if (errno == EINTR) return true;
+        std::cerr << "[PubSub] epoll_wait failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < n; ++i) {
+        int fd = events[i].data.fd;
+
+        if (fd == server_fd_) {
+            accept_all();
+            continue;
+        }
+
+        auto it = subscribers_.find(fd);
+        if (it == subscribers_.end()) continue;
+        Subscriber& sub = it->second;
+
+        if (events[i].events & EPOLLIN) read_mask(sub);
+        if (!sub.dead && (events[i].events & EPOLLOUT)) {
+            flush(sub);
+            notify_dropped(sub);   // 다 보냈으면 버린 개수를 바로 알려준다
+        }
+        if (sub.dead || (events[i].events & (EPOLLERR | EPOLLHUP))) close_subscriber(fd);
+    }
+    update_topic_mask();
+    return true;
+}
+
+void FeaturePublisher::accept_all() {
+    while (true) {
+        int client_fd = accept4(server_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_fd < 0) break;   // EAGAIN: 더 없음
+
+        if (subscribers_.size() >= MAX_SUBSCRIBERS) {
+            std::cerr << "[PubSub] Too many subscribers, rejecting fd " << client_fd << std::endl;
+            close(client_fd);
+            continue;
+        }
+
+        struct epoll_event cev{};
+        cev.events = EPOLLIN | EPOLLRDHUP;
+        cev.data.fd = client_fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, client_fd, &cev) < 0) {
+            close(client_fd);
+            continue;
+        }
+        Subscriber& sub = subscribers_[client_fd];
+        sub.fd = client_fd;
+        sub.pending.reserve(MAX_PENDING_BYTES);   // publish 하는 센서 스레드가 나중에 키우지 않도록
+
+        // 새 구독자는 컬럼 목록부터
+        static const std::string schema = schema_text();
+        begin_frame(TOPIC_SCHEMA, 0.0);
+        buffer_.append(schema);
+        end_frame();
+        enqueue(sub, buffer_.data(), buffer_.size());
+
+        std::cout << "[PubSub] Subscriber connected (fd " << client_fd << ", "
+                  << subscribers_.size() << " subscribers)." << std::endl;
+    }
+}
+
+void FeaturePublisher::read_mask(Subscriber& sub) {
+    uint8_t temp[64];
+    while (true) {
+        ssize_t bytes_read = read(sub.fd, temp, sizeof(temp));
+        if (bytes_read == 0) {
+            sub.dead = true;   // 구독자가 닫음
+            return;
+        }
+        if (bytes_read < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) sub.dead = true;
+            return;
+        }
+        // 4바이트씩 끊어서 마지막 마스크가 이긴다
+        for (ssize_t i = 0; i < bytes_read; ++i) {
+            sub.mask_bytes[sub.mask_len++] = temp[i];
+            if (sub.mask_len == sizeof(sub.mask_bytes)) {
+                std::memcpy(&sub.mask, sub.mask_bytes, sizeof(sub.mask));
+                sub.mask_len = 0;
+            }
+        }
+    }
+}
+
+void FeaturePublisher::close_subscriber(int fd) {
+    auto it = subscribers_.find(fd);
+    if (it == subscribers_.end()) return;
+    uint64_t dropped = it->second.dropped_total;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    subscribers_.erase(it);
+    std::cout << "[PubSub] Subscriber disconnected (fd " << fd << ", " << dropped << " frames dropped)." << std::endl;
+}
+
+void FeaturePublisher::update_topic_mask() {
+    uint32_t mask = 0;
+    for (const auto& [fd, sub] : subscribers_) {
+        if (!sub.dead) mask |= sub.mask;
+    }
+    topic_mask_.store(mask, std::memory_order_relaxed);
+}
+
+void FeaturePublisher::set_writing(Subscriber& sub, bool writing) {
+    if (sub.writing == writing) return;
+    struct epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLRDHUP | (writing ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    ev.data.fd = sub.fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, sub.fd, &ev);
+    sub.writing = writing;
+}
+
+bool FeaturePublisher::enqueue(Subscriber& sub, const char* data, size_t len) {
+    if (sub.dead) return true;
+    if (sub.pending.size() + len > MAX_PENDING_BYTES) return false;
+
+    size_t sent = 0;
+    if (sub.pending.empty()) {
+        ssize_t n = send(sub.fd, data, len, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            sub.dead = true;   // 끊김: epoll 이 HUP 을 알려주면 poll 에서 닫힌다
+            return true;
+        }
+        if (n > 0) sent = static_cast<size_t>(n);
+    }
+    if (sent < len) {
+        // 잘린 프레임도 나머지는 반드시 보내야 스트림이 안 깨진다 (상한 검사는 위에서 프레임 전체로)
+        sub.pending.append(data + sent, len - sent);
+        set_writing(sub, true);
+    }
+    return true;
+}
+
+void FeaturePublisher::notify_dropped(Subscriber& sub) {
+    if (sub.dropped == 0) return;
+    char notice[HEADER_BYTES + sizeof(uint64_t)];
+    write_header(notice, sizeof(uint64_t), TOPIC_DROPPED, 0.0);
+    std::memcpy(notice + HEADER_BYTES, &sub.dropped, sizeof(uint64_t));
+    if (enqueue(sub, notice, sizeof(notice))) sub.dropped = 0;
+}
+
+void FeaturePublisher::flush(Subscriber& sub) {
+    while (!sub.pending.empty()) {
+        ssize_t n = send(sub.fd, sub.pending.data(), sub.pending.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) sub.dead = true;
+            return;
+        }
+        sub.pending.erase(0, static_cast<size_t>(n));
+    }
+    set_writing(sub, false);
+}
+
+void FeaturePublisher::begin_frame(Topic topic, double timestamp) {
+    buffer_.resize(HEADER_BYTES);
+    write_header(&buffer_[0], 0, topic, timestamp);   // 길이는 end_frame 에서
+}
+
+void FeaturePublisher::end_frame() {
+    uint32_t len = static_cast<uint32_t>(buffer_.size() - HEADER_BYTES);
+    std::memcpy(&buffer_[0], &len, sizeof(len));
+}
+
+template <typename T>
+void FeaturePublisher::put(const T& value) {
+    buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void FeaturePublisher::broadcast(Topic topic) {
+    end_frame();
+
+    for (auto& [fd, sub] : subscribers_) {
+        if (!((sub.mask >> topic) & 1u)) continue;
+
+        notify_dropped(sub);
+        if (!enqueue(sub, buffer_.data(), buffer_.size())) {
+            ++sub.dropped;
+            ++sub.dropped_total;
+        }
+    }
+}
+
+void FeaturePublisher::publish_summary(double timestamp, const SummaryRow& row) {
+    if (!wants(TOPIC_SUMMARY)) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    begin_frame(TOPIC_SUMMARY, timestamp);
+    for (int c = COL_TIMESTAMP + 1; c < SUMMARY_COLUMN_COUNT; ++c) put<float>(static_cast<float>(row[c]));
+    broadcast(TOPIC_SUMMARY);
+}
+
+void FeaturePublisher::publish(const ImuData& imu) {
+    if (!wants(TOPIC_IMU)) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    begin_frame(TOPIC_IMU, imu.source_timestamp);
+    for (float v : imu.accel) put<float>(v);
+    for (float v : imu.gyro) put<float>(v);
+    for (float v : imu.accel_wf) put<float>(v);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    put<float>(imu.fused_valid ? imu.fused_speed : nan);
+    put<float>(imu.fused_heading_valid ? imu.fused_heading : nan);
+    put<float>(imu.fused_valid ? imu.fused_long_acc : nan);
+    put<float>(imu.fused_valid ? imu.fused_lat_acc : nan);
+    broadcast(TOPIC_IMU);
+}
+
+void FeaturePublisher::publish(const GpsData& gps) {
+    if (!wants(TOPIC_GPS)) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    begin_frame(TOPIC_GPS, gps.source_timestamp);
+    put<double>(gps.lat);
+    put<double>(gps.lon);
+    put<float>(static_cast<float>(gps.speed));
+    put<float>(static_cast<float>(gps.heading));
+    put<float>(static_cast<float>(gps.long_acc));
+    put<float>(static_cast<float>(gps.lat_acc));
+    broadcast(TOPIC_GPS);
+}
+
+void FeaturePublisher::publish(const FaceData& face) {
+    if (!wants(TOPIC_FACE)) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    begin_frame(TOPIC_FACE, face.source_timestamp);
+    put<uint8_t>(static_cast<uint8_t>(face.source_id));
+    put<uint8_t>(face.has_head_pose ? 1 : 0);
+    put<uint16_t>(0);
+    for (float v : face.avg_rgb) put<float>(face.has_rgb ? v : std::numeric_limits<float>::quiet_NaN());
+    for (double q : face.head_quat) put<float>(static_cast<float>(q));
+    broadcast(TOPIC_FACE);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../include/shared_structs.hpp"
+#include "../features/summary_features.hpp"
+
+// 같은 PC 의 다른 프로세스에 summary 행 / 원시 샘플을 실시간으로 보내는 Unix domain socket pub/sub.
+//
+// 프레임 (little-endian, 패딩 없음):
+//   u32 payload 길이, u16 topic, u16 0, f64 timestamp(epoch 초), payload
+//   SCHEMA  : 연결 직후 한 번. "summary:" + summary 컬럼명(timestamp 제외) 콤마 구분
+//   SUMMARY : f32 × 컬럼 수 (SCHEMA 순서)
+//   IMU     : f32 accel[3], gyro[3], accel_wf[3]; fused speed, heading, long_acc, lat_acc (GPS 융합 전이면 NaN)
+//   GPS     : f64 lat, lon; f32 speed, heading, long_acc, lat_acc
+//   FACE    : u8 source_id, u8 has_head_pose, u16 0; f32 rgb[3], head_quat[4] (w,x,y,z)
+//   DROPPED : u64 이 구독자에게 못 보내고 버린 프레임 수 (지난 DROPPED 이후)
+//
+// 구독자는 언제든 u32 topic 비트마스크 (1 << topic) 를 써서 받을 topic 을 고른다. 처음엔 SUMMARY 만.
+// 구독자마다 보낼 버퍼는 MAX_PENDING_BYTES 까지이고, 넘치면 프레임을 버리고 센다 → 느린 구독자가
+// publish 하는 쪽(센서 / summary 스레드)을 막는 일은 없다.
+// fd() 는 내부 epoll fd 라서 FaceServer 처럼 바깥 이벤트 루프에 그대로 등록할 수 있다.
+class FeaturePublisher {
+public:
+    enum Topic : uint16_t {
+        TOPIC_SCHEMA = 0,
+        TOPIC_SUMMARY = 1,
+        TOPIC_IMU = 2,
+        TOPIC_GPS = 3,
+        TOPIC_FACE = 4,
+        TOPIC_DROPPED = 15,
+    };
+
+    static constexpr size_t MAX_PENDING_BYTES = 256 * 1024;
+    static constexpr size_t MAX_SUBSCRIBERS = 16;
+
+    FeaturePublisher() = default;
+    ~FeaturePublisher();
+
+    FeaturePublisher(const FeaturePublisher&) = delete;
+    FeaturePublisher& operator=(const FeaturePublisher&) = delete;
+
+    // path 에 listen (남아있던 소켓 파일은 지운다)
+    bool open(const std::string& path);
+    int fd() const { return epoll_fd_; }
+
+    // 연결 / 구독 변경 / 밀린 전송 처리 (최대 timeout_ms 대기). epoll 오류면 false
+    bool poll(int timeout_ms);
+
+    // 이 topic 을 받는 구독자가 있는지 (직렬화 전에 확인하는 빠른 경로, 락 없음)
+    bool wants(Topic topic) const {
+        return (topic_mask_.load(std::memory_order_relaxed) >> topic) & 1u;
+    }
+
+    void publish_summary(double timestamp, const SummaryRow& row);
+    void publish(const ImuData& imu);
+    void publish(const GpsData& gps);
+    void publish(const FaceData& face);
+
+private:
+    struct Subscriber {
+        int fd = -1;
+        uint32_t mask = 1u << TOPIC_SUMMARY;
+        uint8_t mask_bytes[4] = {};
+        size_t mask_len = 0;          // 받는 중인 마스크 바이트 수
+        std::string pending;          // 소켓에 못 쓴 나머지 (프레임 단위로 MAX_PENDING_BYTES 까지)
+        bool writing = false;         // EPOLLOUT 등록됨
+        bool dead = false;            // 쓰기 오류. 다음 poll 에서 닫음
+        uint64_t dropped = 0;         // 아직 알리지 않은 버린 프레임 수
+        uint64_t dropped_total = 0;
+    };
+
+    // buffer_ 에 담긴 프레임을 topic 구독자들에게 (mutex_ 잡은 상태)
+    void broadcast(Topic topic);
+    void begin_frame(Topic topic, double timestamp);
+    void end_frame();   // 헤더에 payload 길이 기록
+    template <typename T>
+    void put(const T& value);
+
+    // 프레임 하나를 보내거나 pending 에 넣는다. 자리가 없으면 false (버림)
+    bool enqueue(Subscriber& sub, const char* data, size_t len);
+    void flush(Subscriber& sub);
+    // 버린 프레임이 있으면 DROPPED 프레임을 넣는다 (자리가 있을 때)
+    void notify_dropped(Subscriber& sub);
+    void set_writing(Subscriber& sub, bool writing);
+    void accept_all();
+    void read_mask(Subscriber& sub);
+    void close_subscriber(int fd);
+    void update_topic_mask();
+
+    int server_fd_ = -1;
+    int epoll_fd_ = -1;
+    std::string path_;
+
+    std::mutex mutex_;   // publish 하는 스레드들 ↔ poll
+    std::unordered_map<int, Subscriber> subscribers_;
+    std::atomic<uint32_t> topic_mask_{0};
+    std::string buffer_;   // 직렬화 scratch (재사용)
+};
+
+extern FeaturePublisher feature_publisher;
@@ -0,0 +1,60 @@
+#include "run_stats.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+namespace {
+    double now_seconds() {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    double tv_seconds(const struct timeval& tv) {
+        return tv.tv_sec + tv.tv_usec * 1e-6;
+    }
+
+    int thread_count() {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind("Threads:", 0) == 0) return std::stoi(line.substr(8));
+        }
+        return 0;
+    }
+}
+
+RunStats::RunStats(std::string mode) : mode_(std::move(mode)) {
+    last_wall_ = now_seconds();
+    getrusage(RUSAGE_SELF, &last_usage_);
+}
+
+void RunStats::report(uint64_t loop_wakeups) {
+    struct rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    double wall = now_seconds();
+    double dt = wall - last_wall_;
+    if (dt <= 0.0) return;
+
+    double user = (tv_seconds(usage.ru_utime) - tv_seconds(last_usage_.ru_utime)) / dt * 100.0;
+    double sys = (tv_seconds(usage.ru_stime) - tv_seconds(last_usage_.ru_stime)) / dt * 100.0;
+    double vol = (usage.ru_nvcsw - last_usage_.ru_nvcsw) / dt;
+    double invol = (usage.ru_nivcsw - last_usage_.ru_nivcsw) / dt;
+
+    char buf[256];
+    std::snprintf(buf, sizeof(buf),
+                  "[Stats] %s: cpu %.1f%% (user %.1f, sys %.1f), ctx switches %.1f/s (vol %.1f, invol %.1f), threads %d",
+                  mode_.c_str(), user + sys, user, sys, vol + invol, vol, invol, thread_count());
+    std::cout << buf;
+    if (loop_wakeups > 0) {
+        std::snprintf(buf, sizeof(buf), ", loop wakeups %.1f/s", (loop_wakeups - last_wakeups_) / dt);
+        std::cout << buf;
+    }
+    std::cout << std::endl;
+
+    last_wall_ = wall;
+    last_usage_ = usage;
+    last_wakeups_ = loop_wakeups;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <sys/resource.h>
+
+// --stats: 프로세스 전체 CPU 사용률과 context switch(≈ wakeup) 를 구간별로 출력.
+// 스레드 모드 / 이벤트 루프 모드 비교용
+class RunStats {
+public:
+    explicit RunStats(std::string mode);
+
+    // 이전 report 이후 구간의 값을 한 줄로 출력. loop_wakeups 는 이벤트 루프 누적값 (스레드 모드는 0)
+    void report(uint64_t loop_wakeups = 0);
+
+private:
+    std::string mode_;
+    double last_wall_ = 0.0;
+    struct rusage last_usage_{};
+    uint64_t last_wakeups_ = 0;
+};
@@ -0,0 +1,61 @@
+#include "sample_query.hpp"
+
+#include <limits>
+
+#include "../sensors/face_line_parser.hpp"
+
+void SampleTable<FaceData>::read(sqlite3_stmt* stmt, FaceData& f) {
+    f.source_timestamp = sqlite3_column_double(stmt, 0);
+    f.avg_rgb = {
+        static_cast<float>(sqlite3_column_double(stmt, 1)),
+        static_cast<float>(sqlite3_column_double(stmt, 2)),
+        static_cast<float>(sqlite3_column_double(stmt, 3))
+    };
+    f.has_rgb = sqlite3_column_type(stmt, 1) != SQLITE_NULL;
+    f.source_id = sqlite3_column_int(stmt, 5);
+
+    // blendshapes 는 JSON 텍스트. json 트리 없이 sqlite 버퍼에서 바로 읽는다 (행마다 할당 없음)
+    f.blendshapes = no_blendshapes();
+    const char* bs = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
+    if (bs && !parse_blendshape_object(bs, bs + sqlite3_column_bytes(stmt, 4), f.blendshapes)) {
+        f.blendshapes = no_blendshapes();   // 깨진 텍스트는 전부 NaN (예전과 같음)
+    }
+}
+
+void SampleTable<ImuData>::read(sqlite3_stmt* stmt, ImuData& s) {
+    s.source_timestamp = sqlite3_column_double(stmt, 0);
+    s.accel = {
+        static_cast<float>(sqlite3_column_double(stmt, 1)),
+        static_cast<float>(sqlite3_column_double(stmt, 2)),
+        static_cast<float>(sqlite3_column_double(stmt, 3))
+    };
+    s.gyro = {
+        static_cast<float>(sqlite3_column_double(stmt, 4)),
+        static_cast<float>(sqlite3_column_double(stmt, 5)),
+        static_cast<float>(sqlite3_column_double(stmt, 6))
+    };
+}
+
+void SampleTable<GpsData>::read(sqlite3_stmt* stmt, GpsData& g) {
+    g.source_timestamp = sqlite3_column_double(stmt, 0);
+    g.lat = sqlite3_column_double(stmt, 1);
+    g.lon = sqlite3_column_double(stmt, 2);
+    g.speed = sqlite3_column_double(stmt, 3);
+}
+
+void SampleTable<CanData>::read(sqlite3_stmt* stmt, CanData& c) {
+    c.source_timestamp = sqlite3_column_double(stmt, 0);
+    float* values[] = {&c.speed, &c.steer_angle, &c.steer_rate, &c.accel_pedal, &c.brake_pressure};
+    for (int i = 0; i < 5; ++i) {
+        *values[i] = sqlite3_column_type(stmt, 1 + i) == SQLITE_NULL
+            ? std::numeric_limits<float>::quiet_NaN()
+            : static_cast<float>(sqlite3_column_double(stmt, 1 + i));
+    }
+}
+
+void SampleTable<ToggleEvent>::read(sqlite3_stmt* stmt, ToggleEvent& ev) {
+    ev.timestamp = sqlite3_column_double(stmt, 0);
+    ev.monotonic = sqlite3_column_double(stmt, 1);
+    ev.button = sqlite3_column_int(stmt, 2);
+    ev.state = sqlite3_column_int(stmt, 3);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <sqlite3.h>
+#include <iostream>
+#include <iterator>
+
+#include "../include/shared_structs.hpp"
+
+// 센서 타입 → 테이블 / 컬럼 매핑. read() 는 현재 행을 기존 객체에 덮어쓴다 (벡터/맵 용량 재사용)
+template <typename T>
+struct SampleTable;
+
+template <>
+struct SampleTable<FaceData> {
+    static constexpr const char* select_sql =
+        "SELECT timestamp, r, g, b, blendshapes, source_id FROM face_data "
+        "WHERE timestamp >= ?1 AND timestamp <= ?2 ORDER BY timestamp;";
+    static void read(sqlite3_stmt* stmt, FaceData& f);
+};
+
+template <>
+struct SampleTable<ImuData> {
+    static constexpr const char* select_sql =
+        "SELECT timestamp, ax, ay, az, gx, gy, gz FROM imu_data "
+        "WHERE timestamp >= ?1 AND timestamp <= ?2 ORDER BY timestamp;";
+    static void read(sqlite3_stmt* stmt, ImuData& s);
+};
+
+template <>
+struct SampleTable<GpsData> {
+    static constexpr const char* select_sql =
+        "SELECT timestamp, lat, lon, speed FROM gps_data "
+        "WHERE timestamp >= ?1 AND timestamp <= ?2 ORDER BY timestamp;";
+    static void read(sqlite3_stmt* stmt, GpsData& g);
+};
+
+template <>
+struct SampleTable<CanData> {
+    static constexpr const char* select_sql =
+        "SELECT timestamp, speed, steer_angle, steer_rate, accel_pedal, brake_pressure FROM can_data "
+        "WHERE timestamp >= ?1 AND timestamp <= ?2 ORDER BY timestamp;";
+    static void read(sqlite3_stmt* stmt, CanData& c);   // NULL → NaN
+};
+
+template <>
+struct SampleTable<ToggleEvent> {
+    static constexpr const char* select_sql =
+        "SELECT timestamp, monotonic, button, state FROM toggle_events "
+        "WHERE timestamp >= ?1 AND timestamp <= ?2 ORDER BY timestamp;";
+    static void read(sqlite3_stmt* stmt, ToggleEvent& ev);
+};
+
+// t0 <= timestamp <= t1 구간을 prepared statement 하나로 한 줄씩 읽는다 (전체를 메모리에 올리지 않음).
+// 한 번만 지나갈 수 있고, 역참조 값은 다음 ++ 에서 덮어써진다.
+//
+//   for (const ImuData& s : db_logger.query<ImuData>(now - 30.0, now)) { ... }
+template <typename T>
+class SampleQuery {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        iterator() = default;   // end
+        explicit iterator(SampleQuery* query) : query_(query) { ++*this; }
+
+        reference operator*() const { return query_->current_; }
+        pointer operator->() const { return &query_->current_; }
+        iterator& operator++() {
+            if (!query_->step()) query_ = nullptr;
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return query_ == other.query_; }
+        bool operator!=(const iterator& other) const { return query_ != other.query_; }
+
+    private:
+        SampleQuery* query_ = nullptr;
+    };
+
+    // sql 은 SampleTable<T>::read 와 같은 컬럼 순서여야 한다 (예전 스키마용 대체 쿼리)
+    SampleQuery(sqlite3* db, double t0, double t1, const char* sql = SampleTable<T>::select_sql) {
+        if (!db || sqlite3_prepare_v2(db, sql, -1, &stmt_, nullptr) != SQLITE_OK) {
+            if (db) std::cerr << "[DB] Query prepare failed: " << sqlite3_errmsg(db) << std::endl;
+            sqlite3_finalize(stmt_);
+            stmt_ = nullptr;
+            return;
+        }
+        sqlite3_bind_double(stmt_, 1, t0);
+        sqlite3_bind_double(stmt_, 2, t1);
+    }
+    ~SampleQuery() { sqlite3_finalize(stmt_); }
+
+    SampleQuery(const SampleQuery&) = delete;
+    SampleQuery& operator=(const SampleQuery&) = delete;
+
+    bool ok() const { return stmt_ != nullptr; }
+
+    iterator begin() { return stmt_ ? iterator(this) : iterator(); }
+    iterator end() { return iterator(); }
+
+private:
+    bool step() {
+        if (sqlite3_step(stmt_) != SQLITE_ROW) return false;
+        SampleTable<T>::read(stmt_, current_);
+        return true;
+    }
+
+    sqlite3_stmt* stmt_ = nullptr;
+    T current_{};
+};
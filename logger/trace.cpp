@@ -0,0 +1,179 @@
+#include "../include/trace.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if MOTIONSICK_TRACE
+
+std::atomic<bool> trace_active{false};
+
+namespace {
+    // 링 버퍼 한 칸. stamp = (쓴 순번 + 1), 쓰는 중이면 0 → 읽는 쪽이 전후 stamp 를 비교해서 찢어진 칸은 버린다
+    struct TraceSlot {
+        std::atomic<uint64_t> stamp{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<int64_t> start_ns{0};
+        std::atomic<int64_t> dur_ns{0};
+        std::atomic<uint64_t> seq_first{0};
+        std::atomic<uint64_t> seq_last{0};
+    };
+
+    struct TraceThreadBuffer {
+        int tid = 0;
+        const char* thread_name = nullptr;   // registry_mutex 로 보호
+        std::unique_ptr<TraceSlot[]> slots{new TraceSlot[TRACE_EVENTS_PER_THREAD]};
+        std::atomic<uint64_t> written{0};    // 이 스레드만 증가
+    };
+
+    std::mutex registry_mutex;
+    std::vector<std::unique_ptr<TraceThreadBuffer>> registry;   // 스레드가 끝나도 남김 (dump 용)
+
+    thread_local TraceThreadBuffer* local_buffer = nullptr;
+    thread_local const char* local_thread_name = nullptr;
+
+    const auto trace_epoch = std::chrono::steady_clock::now();
+
+    TraceThreadBuffer* thread_buffer() {
+        if (local_buffer) return local_buffer;
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.push_back(std::make_unique<TraceThreadBuffer>());
+        local_buffer = registry.back().get();
+        local_buffer->tid = static_cast<int>(registry.size());
+        local_buffer->thread_name = local_thread_name;
+        return local_buffer;
+    }
+
+    // JSON 문자열 (이름은 코드 안의 상수라 따옴표 / 역슬래시만 막는다)
+    void write_json_string(std::ostream& out, const char* s) {
+        out << '"';
+        for (; *s; ++s) {
+            if (*s == '"' || *s == '\\') out << '\\';
+            out << *s;
+        }
+        out << '"';
+    }
+}
+
+int64_t trace_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - trace_epoch).count();
+}
+
+int64_t trace_from_wall(double epoch_seconds) {
+    double wall_now = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    return trace_now_ns() - static_cast<int64_t>((wall_now - epoch_seconds) * 1e9);
+}
+
+void trace_record(const char* name, int64_t start_ns, int64_t end_ns, uint64_t seq_first, uint64_t seq_last) {
+    if (!trace_enabled()) return;
+    TraceThreadBuffer* buffer = thread_buffer();
+
+    uint64_t n = buffer->written.load(std::memory_order_relaxed);
+    TraceSlot& slot = buffer->slots[n % TRACE_EVENTS_PER_THREAD];
+    slot.stamp.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start_ns.store(start_ns, std::memory_order_relaxed);
+    slot.dur_ns.store(end_ns - start_ns, std::memory_order_relaxed);
+    slot.seq_first.store(seq_first, std::memory_order_relaxed);
+    slot.seq_last.store(seq_last, std::memory_order_relaxed);
+    slot.stamp.store(n + 1, std::memory_order_release);
+    buffer->written.store(n + 1, std::memory_order_release);
+}
+
+void trace_thread_name(const char* name) {
+    if (local_thread_name == name) return;   // 풀 작업마다 불려도 락 없이
+    local_thread_name = name;
+    if (local_buffer) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        local_buffer->thread_name = name;
+    }
+}
+
+void trace_start() {
+    trace_active.store(true, std::memory_order_relaxed);
+    std::cout << "[Trace] Recording spans (last " << TRACE_EVENTS_PER_THREAD << " per thread)." << std::endl;
+}
+
+bool trace_write_chrome_json(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "[Trace] Failed to open " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) out << ",\n";
+        first = false;
+    };
+
+    size_t events = 0;
+    char num[96];
+    for (const auto& buffer : registry) {
+        separator();
+        out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+        if (buffer->thread_name) {
+            write_json_string(out, buffer->thread_name);
+        } else {
+            out << "\"thread " << buffer->tid << "\"";
+        }
+        out << "}}";
+
+        uint64_t end = buffer->written.load(std::memory_order_acquire);
+        uint64_t begin = end > TRACE_EVENTS_PER_THREAD ? end - TRACE_EVENTS_PER_THREAD : 0;
+        for (uint64_t n = begin; n < end; ++n) {
+            const TraceSlot& slot = buffer->slots[n % TRACE_EVENTS_PER_THREAD];
+            if (slot.stamp.load(std::memory_order_acquire) != n + 1) continue;
+            const char* name = slot.name.load(std::memory_order_relaxed);
+            int64_t start_ns = slot.start_ns.load(std::memory_order_relaxed);
+            int64_t dur_ns = slot.dur_ns.load(std::memory_order_relaxed);
+            uint64_t seq_first = slot.seq_first.load(std::memory_order_relaxed);
+            uint64_t seq_last = slot.seq_last.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.stamp.load(std::memory_order_relaxed) != n + 1 || !name) continue;   // 읽는 중에 덮어쓰임
+
+            // 분류 = 이름의 '.' 앞부분
+            std::string category(name);
+            category = category.substr(0, category.find('.'));
+
+            separator();
+            out << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid << ",\"name\":";
+            write_json_string(out, name);
+            out << ",\"cat\":";
+            write_json_string(out, category.c_str());
+            std::snprintf(num, sizeof(num), ",\"ts\":%.3f,\"dur\":%.3f", start_ns / 1000.0, dur_ns / 1000.0);
+            out << num;
+            if (seq_first != 0 && seq_last != 0 && seq_last != seq_first) {
+                out << ",\"args\":{\"seq_first\":" << seq_first << ",\"seq_last\":" << seq_last << "}";
+            } else if (seq_first != 0) {
+                out << ",\"args\":{\"seq\":" << seq_first << "}";
+            }
+            out << "}";
+            ++events;
+        }
+    }
+    out << "\n]}\n";
+
+    std::cout << "[Trace] Wrote " << events << " spans from " << registry.size() << " threads to " << path << std::endl;
+    return out.good();
+}
+
+#else
+
+void trace_start() {
+    std::cerr << "[Trace] Built without MOTIONSICK_TRACING, --trace ignored." << std::endl;
+}
+
+bool trace_write_chrome_json(const std::string&) {
+    return false;
+}
+
+#endif
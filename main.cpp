@@ -4,37 +4,341 @@
 #include <iostream>
 #include <atomic>
 #include <QProcess>
-#include <fstream>    // for std::ifstream
-#include <csignal>    // for kill(), SIGTERM
-#include <unistd.h>   // for pid_t, kill()
+#include <cstring>
+#include <cstdlib>
+#include <future>
+#include <memory>
+#include <mutex>
 
 #include "ui/toggle_window.hpp"
 #include "include/shared_structs.hpp"
 #include "sensors/socket_receiver.hpp"
 #include "sensors/imu_thread.hpp"
 #include "sensors/gps_thread.hpp"
+#include "sensors/can_receiver.hpp"
+#include "sensors/imu_raw_ring.hpp"
 #include "sensors/threadsafe_queue.hpp" // 공유 큐
 #include "logger/database_logger.hpp"
 #include "logger/csv_logger.hpp"
+#include "features/msdv.hpp"
+#include "features/summary_pyramid.hpp"
+#include "sensors/event_loop.hpp"
+#include "sensors/idle_monitor.hpp"
+#include "logger/run_stats.hpp"
+#include "include/toggle_events.hpp"
+#include "sensors/process_supervisor.hpp"
+#include "logger/feature_publisher.hpp"
+#include "include/trace.hpp"
+#include "include/alloc_check.hpp"
+#include "sensors/sensor_registry.hpp"
 
+std::atomic<double> last_face_detected_time{0.0};  // 실제 정의
 
-extern std::vector<FaceData> face_buffer;
-extern std::mutex face_buffer_mutex;
-extern std::vector<ImuData> imu_buffer;
-extern std::mutex imu_buffer_mutex;
-extern std::vector<GpsData> gps_buffer;
-extern std::mutex gps_buffer_mutex;
-extern const int IMU_BUFFER_MAX_SIZE;
-extern const int FACE_BUFFER_MAX_SIZE;
+// 버퍼에 새로 들어온 샘플만 DB 에 기록 (1초마다)
+struct DbAggregator {
+    std::shared_future<std::shared_ptr<DatabaseLogger>> db_future;   // 백그라운드에서 열리는 중
+    std::chrono::steady_clock::time_point launch_time;
+    DatabaseLogger* db_logger = nullptr;                             // 열린 뒤부터 사용
+    std::array<double, Sensors::source_count> last_timestamp{};  // 센서 / source 별 마지막 기록 시각
+    uint64_t toggle_cursor = 0;
 
-std::atomic<double> last_face_detected_time{0.0};  // 실제 정의
+    uint64_t toggles_lost = 0;   // 읽기 전에 링에서 덮어쓰인 클릭 수
+
+    // tick 마다 재사용 (스냅샷은 채널 최대 크기로 잡혀 있고, 토글은 DB 가 열릴 때 잡는다)
+    std::vector<ToggleEvent> toggle_batch{};
+    Sensors::Snapshots snapshots{};
+
+    // DB 스레드의 tick 과 종료 시 main 스레드의 flush_toggles 가 겹치지 않도록
+    std::mutex mutex{};
+
+    // 이번 주기에 새로 들어온 구간 (시간순이라 뒤쪽 연속 구간) 만 기록
+    template <typename T>
+    void commit(const SensorSnapshot<T>& snapshot) {
+        for (int source = 0; source < T::sources; ++source) {
+            const auto& samples = snapshot[source];
+            double& last = last_timestamp[Sensors::first_source<T>() + source];
+            size_t first_new = samples.size();
+            for (size_t i = 0; i < samples.size(); ++i) {
+                if (samples[i].source_timestamp > last) {
+                    first_new = i;
+                    break;
+                }
+            }
+            SampleSpan<typename T::Sample> fresh(samples.data() + first_new, samples.size() - first_new);
+            if (fresh.empty()) continue;
+
+            TraceSpan span(T::db_span, fresh.front().seq, fresh.back().seq);
+            for (const auto& sample : fresh) db_logger->insert<T>(sample);
+            last = fresh.back().source_timestamp;
+            T::after_insert(*db_logger, fresh);
+        }
+    }
+
+    // DB 가 아직 열리는 중이면 false (센서 버퍼 / 토글 로그가 그동안 들고 있음)
+    bool db_ready() {
+        if (db_logger) return true;
+        if (db_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+        db_logger = db_future.get().get();
+        toggle_batch.reserve(ToggleEventLog::capacity);
+        std::cout << "[Startup] DB ready, recording " << std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - launch_time).count() << " ms after launch" << std::endl;
+        return true;
+    }
+
+    // 지난번 이후 토글 클릭을 기록 (mutex 를 잡은 상태에서)
+    void commit_toggles() {
+        uint64_t lost = 0;
+        toggle_batch.clear();
+        toggle_cursor = toggle_event_log.read_since(toggle_cursor, toggle_batch, &lost);
+        if (lost > 0) {
+            toggles_lost += lost;
+            std::cerr << "[Toggle] " << lost << " click(s) overwritten before DB write (total "
+                      << toggles_lost << ")" << std::endl;
+        }
+        if (!toggle_batch.empty()) {
+            TraceSpan span("db.commit_toggle");
+            db_logger->insertToggleEvents(toggle_batch);
+        }
+    }
+
+    // 종료 시 main 스레드에서: 마지막 tick 이후 클릭까지 기록
+    void flush_toggles() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (db_ready()) commit_toggles();
+    }
+
+    void tick() {
+        static SteadyStateLoop steady("db.tick", 10);
+        SteadyStateLoop::Iteration steady_iteration(steady);
+        std::lock_guard<std::mutex> lock(mutex);
+
+        double now = std::chrono::duration<double>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+
+        if (!db_ready()) return;
+
+        // 토글 클릭은 idle 여부와 상관없이 기록 (GUI 는 이벤트 로그에 쓰기만 하고 idle 이면 wake 로 깨운다)
+        commit_toggles();
+
+        if (idle_monitor.refresh(now)) {
+            return;  // 최근 얼굴 감지 이후 60초 경과 → 로깅 중단 (idle)
+        }
+
+        sensors.snapshot(snapshots);
+
+        // 이번 tick 의 insert 는 한 트랜잭션 (샘플마다 커밋하면 SD 카드에 저널 sync 가 샘플 수만큼)
+        db_logger->beginBatch();
+        Sensors::for_each(snapshots, [this](const auto& snapshot) { commit(snapshot); });
+        db_logger->commitBatch();
+    }
+};
+
+// --reactor 의 1초 DB / summary tick. DB 트랜잭션과 summary 작업 대기 (최대 TICK_DEADLINE_SEC) 가 블록하므로
+// epoll 스레드가 아니라 이 스레드에서 (루프에서 돌리면 그동안 IMU 타이머 주기가 밀려서 샘플이 빠짐)
+void run_summary_ticks(std::atomic<bool>& running, DbAggregator& aggregator, SummaryCsvLogger& csv_logger, bool print_stats) {
+    trace_thread_name("summary");
+    auto next_tick = std::chrono::steady_clock::now();
+    auto next_report = next_tick + std::chrono::seconds(10);
+    while (running) {
+        aggregator.tick();
+        csv_logger.tick();
+
+        if (print_stats && std::chrono::steady_clock::now() >= next_report) {
+            csv_logger.report_timings();
+            next_report = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        }
+
+        // idle 이면 얼굴이 돌아오거나 토글이 눌릴 때까지 잠든다 (스레드 모드의 DB 스레드와 같음)
+        if (idle_monitor.idle()) {
+            if (!idle_monitor.wait_until_active_or_woken()) break;
+            next_tick = std::chrono::steady_clock::now();
+        } else {
+            next_tick += std::chrono::seconds(1);
+            auto now = std::chrono::steady_clock::now();
+            if (next_tick < now) next_tick = now;
+            std::this_thread::sleep_until(next_tick);
+        }
+    }
+}
+
+// --reactor: 얼굴 소켓, GPS 시리얼, CAN 소켓, IMU 타이머(100Hz) 를 epoll 스레드 하나에서 처리 (1초 tick 은 run_summary_ticks)
+void run_reactor(std::atomic<bool>& running, DbAggregator& aggregator,
+                 SummaryCsvLogger& csv_logger, bool print_stats, const std::string& can_interface) {
+    EventLoop loop;
+    if (!loop.ok()) return;
+
+    GpsKinematics gps_kinematics;
+    std::string gps_partial;
+    gps_partial.reserve(GPS_PARTIAL_RESERVE);
+    if (open_gps_serial()) {
+        loop.add_fd(gps_fd, [&]() {
+            if (!gps_read_available(gps_partial, gps_kinematics)) {
+                std::cerr << "[Reactor] GPS read failed, removing serial port." << std::endl;
+                loop.remove_fd(gps_fd);
+                gps_close_serial();
+            }
+        });
+    } else {
+        std::cerr << "[Reactor] Failed to open GPS serial port." << std::endl;
+    }
+
+    CanReceiver can_receiver;
+    if (!can_interface.empty() && can_receiver.open(can_interface)) {
+        loop.add_fd(can_receiver.fd(), [&]() {
+            if (!can_receiver.read_available()) {
+                std::cerr << "[Reactor] CAN read failed, removing " << can_interface << "." << std::endl;
+                loop.remove_fd(can_receiver.fd());
+                can_receiver.close();
+            }
+        });
+    }
+
+    // IMU 타이머는 idle 동안 꺼둔다 (timerfd disarm → wakeup 없음)
+    MsdvAccumulator msdv(IMU_SAMPLE_RATE_HZ);
+    GpsImuFusion fusion;
+    MotionSpectrum spectrum(IMU_SAMPLE_RATE_HZ);
+    int imu_timer = -1;
+    bool imu_running = false;
+    uint64_t imu_missed = 0;   // --stats 로 출력
+    if (imu_open()) {
+        // 밀린 주기는 건너뛰고 세기만 한다 (센서 값은 읽는 시점의 값이라 몰아서 읽어도 의미 없음)
+        imu_timer = loop.add_timer(0.0, [&msdv, &fusion, &spectrum, &imu_missed](uint64_t expirations) {
+            if (expirations > 1) imu_missed += expirations - 1;
+            imu_read_sample(msdv, fusion, spectrum);
+        });
+    }
+    auto sync_imu_timer = [&]() {
+        bool want = !idle_monitor.idle();
+        if (imu_timer < 0 || want == imu_running) return;
+        if (!want) imu_clear_buffer();
+        loop.set_timer(imu_timer, want ? 1.0 / IMU_SAMPLE_RATE_HZ : 0.0);
+        imu_running = want;
+    };
+    sync_imu_timer();
+
+    FaceServer face_server;
+    if (face_server.open()) {
+        // 얼굴이 돌아온 그 프레임에서 바로 IMU 재개
+        loop.add_fd(face_server.fd(), [&]() {
+            face_server.poll(0);
+            sync_imu_timer();
+        });
+    }
+
+    if (feature_publisher.fd() >= 0) {
+        loop.add_fd(feature_publisher.fd(), []() { feature_publisher.poll(0); });
+    }
+
+    // idle 진입은 summary 스레드의 DB tick 이 정하므로 루프에서는 1초마다 확인만
+    loop.add_timer(1.0, [&](uint64_t) { sync_imu_timer(); });
+
+    RunStats stats("reactor");
+    if (print_stats) {
+        loop.add_timer(10.0, [&stats, &loop, &imu_missed](uint64_t) {
+            stats.report(loop.wakeups());
+            if (imu_missed) std::cout << "[Reactor] IMU missed " << imu_missed << " period(s)" << std::endl;
+            imu_missed = 0;
+        });
+    }
+
+    std::thread summary_thread(run_summary_ticks, std::ref(running), std::ref(aggregator), std::ref(csv_logger), print_stats);
+
+    std::cout << "[Reactor] Started." << std::endl;
+    loop.run(running);
+
+    // idle 로 잠들어 있으면 main 의 idle_monitor.shutdown() 이 깨운다
+    summary_thread.join();
+
+    imu_close();
+    gps_close_serial();
+    can_receiver.close();
+    std::cout << "[Reactor] Stopped." << std::endl;
+}
+
+// 설치 경로 (.venv, python/, data/). MOTIONSICK_ROOT 로 바꿀 수 있다
+std::string app_root() {
+    const char* root = std::getenv("MOTIONSICK_ROOT");
+    return (root && *root) ? root : "/home/moorim/2025_motionsick_logger_cpp";
+}
+
+// 카메라 하나당 face_processor.py 하나 (죽거나 멈추면 supervisor 가 다시 띄움)
+std::unique_ptr<ProcessSupervisor> start_face_producer(const std::string& root, const std::string& source) {
+    ProcessSupervisor::Spec spec;
+    spec.name = "face:" + source;
+    spec.argv = {root + "/.venv/bin/python", root + "/python/face_processor.py"};
+    spec.env = {"MOTIONSICK_FACE_SOURCE=" + source, "PYTHONUNBUFFERED=1"};
+    auto supervisor = std::make_unique<ProcessSupervisor>(spec);
+    supervisor->start();
+    return supervisor;
+}
 
 int main(int argc, char *argv[]) {
-    // ✅ 0. Python 얼굴 처리 스크립트 실행 (백그라운드)
-    std::system("/home/moorim/2025_motionsick_logger_cpp/.venv/bin/python /home/moorim/2025_motionsick_logger_cpp/python/face_processor.py &");
+    const auto launch_time = std::chrono::steady_clock::now();
 
     QApplication app(argc, argv);
 
+    // Qt 가 자기 옵션을 뺀 나머지 인자
+    bool reactor_mode = false;   // --reactor: I/O 를 이벤트 루프 스레드 하나로
+    bool print_stats = false;    // --stats: 10초마다 CPU / context switch 출력
+    bool passenger_camera = false;  // --passenger-camera: 두 번째 얼굴 producer 도 띄움
+    std::vector<double> pyramid_periods = default_pyramid_periods;  // --pyramid=0.1,1,10,60 | --pyramid=off
+    std::string pubsub_path;     // --pubsub=PATH | --pubsub=off (기본: data/live.sock)
+    bool pubsub_enabled = true;
+    std::string trace_path;      // --trace out.json: 종료할 때 샘플별 span 을 Chrome trace JSON 으로
+    std::string can_interface;   // --can=can0 (시험: --can=vcan0). 기본은 CAN 없음
+    ImuCaptureConfig imu_capture;   // --imu-oversample=1000: 가속도 원시 주기 (스레드 모드 전용)
+    std::string imu_raw_path;    // --imu-raw=PATH: 종료할 때 최근 IMU_RAW_RING_SEC 의 원시 가속도를 CSV 로
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--reactor") == 0) reactor_mode = true;
+        else if (std::strcmp(argv[i], "--stats") == 0) print_stats = true;
+        else if (std::strcmp(argv[i], "--passenger-camera") == 0) passenger_camera = true;
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) trace_path = argv[++i];
+        else if (std::strncmp(argv[i], "--can=", 6) == 0) can_interface = argv[i] + 6;
+        else if (std::strncmp(argv[i], "--imu-oversample=", 17) == 0) {
+            double hz = std::atof(argv[i] + 17);
+            if (imu_oversample_supported(hz)) imu_capture.raw_rate_hz = hz;
+            else std::cerr << "[Main] Ignoring " << argv[i] << ": use 500, 1000 or 2000" << std::endl;
+        }
+        else if (std::strncmp(argv[i], "--imu-raw=", 10) == 0) imu_raw_path = argv[i] + 10;
+        else if (std::strncmp(argv[i], "--pubsub=", 9) == 0) {
+            pubsub_path = argv[i] + 9;
+            pubsub_enabled = pubsub_path != "off";
+        }
+        else if (std::strncmp(argv[i], "--pyramid=", 10) == 0) {
+            std::string value = argv[i] + 10;
+            std::string error;
+            if (value == "off") pyramid_periods.clear();
+            else if (!parse_pyramid_periods(value, pyramid_periods, &error)) {
+                std::cerr << "[Main] Ignoring " << argv[i] << ": " << error << std::endl;
+            }
+        }
+    }
+
+    if (!trace_path.empty()) trace_start();
+    if (reactor_mode && imu_capture.raw_rate_hz > 0.0) {
+        std::cerr << "[Main] --imu-oversample needs the IMU thread, ignored with --reactor" << std::endl;
+        imu_capture.raw_rate_hz = 0.0;
+    }
+    if (!imu_raw_path.empty() && imu_capture.raw_rate_hz <= 0.0) {
+        std::cerr << "[Main] --imu-raw only records with --imu-oversample, ignored" << std::endl;
+        imu_raw_path.clear();
+    }
+    imu_capture.keep_raw = !imu_raw_path.empty();
+
+    const std::string root = app_root();
+
+    // ✅ 0. 얼굴 producer 를 제일 먼저 (MediaPipe 모델 로딩이 가장 오래 걸림, 나머지 초기화와 병렬)
+    std::vector<std::unique_ptr<ProcessSupervisor>> face_producers;
+    face_producers.push_back(start_face_producer(root, FACE_SOURCE_NAMES[0]));
+    if (passenger_camera) face_producers.push_back(start_face_producer(root, FACE_SOURCE_NAMES[1]));
+
+    // ✅ DB 는 백그라운드에서 연다 (큰 예전 DB 는 첫 실행 때 인덱스 생성에 몇 초). 그동안 UI / 센서 시작
+    const std::string db_path = root + "/data/data_log.db";
+    std::shared_future<std::shared_ptr<DatabaseLogger>> db_future = std::async(std::launch::async, [db_path]() {
+        return std::make_shared<DatabaseLogger>(db_path);
+    }).share();
+
     // ✅ 1. 공유 토글 상태 생성
     auto toggle_state = std::make_shared<std::array<std::atomic<int>, 3>>();
     for (int i = 0; i < 3; ++i) {
@@ -47,100 +351,101 @@ int main(int argc, char *argv[]) {
 
     std::atomic<bool> running(true);
 
-    // ✅ FaceData 큐 생성 및 소켓 수신기 실행
     ThreadSafeQueue<FaceData> face_data_queue;
-    std::thread socket_thread(socket_receiver, std::ref(face_data_queue), std::ref(running), &window);
-    socket_thread.detach();
-
-    // ✅ IMU 큐 및 스레드 실행
     ThreadSafeQueue<ImuData> imu_queue;
-    std::thread imuThread(imu_thread, std::ref(imu_queue), std::ref(running));
-    imuThread.detach();
 
-    // GPS
-    ThreadSafeQueue<GpsData> gps_queue;
-    std::thread gps(gps_thread, std::ref(gps_queue), std::ref(running));
+    // ✅ DB 로거는 열리는 대로 aggregator 가 가져간다
+    DbAggregator aggregator{db_future, launch_time};
 
-    // ✅ DB 로거 인스턴스
-    DatabaseLogger db_logger("/home/moorim/2025_motionsick_logger_cpp/data/data_log.db");
+    std::string log_path = root + "/data/summary_log.csv";
+    initialize_csv(log_path);
 
-    static double last_face_timestamp = 0.0;
-    static double last_imu_timestamp = 0.0;
-    static double last_gps_timestamp = 0.0;
+    // ✅ 다른 프로세스용 실시간 pub/sub (구독자가 없으면 publish 는 마스크 확인만 하고 끝)
+    bool pubsub_open = pubsub_enabled &&
+        feature_publisher.open(pubsub_path.empty() ? root + "/data/live.sock" : pubsub_path);
 
-    std::thread dataAggregatorThread([&db_logger]() {
-        while (true) {
+    if (reactor_mode) {
+        // ✅ 소켓 / IMU / GPS / CAN 을 이벤트 루프 스레드 하나에서 (DB / CSV tick 은 그 옆 summary 스레드)
+        auto csv_logger = std::make_shared<SummaryCsvLogger>(log_path, pyramid_periods);
+        std::thread reactor_thread([&running, &aggregator, csv_logger, print_stats, can_interface]() {
+            trace_thread_name("reactor");
+            run_reactor(running, aggregator, *csv_logger, print_stats, can_interface);
+        });
+        reactor_thread.detach();
+    } else {
+        // ✅ FaceData 큐 생성 및 소켓 수신기 실행
+        std::thread socket_thread(socket_receiver, std::ref(face_data_queue), std::ref(running));
+        socket_thread.detach();
 
-            double now = std::chrono::duration<double>(
-                std::chrono::system_clock::now().time_since_epoch()
-            ).count();
+        // ✅ IMU 큐 및 스레드 실행
+        std::thread imuThread(imu_thread, std::ref(imu_queue), std::ref(running), imu_capture);
+        imuThread.detach();
 
-            if (now - last_face_detected_time.load() > 60.0) {
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-                continue;  // 최근 얼굴 감지 이후 60초 경과 → 로깅 중단
-            }
-            
-            std::vector<FaceData> face_snapshot;
-            std::vector<ImuData> imu_snapshot;
-            std::vector<GpsData> gps_snapshot;
-
-            {
-                std::lock_guard<std::mutex> lock(face_buffer_mutex);
-                face_snapshot = face_buffer;
-            }
+        // GPS
+        std::thread gps(gps_thread, std::ref(running));
+        gps.detach();
 
-            {
-                std::lock_guard<std::mutex> lock(imu_buffer_mutex);
-                imu_snapshot = imu_buffer;
-            }
-            {
-                std::lock_guard<std::mutex> lock(gps_buffer_mutex);
-                gps_snapshot = gps_buffer;
-            }
+        // 차량 CAN (--can 일 때만)
+        if (!can_interface.empty()) {
+            std::thread can(can_thread, std::ref(running), can_interface);
+            can.detach();
+        }
 
-            for (const auto& face : face_snapshot) {
-                if (face.source_timestamp > last_face_timestamp) {
-                    db_logger.insertFaceData(face);
-                    if (face.source_timestamp > last_face_timestamp)
-                        last_face_timestamp = face.source_timestamp;
-                }
-            }
-            for (const auto& imu : imu_snapshot) {
-                if (imu.source_timestamp > last_imu_timestamp) {
-                    db_logger.insertImuData(imu);
-                    if (imu.source_timestamp > last_imu_timestamp)
-                        last_imu_timestamp = imu.source_timestamp;
-                }
-            }
-            for (const auto& gps : gps_snapshot) {
-                if (gps.source_timestamp > last_gps_timestamp) {
-                    db_logger.insertGpsData(gps);
-                    last_gps_timestamp = gps.source_timestamp;
+        std::thread dataAggregatorThread([&aggregator]() {
+            trace_thread_name("db");
+            while (true) {
+                aggregator.tick();
+
+                // idle 이면 얼굴이 돌아오거나 토글이 눌릴 때까지 잠든다 (sleep 폴링 없음)
+                if (idle_monitor.idle()) {
+                    if (!idle_monitor.wait_until_active_or_woken()) break;
+                } else {
+                    std::this_thread::sleep_for(std::chrono::seconds(1));
                 }
             }
+        });
+        dataAggregatorThread.detach();
 
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-        }
-    });
-    dataAggregatorThread.detach();
+        start_csv_logger(running, log_path, print_stats, pyramid_periods);
 
-    std::string log_path = "/home/moorim/2025_motionsick_logger_cpp/data/summary_log.csv";
-    initialize_csv(log_path);
-    start_csv_logger(running, toggle_state, log_path);  // 내부에서 자체 스레드 생성 및 detach 처리
+        if (pubsub_open) {
+            std::thread pubsub_thread([&running]() {
+                trace_thread_name("pubsub");
+                while (running && feature_publisher.poll(500)) {}
+            });
+            pubsub_thread.detach();
+        }  // 내부에서 자체 스레드 생성 및 detach 처리
 
-    
+        if (print_stats) {
+            const bool oversampling = imu_capture.raw_rate_hz > 0.0;
+            std::thread stats_thread([&running, oversampling]() {
+                RunStats stats("threaded");
+                while (running) {
+                    std::this_thread::sleep_for(std::chrono::seconds(10));
+                    stats.report();
+                    if (oversampling) imu_report_oversampling();
+                }
+            });
+            stats_thread.detach();
+        }
+    }
 
     int ret = app.exec();  // run the Qt event loop first
 
-    // 🔚 After the Qt app closes, clean up the Python process
-    std::ifstream pid_file("/home/moorim/2025_motionsick_logger_cpp/python/tmp/face_processor.pid");
-    int python_pid = 0;
-    pid_file >> python_pid;
+    // idle 로 잠든 스레드들도 깨워서 끝낸다
+    running = false;
+    idle_monitor.shutdown();
 
-    if (python_pid > 0) {
-        std::cout << "[INFO] Killing Python process with PID: " << python_pid << std::endl;
-        kill(python_pid, SIGTERM);  // or SIGKILL if needed
-    }
+    // 마지막 1초 tick 이후 (또는 idle 중) 눌린 클릭도 DB 에
+    aggregator.flush_toggles();
+
+    // 스레드들은 detach 돼 있어서 아직 기록 중일 수 있음 (덮어쓰이는 중인 span 은 빠진다)
+    if (!trace_path.empty()) trace_write_chrome_json(trace_path);
+    if (!imu_raw_path.empty()) imu_raw_ring.write_csv(imu_raw_path);
+    alloc_check_report();
+
+    // 🔚 After the Qt app closes, clean up the Python processes (SIGTERM → SIGKILL)
+    for (auto& producer : face_producers) producer->stop();
 
     return ret;
 }
@@ -0,0 +1,55 @@
+import math
+import socket
+import struct
+import sys
+import time
+
+# vcan0 용 가짜 차량 CAN (C++ sensors/can_decoder.cpp 의 default_can_signals 와 같은 배치)
+#   python can_simulator.py [인터페이스] [초]
+#   0x0A0 SPEED          Intel    16bit unsigned x0.01 km/h      (50Hz)
+#   0x0B0 STEER_ANGLE    Motorola 16bit signed   x0.1 deg        (100Hz)
+#         STEER_RATE     Motorola 16bit signed   x0.1 deg/s
+#   0x0C0 ACCEL_PEDAL    Intel    8bit  unsigned x0.4 %          (20Hz)
+#         BRAKE_PRESSURE Intel    16bit unsigned x0.1 bar
+
+CAN_FRAME = struct.Struct("=IB3x8s")   # can_id, dlc, padding, data
+
+
+def frame(can_id, data):
+    return CAN_FRAME.pack(can_id, len(data), data.ljust(8, b"\x00"))
+
+
+def main():
+    interface = sys.argv[1] if len(sys.argv) > 1 else "vcan0"
+    duration = float(sys.argv[2]) if len(sys.argv) > 2 else float("inf")
+
+    sock = socket.socket(socket.AF_CAN, socket.SOCK_RAW, socket.CAN_RAW)
+    sock.bind((interface,))
+    print(f"[CAN sim] Sending on {interface}")
+
+    start = time.monotonic()
+    tick = 0
+    while time.monotonic() - start < duration:
+        t = tick / 100.0
+
+        # 30 ~ 70 km/h 가감속, 8초 주기 S자 조향
+        speed = 50.0 + 20.0 * math.sin(2 * math.pi * t / 20.0)
+        angle = 90.0 * math.sin(2 * math.pi * t / 8.0)
+        rate = 90.0 * 2 * math.pi / 8.0 * math.cos(2 * math.pi * t / 8.0)
+        braking = math.cos(2 * math.pi * t / 20.0) < -0.5
+
+        steer = struct.pack(">hh", round(angle / 0.1), round(rate / 0.1))
+        sock.send(frame(0x0B0, steer + b"\x00" * 4))
+        if tick % 2 == 0:
+            sock.send(frame(0x0A0, struct.pack("<H", round(speed / 0.01)) + b"\x00" * 6))
+        if tick % 5 == 0:
+            pedal = 0 if braking else round(30.0 / 0.4)
+            brake = round((15.0 if braking else 0.0) / 0.1)
+            sock.send(frame(0x0C0, struct.pack("<BH", pedal, brake) + b"\x00" * 5))
+
+        tick += 1
+        time.sleep(max(0.0, start + tick / 100.0 - time.monotonic()))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,94 @@
+import ctypes
+import os
+import sys
+
+import numpy as np
+
+from skin_roi import (get_average_rgb, get_roi_polygons, vertices_id_face_boundary, vertices_id_left_eye,
+                      vertices_id_lip, vertices_id_right_eye)
+
+# 예전 Python get_average_rgb (cv2.fillPoly 마스크) 와 C++ skin_roi_mean_rgb (scanline, SSE2 / NEON) 를
+# 같은 합성 프레임에서 비교한다. 공유메모리 경로로 바꾼 뒤 rPPG 입력이 달라지지 않았는지 확인용
+#   python check_skin_roi.py [build/libmotionsick_skin_roi.so] [프레임 수]
+# 다각형 경계 픽셀은 규칙이 달라서 (fillPoly 는 경계 포함, C++ 는 픽셀 중심) 조금 다르다.
+# 평균이 MAX_MEAN_DIFF 레벨보다 차이 나면 exit 1
+
+MAX_MEAN_DIFF = 0.5          # 8비트 레벨, 채널별
+LANDMARK_COUNT = 478
+
+
+def load_kernel(path):
+    lib = ctypes.CDLL(path)
+    fn = lib.motionsick_skin_roi_mean_rgb
+    fn.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_int,
+                   ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int, ctypes.c_void_p]
+    fn.restype = ctypes.c_size_t
+    return fn
+
+
+def cpp_average_rgb(kernel, image, polygons):
+    h, w, _ = image.shape
+    image = np.ascontiguousarray(image)
+    points = np.array([c for poly in polygons for pt in poly for c in pt], dtype=np.int16)
+    counts = np.array([len(poly) for poly in polygons], dtype=np.uint16)
+    out = np.zeros(3, dtype=np.float64)
+    n = kernel(image.ctypes.data, w, h, w * 3, points.ctypes.data, counts.ctypes.data, len(polygons), out.ctypes.data)
+    return out, n
+
+
+def ring(landmarks, indices, cx, cy, rx, ry, rng, jitter):
+    # 다각형 순서대로 타원 위에 꼭짓점 (마지막 = 첫 번째 인덱스라 닫힘), 조금씩 흔들어서 비스듬한 변이 생기게
+    unique = indices[:-1]
+    for k, i in enumerate(unique):
+        a = 2.0 * np.pi * k / len(unique)
+        landmarks[i * 3] = cx + rx * np.cos(a) * (1.0 + rng.uniform(-jitter, jitter))
+        landmarks[i * 3 + 1] = cy + ry * np.sin(a) * (1.0 + rng.uniform(-jitter, jitter))
+
+
+def synthetic_frame(rng, w, h):
+    # 피부처럼 완만한 그라디언트 + 센서 잡음
+    y, x = np.mgrid[0:h, 0:w].astype(np.float64)
+    image = np.empty((h, w, 3), dtype=np.uint8)
+    for c, base in enumerate((110.0, 140.0, 180.0)):   # B, G, R
+        plane = base + rng.uniform(-40, 40) * x / w + rng.uniform(-40, 40) * y / h + rng.normal(0, 6, (h, w))
+        image[:, :, c] = np.clip(plane, 0, 255).astype(np.uint8)
+
+    landmarks = [0.0] * (LANDMARK_COUNT * 3)
+    cx, cy = rng.uniform(0.4, 0.6), rng.uniform(0.4, 0.6)
+    s = rng.uniform(0.15, 0.3)
+    ring(landmarks, vertices_id_face_boundary, cx, cy, s, s * 1.3, rng, 0.05)
+    ring(landmarks, vertices_id_left_eye, cx - 0.4 * s, cy - 0.3 * s, 0.18 * s, 0.08 * s, rng, 0.1)
+    ring(landmarks, vertices_id_right_eye, cx + 0.4 * s, cy - 0.3 * s, 0.18 * s, 0.08 * s, rng, 0.1)
+    ring(landmarks, vertices_id_lip, cx, cy + 0.6 * s, 0.35 * s, 0.12 * s, rng, 0.1)
+    return image, landmarks
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    path = sys.argv[1] if len(sys.argv) > 1 else os.path.join(here, "..", "build", "libmotionsick_skin_roi.so")
+    frames = int(sys.argv[2]) if len(sys.argv) > 2 else 200
+
+    kernel = load_kernel(path)
+    rng = np.random.default_rng(1)
+    worst = 0.0
+    worst_pixels = 0.0
+    for i in range(frames):
+        w, h = (320, 240) if i % 2 == 0 else (640, 480)
+        image, landmarks = synthetic_frame(rng, w, h)
+        py_rgb, masked = get_average_rgb(image, landmarks, image.shape)
+        py_pixels = np.count_nonzero(masked.any(axis=2)) or 1
+        cpp_rgb, cpp_pixels = cpp_average_rgb(kernel, image, get_roi_polygons(landmarks, image.shape))
+        worst = max(worst, float(np.max(np.abs(np.array(py_rgb) - cpp_rgb))))
+        worst_pixels = max(worst_pixels, abs(cpp_pixels - py_pixels) / py_pixels)
+
+    print(f"[SkinRoi] {frames} frames: max |python - c++| = {worst:.3f} levels, "
+          f"max pixel count difference {100.0 * worst_pixels:.1f}% (polygon edges)")
+    if worst > MAX_MEAN_DIFF:
+        print(f"[SkinRoi] FAILED: mean differs by more than {MAX_MEAN_DIFF} levels")
+        return 1
+    print("[SkinRoi] ok")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
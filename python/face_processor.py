@@ -14,15 +14,41 @@ from mediapipe.tasks import python
 import os
 from picamera2 import Picamera2
 
+import ctypes
+import ctypes.util
+import mmap
+import platform
+import select
+import struct
+
 import os
-pid_dir = "/home/moorim/2025_motionsick_logger_cpp/python/tmp"
-os.makedirs(pid_dir, exist_ok=True)  # ✅ Create the directory if it doesn't exist
 
-with open(os.path.join(pid_dir, "face_processor.pid"), "w") as f:
-    f.write(str(os.getpid()))
+# 카메라 구분 (C++ FACE_SOURCE_NAMES). 두 번째 카메라는 MOTIONSICK_FACE_SOURCE=passenger 로 실행
+FACE_SOURCE = os.environ.get("MOTIONSICK_FACE_SOURCE", "driver")
+source_suffix = "" if FACE_SOURCE == "driver" else "_" + FACE_SOURCE
+
+# 로거(ProcessSupervisor)가 띄우면 heartbeat fd 가 넘어온다. 프레임 루프가 돌고 있으면 1초마다 1바이트.
+# 멈추면 로거가 죽이고 다시 띄운다. 직접 실행할 때는 없음
+HEARTBEAT_FD = int(os.environ.get("MOTIONSICK_HEARTBEAT_FD", "-1"))
+last_heartbeat = 0.0
+
+
+def heartbeat():
+    global last_heartbeat, HEARTBEAT_FD
+    if HEARTBEAT_FD < 0:
+        return
+    now = time.monotonic()
+    if now - last_heartbeat < 1.0:
+        return
+    last_heartbeat = now
+    try:
+        os.write(HEARTBEAT_FD, b".")
+    except OSError:
+        HEARTBEAT_FD = -1  # 로거가 없어짐
+
 
 # 모델 다운로드 (한 번만 필요)
-model_path = '/home/moorim/2025_motionsick_logger_cpp/python/face_landmarker_v2_with_blendshapes.task'
+model_path = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'face_landmarker_v2_with_blendshapes.task')
 
 # FaceLandmarker 옵션 설정
 base_options = python.BaseOptions(model_asset_path=model_path)
@@ -40,43 +66,135 @@ from collections import deque
 # FPS 측정 변수
 frame_times = deque(maxlen=30)  # 최근 30프레임의 시간 저장
 
-vertices_id_face_boundary  = [ # points that enclose the face area, keep the orders, counter-clockwise, or clockwise, the first == the last
-   9,
-   336, 296, 334, 293, 301, 
-   389, 356,454,323, 361, 288, 397,365, 379, 378, 400, 377,
-   152,
-   148, 176, 149, 150, 136, 172, 58, 132, 93, 234, 127, 162,
-   71, 63, 105, 66, 107,
-   9
-]
-
-vertices_id_left_eye = [
-    33,
-    246, 161, 160,159, 158, 157, 173, 133,
-    155, 154, 153, 145, 144, 163, 7,
-    33
-]
-
-vertices_id_right_eye = [
-    362,
-    398, 384, 385, 386, 387, 388, 466, 263,
-    249, 390, 373, 374, 380, 381, 382,
-    362
-]
-
-vertices_id_lip = [
-    0,
-    267, 269, 270, 409,
-    375, 321, 405, 314, 17, 84, 181, 91, 146, 
-    185, 40, 39, 37,
-    0
-]
+# 피부 ROI 다각형 / 평균 RGB (C++ 계산과 비교하는 python/check_skin_roi.py 도 같이 씀)
+from skin_roi import get_roi_polygons, get_average_rgb
+
+# 공유메모리 프레임 전달 (C++ sensors/frame_shm.hpp 와 레이아웃 동일)
+# 얼굴 ROI 평균 RGB 는 C++ 쪽에서 계산하고, 여기서는 프레임과 다각형만 올린다.
+# MOTIONSICK_FRAME_SHM=0 이면 예전처럼 여기서 get_average_rgb 로 계산해서 보낸다.
+FRAME_SHM_PATH = "/dev/shm/motionsick_frames" + source_suffix
+FRAME_SHM_MAGIC = 0x5246534D  # "MSFR"
+FRAME_SHM_VERSION = 1
+FRAME_SHM_MAX_POINTS = 128
+FRAME_SHM_PIXEL_OFFSET = 576
+FRAME_SHM_HEADER = struct.Struct("<IIIIII40x")            # 64 bytes
+FRAME_SHM_SLOT_META = struct.Struct("<IIIQd4H")            # seq 뒤: width, height, stride, frame_id, timestamp, poly_counts
+
+
+def load_store_fence():
+    # seqlock 쓰기 순서 (홀수 seq → 내용 → 짝수 seq) 를 다른 코어에도 그대로 보이게 하는 하드웨어 fence.
+    # mmap 저장은 그냥 메모리 쓰기라 aarch64 (Pi) 에서는 순서가 바뀌어 보일 수 있다 → libatomic 의 C11 atomic_thread_fence
+    name = ctypes.util.find_library("atomic") or "libatomic.so.1"
+    try:
+        fence = ctypes.CDLL(name).atomic_thread_fence
+    except (OSError, AttributeError):
+        if platform.machine() in ("x86_64", "AMD64", "i686", "i386"):
+            return lambda: None   # x86 은 저장 순서가 유지됨 (TSO)
+        raise OSError("libatomic not found, cannot order shared-memory stores")
+    fence.argtypes = [ctypes.c_int]
+    fence.restype = None
+    return lambda: fence(5)   # memory_order_seq_cst (aarch64: dmb ish)
+
+
+class FrameShmWriter:
+    def __init__(self, max_width=640, max_height=480, slot_count=2):
+        self.slot_count = slot_count
+        self.slot_size = (FRAME_SHM_PIXEL_OFFSET + max_width * max_height * 3 + 63) // 64 * 64
+        size = FRAME_SHM_HEADER.size + self.slot_count * self.slot_size
+
+        # 같은 파일을 재사용해야 C++ 쪽 mmap 이 계속 유효하다 (unlink 하지 않음)
+        fd = os.open(FRAME_SHM_PATH, os.O_RDWR | os.O_CREAT, 0o666)
+        os.ftruncate(fd, size)
+        self.buf = mmap.mmap(fd, size)
+        os.close(fd)
+
+        FRAME_SHM_HEADER.pack_into(self.buf, 0, FRAME_SHM_MAGIC, FRAME_SHM_VERSION,
+                                   self.slot_count, self.slot_size, max_width, max_height)
+        self.max_width = max_width
+        self.max_height = max_height
+        self.fence = load_store_fence()
+        # seq 는 32비트 한 번에 써야 한다 (struct.pack_into 는 바이트 단위 복사일 수 있음)
+        self.seqs = [ctypes.c_uint32.from_buffer(self.buf, FRAME_SHM_HEADER.size + i * self.slot_size)
+                     for i in range(self.slot_count)]
+
+    def publish(self, frame_id, timestamp, image, polygons):
+        h, w, _ = image.shape
+        if w > self.max_width or h > self.max_height:
+            return False
+
+        points = [p for poly in polygons for p in poly]
+        if len(points) > FRAME_SHM_MAX_POINTS:
+            return False
+
+        base = FRAME_SHM_HEADER.size + (frame_id % self.slot_count) * self.slot_size
+        slot_seq = self.seqs[frame_id % self.slot_count]
+        writing = (slot_seq.value + 1) | 1
+
+        # seqlock: 홀수 = 쓰는 중. 홀수 seq 가 내용보다 먼저, 내용이 짝수 seq 보다 먼저 보이도록 fence 두 번
+        slot_seq.value = writing
+        self.fence()
+        FRAME_SHM_SLOT_META.pack_into(self.buf, base + 4, w, h, w * 3, frame_id, timestamp,
+                                      *[len(poly) for poly in polygons])
+        flat = [c for pt in points for c in pt]
+        struct.pack_into("<%dh" % len(flat), self.buf, base + 4 + FRAME_SHM_SLOT_META.size, *flat)
+        pixel_start = base + FRAME_SHM_PIXEL_OFFSET
+        self.buf[pixel_start:pixel_start + h * w * 3] = np.ascontiguousarray(image[:, :, :3]).tobytes()
+        self.fence()
+        slot_seq.value = (writing + 1) & 0xFFFFFFFF
+        return True
+
+
+frame_shm = None
+if os.environ.get("MOTIONSICK_FRAME_SHM", "1") != "0":
+    try:
+        frame_shm = FrameShmWriter()
+    except OSError as e:
+        print(f"[WARN] Shared-memory frames disabled: {e}")
 
 # Socket 설정
 HOST = '127.0.0.1'
 PORT = 50007
-sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-sock.connect((HOST, PORT))
+
+
+def connect_logger(timeout=10.0):
+    # 로거와 동시에 시작하므로 listen 전이면 잠깐 재시도
+    deadline = time.monotonic() + timeout
+    while True:
+        try:
+            return socket.create_connection((HOST, PORT))
+        except OSError:
+            if time.monotonic() > deadline:
+                raise
+            time.sleep(0.2)
+
+
+sock = connect_logger()
+
+# 로거가 보내는 frame rate 명령: {"cmd": "rate", "mode": "idle" | "active"}
+# idle 이면 IDLE_FPS 로 낮추고, 얼굴이 보이면 명령을 기다리지 않고 바로 full rate 로 복귀
+IDLE_FPS = float(os.environ.get("MOTIONSICK_IDLE_FPS", "2"))
+idle_mode = False
+command_buffer = b""
+
+
+def poll_logger_commands():
+    global idle_mode, command_buffer
+    while select.select([sock], [], [], 0)[0]:
+        chunk = sock.recv(4096)
+        if not chunk:
+            return
+        command_buffer += chunk
+    while b"\n" in command_buffer:
+        line, command_buffer = command_buffer.split(b"\n", 1)
+        try:
+            cmd = json.loads(line)
+        except ValueError:
+            continue
+        if cmd.get("cmd") == "rate":
+            new_idle = cmd.get("mode") == "idle"
+            if new_idle != idle_mode:
+                print(f"[INFO] Logger requested {'idle' if new_idle else 'active'} frame rate")
+            idle_mode = new_idle
 
 picam2 = Picamera2()
 picam2.preview_configuration.main.format = "RGB888"
@@ -84,49 +202,22 @@ picam2.preview_configuration.main.size = (320, 240)
 picam2.configure("preview")
 picam2.start()
 
-def get_average_rgb(image, landmarks, image_shape):
-    h, w, _ = image_shape
-
-    def to_pixel_coords(indices):
-        return [(int(landmarks[i*3] * w), int(landmarks[i*3+1] * h)) for i in indices]
-
-    # 마스크 정의
-    face_poly = np.array([to_pixel_coords(vertices_id_face_boundary)], dtype=np.int32)
-    eye_left_poly = np.array([to_pixel_coords(vertices_id_left_eye)], dtype=np.int32)
-    eye_right_poly = np.array([to_pixel_coords(vertices_id_right_eye)], dtype=np.int32)
-    lip_poly = np.array([to_pixel_coords(vertices_id_lip)], dtype=np.int32)
-
-    mask = np.zeros((h, w), dtype=np.uint8)
-    cv2.fillPoly(mask, face_poly, 255)
-    cv2.fillPoly(mask, eye_left_poly, 0)
-    cv2.fillPoly(mask, eye_right_poly, 0)
-    cv2.fillPoly(mask, lip_poly, 0)
-
-    masked_image = cv2.bitwise_and(image, image, mask=mask)
-
-    # Get mask of non-zero (skin) pixels
-    non_zero_mask = mask > 0
-    number_of_skin_pixels = np.count_nonzero(non_zero_mask)
-
-    if number_of_skin_pixels == 0:
-        return (0.0, 0.0, 0.0), masked_image  # fallback
-
-    r = np.sum(image[:, :, 2][non_zero_mask]) / number_of_skin_pixels
-    g = np.sum(image[:, :, 1][non_zero_mask]) / number_of_skin_pixels
-    b = np.sum(image[:, :, 0][non_zero_mask]) / number_of_skin_pixels
-
-    return (r, g, b), masked_image  # RGB, masked_image
-
+frame_id = 0
 
 while True:
     start_time = time.time()
+    frame_id += 1
+    heartbeat()
+    poll_logger_commands()
 
     image = picam2.capture_array()
+    capture_time = time.time()   # 로거 --trace 의 face.producer span 시작
     image_rgb = cv2.cvtColor(image, cv2.COLOR_BGR2RGB)
     mp_image = mp.Image(image_format=mp.ImageFormat.SRGB, data=image_rgb)
     results = face_landmarker.detect(mp_image)
 
     if results and len(results.face_landmarks)>0:
+        idle_mode = False  # 얼굴이 돌아오면 이 프레임부터 바로 full rate
         landmark_list = []
         
         for lm in results.face_landmarks[0]:
@@ -141,13 +232,23 @@ while True:
         translation_vector = matrix[:3, 3].tolist()
 
         # print(f"{blendshape_dict=}")
-        avg_rgb, masked_image = get_average_rgb(image, landmark_list, image.shape)  
+        timestamp = time.time()
+
+        # ✅ 공유메모리가 있으면 프레임 + 다각형만 올리고 avg_rgb 는 C++ 에서 계산
+        if frame_shm is not None and frame_shm.publish(frame_id, timestamp, image,
+                                                       get_roi_polygons(landmark_list, image.shape)):
+            avg_rgb = []
+        else:
+            avg_rgb, masked_image = get_average_rgb(image, landmark_list, image.shape)
 
         # cv2.imwrite("/home/moorim/2025_motionsick_logger_cpp/python/masked_face.jpg", masked_image)
         
         # 현재는 랜드마크만 전송 (추후 blendshape 추가)
         data = {
-            "timestamp": time.time(),
+            "timestamp": timestamp,
+            "source": FACE_SOURCE,
+            "frame_id": frame_id,
+            "capture_time": capture_time,
             "blendshapes": blendshape_dict,
             "avg_rgb": avg_rgb,
             "rotation_matrix": rotation_matrix,
@@ -158,6 +259,9 @@ while True:
     # 얼굴이 감지되지 않은 경우 빈 데이터 전송
         data = {
             "timestamp": time.time(),
+            "source": FACE_SOURCE,
+            "frame_id": frame_id,
+            "capture_time": capture_time,
             "blendshapes": {},
             "avg_rgb": [],
             "rotation_matrix": [],
@@ -169,6 +273,12 @@ while True:
     json_data = json.dumps(data)
     sock.sendall(json_data.encode('utf-8') + b'\n')  # \n으로 구분
 
+    # idle: 남은 프레임 시간만큼 쉰다 (카메라/MediaPipe 부하 감소)
+    if idle_mode:
+        remaining = 1.0 / IDLE_FPS - (time.time() - start_time)
+        if remaining > 0:
+            time.sleep(remaining)
+
     # # ⏱ FPS 계산
     # end_time = time.time()
     # frame_time = end_time - start_time
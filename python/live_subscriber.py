@@ -0,0 +1,68 @@
+import os
+import socket
+import struct
+import sys
+import time
+
+# 로거의 실시간 pub/sub 구독 예제 (C++ logger/feature_publisher.hpp 와 같은 프레임 형식)
+#   python live_subscriber.py [소켓 경로] [topic ...]
+#   topic: summary imu gps face (기본 summary)
+
+TOPICS = {"schema": 0, "summary": 1, "imu": 2, "gps": 3, "face": 4, "dropped": 15}
+HEADER = struct.Struct("<IHHd")   # payload 길이, topic, 0, timestamp
+
+DEFAULT_PATH = os.path.join(os.environ.get("MOTIONSICK_ROOT", "/home/moorim/2025_motionsick_logger_cpp"),
+                            "data", "live.sock")
+
+
+def read_exact(sock, n):
+    data = b""
+    while len(data) < n:
+        chunk = sock.recv(n - len(data))
+        if not chunk:
+            raise ConnectionError("logger closed the socket")
+        data += chunk
+    return data
+
+
+def main():
+    path = sys.argv[1] if len(sys.argv) > 1 else DEFAULT_PATH
+    wanted = sys.argv[2:] or ["summary"]
+
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.connect(path)
+
+    mask = 0
+    for name in wanted:
+        mask |= 1 << TOPICS[name]
+    sock.sendall(struct.pack("<I", mask))
+
+    columns = []
+    while True:
+        length, topic, _, ts = HEADER.unpack(read_exact(sock, HEADER.size))
+        payload = read_exact(sock, length)
+
+        if topic == TOPICS["schema"]:
+            columns = payload.decode("utf-8").split(":", 1)[1].split(",")
+        elif topic == TOPICS["summary"]:
+            values = struct.unpack("<%df" % (length // 4), payload)
+            row = dict(zip(columns, values))
+            print(time.strftime("%H:%M:%S", time.localtime(ts)),
+                  "hr=%.1f speed=%.1f 멀미=%d" % (row.get("hr", 0), row.get("speed", 0), row.get("멀미", 0)))
+        elif topic == TOPICS["imu"]:
+            acc = struct.unpack_from("<3f", payload, 0)
+            speed, heading = struct.unpack_from("<2f", payload, 36)
+            print("imu %.3f acc=(%.2f, %.2f, %.2f) speed=%.1f heading=%.0f" % ((ts,) + acc + (speed, heading)))
+        elif topic == TOPICS["gps"]:
+            lat, lon, speed = struct.unpack_from("<ddf", payload, 0)
+            print("gps %.3f %.6f, %.6f %.1f km/h" % (ts, lat, lon, speed))
+        elif topic == TOPICS["face"]:
+            source, has_pose = struct.unpack_from("<BB", payload, 0)
+            rgb = struct.unpack_from("<3f", payload, 4)
+            print("face %.3f source=%d rgb=(%.1f, %.1f, %.1f)" % ((ts, source) + rgb))
+        elif topic == TOPICS["dropped"]:
+            print("!! %d frames dropped (too slow)" % struct.unpack("<Q", payload)[0])
+
+
+if __name__ == "__main__":
+    main()
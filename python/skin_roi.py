@@ -0,0 +1,81 @@
+import cv2
+import numpy as np
+
+# MediaPipe face mesh 랜드마크 → 피부 ROI 다각형과 평균 RGB (face_processor.py 에서 사용)
+# C++ 쪽 같은 계산은 features/skin_roi.cpp (공유메모리 프레임), 둘의 비교는 check_skin_roi.py
+
+vertices_id_face_boundary  = [ # points that enclose the face area, keep the orders, counter-clockwise, or clockwise, the first == the last
+   9,
+   336, 296, 334, 293, 301, 
+   389, 356,454,323, 361, 288, 397,365, 379, 378, 400, 377,
+   152,
+   148, 176, 149, 150, 136, 172, 58, 132, 93, 234, 127, 162,
+   71, 63, 105, 66, 107,
+   9
+]
+
+vertices_id_left_eye = [
+    33,
+    246, 161, 160,159, 158, 157, 173, 133,
+    155, 154, 153, 145, 144, 163, 7,
+    33
+]
+
+vertices_id_right_eye = [
+    362,
+    398, 384, 385, 386, 387, 388, 466, 263,
+    249, 390, 373, 374, 380, 381, 382,
+    362
+]
+
+vertices_id_lip = [
+    0,
+    267, 269, 270, 409,
+    375, 321, 405, 314, 17, 84, 181, 91, 146, 
+    185, 40, 39, 37,
+    0
+]
+
+
+def to_pixel_coords(landmarks, indices, w, h):
+    return [(int(landmarks[i*3] * w), int(landmarks[i*3+1] * h)) for i in indices]
+
+
+def get_roi_polygons(landmarks, image_shape):
+    h, w, _ = image_shape
+    return [to_pixel_coords(landmarks, ids, w, h) for ids in
+            (vertices_id_face_boundary, vertices_id_left_eye, vertices_id_right_eye, vertices_id_lip)]
+
+
+def get_average_rgb(image, landmarks, image_shape):
+    h, w, _ = image_shape
+
+    def to_pixel_coords(indices):
+        return [(int(landmarks[i*3] * w), int(landmarks[i*3+1] * h)) for i in indices]
+
+    # 마스크 정의
+    face_poly = np.array([to_pixel_coords(vertices_id_face_boundary)], dtype=np.int32)
+    eye_left_poly = np.array([to_pixel_coords(vertices_id_left_eye)], dtype=np.int32)
+    eye_right_poly = np.array([to_pixel_coords(vertices_id_right_eye)], dtype=np.int32)
+    lip_poly = np.array([to_pixel_coords(vertices_id_lip)], dtype=np.int32)
+
+    mask = np.zeros((h, w), dtype=np.uint8)
+    cv2.fillPoly(mask, face_poly, 255)
+    cv2.fillPoly(mask, eye_left_poly, 0)
+    cv2.fillPoly(mask, eye_right_poly, 0)
+    cv2.fillPoly(mask, lip_poly, 0)
+
+    masked_image = cv2.bitwise_and(image, image, mask=mask)
+
+    # Get mask of non-zero (skin) pixels
+    non_zero_mask = mask > 0
+    number_of_skin_pixels = np.count_nonzero(non_zero_mask)
+
+    if number_of_skin_pixels == 0:
+        return (0.0, 0.0, 0.0), masked_image  # fallback
+
+    r = np.sum(image[:, :, 2][non_zero_mask]) / number_of_skin_pixels
+    g = np.sum(image[:, :, 1][non_zero_mask]) / number_of_skin_pixels
+    b = np.sum(image[:, :, 0][non_zero_mask]) / number_of_skin_pixels
+
+    return (r, g, b), masked_image  # RGB, masked_image
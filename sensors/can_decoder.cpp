@@ -0,0 +1,108 @@
+#include "can_decoder.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+// 예시 배치 (python/can_simulator.py 와 같음)
+//   BO_ 160 VEHICLE_SPEED: 8   SG_ SPEED : 0|16@1+ (0.01,0) "km/h"
+//   BO_ 176 STEERING: 8        SG_ STEER_ANGLE : 7|16@0- (0.1,0) "deg"   SG_ STEER_RATE : 23|16@0- (0.1,0) "deg/s"
+//   BO_ 192 PEDALS: 8          SG_ ACCEL_PEDAL : 0|8@1+ (0.4,0) "%"     SG_ BRAKE_PRESSURE : 8|16@1+ (0.1,0) "bar"
+const std::vector<CanSignalDef> default_can_signals = {
+    {0x0A0, "SPEED", &CanData::speed, 0, 16, CanByteOrder::Intel, false, 0.01, 0.0},
+    {0x0B0, "STEER_ANGLE", &CanData::steer_angle, 7, 16, CanByteOrder::Motorola, true, 0.1, 0.0},
+    {0x0B0, "STEER_RATE", &CanData::steer_rate, 23, 16, CanByteOrder::Motorola, true, 0.1, 0.0},
+    {0x0C0, "ACCEL_PEDAL", &CanData::accel_pedal, 0, 8, CanByteOrder::Intel, false, 0.4, 0.0},
+    {0x0C0, "BRAKE_PRESSURE", &CanData::brake_pressure, 8, 16, CanByteOrder::Intel, false, 0.1, 0.0},
+};
+
+CanDecoder::CanDecoder(const std::vector<CanSignalDef>& table) {
+    std::vector<CanSignalDef> sorted(table);
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const CanSignalDef& a, const CanSignalDef& b) { return a.message_id < b.message_id; });
+
+    for (const auto& def : sorted) {
+        Signal s{};
+        s.field = def.field;
+        s.length = def.length;
+        s.big_endian = def.byte_order == CanByteOrder::Motorola;
+        s.is_signed = def.is_signed;
+        s.factor = def.factor;
+        s.offset = def.offset;
+
+        // 프레임 8바이트를 64비트 정수 하나로 읽었을 때의 LSB 위치
+        int end_byte = 0;   // 신호가 걸치는 마지막 바이트 + 1
+        bool fits = def.length >= 1 && def.length <= 64 && def.start_bit < 64;
+        if (fits && s.big_endian) {
+            // Motorola: byte 0 의 bit 7 이 맨 앞. start_bit(MSB) 를 그 순서의 위치로 바꾼 뒤 length 만큼 뒤가 LSB
+            int msb = (def.start_bit / 8) * 8 + (7 - def.start_bit % 8);
+            int lsb = msb + def.length - 1;
+            fits = lsb < 64;
+            s.shift = static_cast<uint8_t>(63 - lsb);
+            end_byte = lsb / 8 + 1;
+        } else if (fits) {
+            fits = def.start_bit + def.length <= 64;
+            s.shift = def.start_bit;
+            end_byte = (def.start_bit + def.length + 7) / 8;
+        }
+        if (!fits) {
+            std::cerr << "[CAN] Signal " << def.name << " does not fit in an 8-byte frame, ignored." << std::endl;
+            continue;
+        }
+        s.mask = def.length == 64 ? ~uint64_t{0} : (uint64_t{1} << def.length) - 1;
+
+        if (messages_.empty() || messages_.back().id != def.message_id) {
+            messages_.push_back({def.message_id, 0, static_cast<uint32_t>(signals_.size()), 0});
+        }
+        Message& m = messages_.back();
+        m.min_dlc = std::max<uint8_t>(m.min_dlc, static_cast<uint8_t>(end_byte));
+        ++m.signal_count;
+        signals_.push_back(s);
+    }
+}
+
+int CanDecoder::decode(const can_frame& frame, CanData& state) const {
+    auto it = std::lower_bound(messages_.begin(), messages_.end(), frame.can_id,
+                               [](const Message& m, canid_t id) { return m.id < id; });
+    if (it == messages_.end() || it->id != frame.can_id || frame.can_dlc < it->min_dlc) return -1;
+
+    // 짧은 프레임의 나머지 바이트는 0 (min_dlc 검사로 신호는 다 들어 있음)
+    uint64_t little = 0, big = 0;
+    for (int i = 0; i < 8; ++i) {
+        uint64_t byte = i < frame.can_dlc ? frame.data[i] : 0;
+        little |= byte << (8 * i);
+        big |= byte << (8 * (7 - i));
+    }
+
+    for (uint32_t k = 0; k < it->signal_count; ++k) {
+        const Signal& s = signals_[it->first_signal + k];
+        uint64_t raw = ((s.big_endian ? big : little) >> s.shift) & s.mask;
+        double value;
+        if (s.is_signed && s.length < 64 && (raw >> (s.length - 1)) & 1) {
+            value = static_cast<double>(static_cast<int64_t>(raw | ~s.mask));   // 부호 확장
+        } else if (s.is_signed) {
+            value = static_cast<double>(static_cast<int64_t>(raw));
+        } else {
+            value = static_cast<double>(raw);
+        }
+        state.*s.field = static_cast<float>(value * s.factor + s.offset);
+    }
+    return static_cast<int>(it - messages_.begin());
+}
+
+void CanDecoder::expire(size_t message, CanData& state) const {
+    const Message& m = messages_[message];
+    for (uint32_t k = 0; k < m.signal_count; ++k) {
+        state.*signals_[m.first_signal + k].field = std::numeric_limits<float>::quiet_NaN();
+    }
+}
+
+std::vector<can_filter> CanDecoder::filters() const {
+    std::vector<can_filter> filters;
+    filters.reserve(messages_.size());
+    for (const auto& m : messages_) {
+        canid_t id_mask = (m.id & CAN_EFF_FLAG) ? CAN_EFF_MASK : CAN_SFF_MASK;
+        filters.push_back({m.id, id_mask | CAN_EFF_FLAG | CAN_RTR_FLAG});
+    }
+    return filters;
+}
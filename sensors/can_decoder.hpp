@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <linux/can.h>
+
+#include "../include/shared_structs.hpp"
+
+// DBC 의 SG_ 한 줄 (+ 소속 BO_ 의 id). 물리값 = raw * factor + offset → CanData 의 field
+//   SG_ STEER_ANGLE : 7|16@0- (0.1,0) "deg"  →  {0x0B0, "STEER_ANGLE", &CanData::steer_angle, 7, 16, CanByteOrder::Motorola, true, 0.1, 0.0}
+enum class CanByteOrder {
+    Intel,      // @1, little endian. start_bit = LSB
+    Motorola    // @0, big endian. start_bit = MSB (DBC 비트 번호 그대로)
+};
+
+struct CanSignalDef {
+    canid_t message_id;       // 11bit. 29bit id 면 CAN_EFF_FLAG 포함
+    const char* name;
+    float CanData::* field;
+    uint8_t start_bit;
+    uint8_t length;
+    CanByteOrder byte_order;
+    bool is_signed;
+    double factor;
+    double offset;
+};
+
+// 기본 신호 표 (python/can_simulator.py 가 보내는 배치). 실차에서는 그 차의 DBC 항목으로 바꾼다
+extern const std::vector<CanSignalDef> default_can_signals;
+
+// 신호 표를 시작할 때 한 번 조회용 구조로 바꾼다: id 정렬 배열 + 신호별 shift / mask.
+// 프레임마다 이진 탐색 한 번 + 신호당 shift / mask 몇 개 (할당 없음)
+class CanDecoder {
+public:
+    // 8바이트 프레임에 안 들어가는 신호는 경고하고 뺀다
+    explicit CanDecoder(const std::vector<CanSignalDef>& table);
+
+    // 표에 있는 메시지면 state 의 해당 필드를 갱신하고 메시지 번호 (0 ~ message_count-1), 아니면 -1.
+    // DLC 가 신호 끝보다 짧은 프레임도 -1
+    int decode(const can_frame& frame, CanData& state) const;
+
+    // 메시지 하나의 필드를 NaN 으로 (끊긴 메시지)
+    void expire(size_t message, CanData& state) const;
+
+    size_t message_count() const { return messages_.size(); }
+    canid_t message_id(size_t message) const { return messages_[message].id; }
+
+    // CAN_RAW_FILTER 로 넣을 것 (메시지마다 정확히 그 id, RTR 제외)
+    std::vector<can_filter> filters() const;
+
+private:
+    struct Signal {
+        float CanData::* field;
+        uint8_t shift;           // 64비트 (Intel: little endian, Motorola: big endian) 로 읽은 값에서
+        uint8_t length;
+        bool big_endian;
+        bool is_signed;
+        uint64_t mask;
+        double factor;
+        double offset;
+    };
+    struct Message {
+        canid_t id;              // can_id 그대로 (EFF 플래그 포함)
+        uint8_t min_dlc;         // 신호가 다 들어가는 최소 길이
+        uint32_t first_signal;
+        uint32_t signal_count;
+    };
+
+    std::vector<Message> messages_;   // id 순
+    std::vector<Signal> signals_;     // 메시지별로 연속
+};
@@ -0,0 +1,159 @@
+#include "can_receiver.hpp"
+
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <net/if.h>
+#include <poll.h>
+#include <unistd.h>
+#include <linux/can/raw.h>
+
+#include "idle_monitor.hpp"
+#include "sensor_status.hpp"
+#include "sensor_registry.hpp"
+#include "../include/trace.hpp"
+#include "../include/alloc_check.hpp"
+
+CanReceiver::CanReceiver(const std::vector<CanSignalDef>& table)
+    : decoder_(table), last_seen_(decoder_.message_count(), 0.0) {
+    for (size_t i = 0; i < CAN_BATCH; ++i) {
+        iov_[i].iov_base = &frames_[i];
+        iov_[i].iov_len = sizeof(can_frame);
+        msgs_[i].msg_hdr.msg_iov = &iov_[i];
+        msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+CanReceiver::~CanReceiver() {
+    close();
+}
+
+bool CanReceiver::open(const std::string& interface) {
+    close();
+    interface_ = interface;
+
+    fd_ = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if (fd_ < 0) {
+        std::cerr << "[CAN] socket failed: " << std::strerror(errno) << std::endl;
+        sensor_status.report_error("CAN", std::strerror(errno));
+        return false;
+    }
+
+    // 신호 표에 있는 id 만 (나머지 버스 트래픽은 커널에서 버려져 깨어나지도 않는다)
+    std::vector<can_filter> filters = decoder_.filters();
+    if (setsockopt(fd_, SOL_CAN_RAW, CAN_RAW_FILTER, filters.data(),
+                   static_cast<socklen_t>(filters.size() * sizeof(can_filter))) < 0) {
+        std::cerr << "[CAN] CAN_RAW_FILTER failed: " << std::strerror(errno) << std::endl;
+    }
+    int on = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_TIMESTAMP, &on, sizeof(on));
+
+    sockaddr_can addr{};
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = static_cast<int>(if_nametoindex(interface.c_str()));
+    if (addr.can_ifindex == 0 || bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "[CAN] Failed to bind " << interface << ": " << std::strerror(errno) << std::endl;
+        sensor_status.report_error("CAN", "Failed to bind interface");
+        close();
+        return false;
+    }
+
+    std::cout << "[CAN] Listening on " << interface << " (" << filters.size() << " message ids)." << std::endl;
+    return true;
+}
+
+void CanReceiver::close() {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+}
+
+double CanReceiver::frame_time(size_t i) const {
+    const msghdr& hdr = msgs_[i].msg_hdr;
+    for (cmsghdr* c = CMSG_FIRSTHDR(&hdr); c; c = CMSG_NXTHDR(const_cast<msghdr*>(&hdr), c)) {
+        if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMP) {
+            timeval tv;
+            std::memcpy(&tv, CMSG_DATA(c), sizeof(tv));
+            return tv.tv_sec + tv.tv_usec / 1e6;
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void CanReceiver::handle_frame(const can_frame& frame, double timestamp) {
+    int message = decoder_.decode(frame, state_);
+    if (message < 0) return;
+    last_seen_[message] = timestamp;
+
+    // 신호별 최신값을 CAN_SAMPLE_RATE_HZ 로 묶는다 (메시지마다 주기가 달라서 프레임 단위로 넣으면 샘플 간격이 들쭉날쭉)
+    if (timestamp - last_emit_ < 1.0 / CAN_SAMPLE_RATE_HZ) return;
+    last_emit_ = timestamp;
+
+    for (size_t m = 0; m < last_seen_.size(); ++m) {
+        if (timestamp - last_seen_[m] > CAN_SIGNAL_TIMEOUT_SEC) decoder_.expire(m, state_);
+    }
+
+    CanData sample = state_;
+    sample.source_timestamp = timestamp;
+    sample.seq = ++seq_;
+    sensors.channel<CanSensor>().push(sample);
+}
+
+bool CanReceiver::read_available() {
+    static SteadyStateLoop steady("can.batch");
+
+    while (fd_ >= 0) {
+        for (size_t i = 0; i < CAN_BATCH; ++i) {
+            msgs_[i].msg_hdr.msg_control = control_[i].data();
+            msgs_[i].msg_hdr.msg_controllen = control_[i].size();
+        }
+
+        SteadyStateLoop::Iteration steady_iteration(steady);
+        const int64_t receive_start = trace_enabled() ? trace_now_ns() : 0;
+        int n = recvmmsg(fd_, msgs_.data(), CAN_BATCH, MSG_DONTWAIT, nullptr);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            std::cerr << "[CAN] recvmmsg on " << interface_ << " failed: " << std::strerror(errno) << std::endl;
+            sensor_status.report_error("CAN", std::strerror(errno));
+            return false;
+        }
+
+        // 얼굴이 없는 동안은 버린다. 재개 직후 summary 에 멈추기 전 샘플이 섞이지 않도록 채널도 비움
+        bool idle = idle_monitor.idle();
+        if (idle != idle_) {
+            if (idle) sensors.channel<CanSensor>().clear();
+            idle_ = idle;
+        }
+        if (!idle) {
+            const uint64_t first_seq = seq_ + 1;
+            for (int i = 0; i < n; ++i) {
+                if (msgs_[i].msg_len < sizeof(can_frame)) continue;   // CAN FD 는 켜지 않았으므로 없음
+                handle_frame(frames_[i], frame_time(i));
+            }
+            if (trace_enabled() && seq_ >= first_seq) {
+                trace_record("can.receive", receive_start, trace_now_ns(), first_seq, seq_);
+            }
+        }
+        if (static_cast<size_t>(n) < CAN_BATCH) return true;   // 다 읽음
+    }
+    return false;
+}
+
+void can_thread(std::atomic<bool>& running, std::string interface) {
+    std::cout << "[CAN Thread] Started." << std::endl;
+    trace_thread_name("can");
+
+    CanReceiver receiver;
+    if (!receiver.open(interface)) return;
+
+    pollfd pfd{receiver.fd(), POLLIN, 0};
+    while (running.load()) {
+        int ready = poll(&pfd, 1, 200);   // running 확인 주기
+        if (ready < 0 && errno != EINTR) break;
+        if (ready > 0 && !receiver.read_available()) break;
+    }
+
+    receiver.close();
+    std::cout << "[CAN Thread] Stopped." << std::endl;
+}
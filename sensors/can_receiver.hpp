@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <linux/can.h>
+
+#include "../include/shared_structs.hpp"
+#include "can_decoder.hpp"
+
+constexpr double CAN_SAMPLE_RATE_HZ = 50.0;      // CAN 채널에 넣는 샘플 (신호별 최신값 묶음)
+constexpr double CAN_SIGNAL_TIMEOUT_SEC = 0.5;   // 이만큼 안 온 메시지의 신호는 NaN
+constexpr size_t CAN_BATCH = 32;                 // recvmmsg 한 번에 받는 최대 프레임 수
+
+// SocketCAN raw 소켓 (can0, 시험은 vcan0). 신호 표에 있는 id 만 커널에서 거른다 (CAN_RAW_FILTER).
+// fd() 는 non-blocking 이라 바깥 이벤트 루프에 EPOLLIN 으로 등록할 수 있다
+class CanReceiver {
+public:
+    explicit CanReceiver(const std::vector<CanSignalDef>& table = default_can_signals);
+    ~CanReceiver();
+
+    CanReceiver(const CanReceiver&) = delete;
+    CanReceiver& operator=(const CanReceiver&) = delete;
+
+    bool open(const std::string& interface);
+    void close();
+    int fd() const { return fd_; }
+
+    // 쌓인 프레임을 recvmmsg 로 CAN_BATCH 개씩 다 읽어서 디코드. 소켓 오류면 false
+    // idle 동안은 읽어서 버리기만 한다 (커널 수신 버퍼가 넘치지 않도록)
+    bool read_available();
+
+private:
+    // 커널 수신 시각 (SO_TIMESTAMP, 벽시계 초). 없으면 지금
+    double frame_time(size_t i) const;
+    void handle_frame(const can_frame& frame, double timestamp);
+
+    CanDecoder decoder_;
+    int fd_ = -1;
+    std::string interface_;
+
+    CanData state_;                      // 신호별 최신값
+    std::vector<double> last_seen_;      // 메시지별 마지막 수신 시각
+    double last_emit_ = 0.0;
+    uint64_t seq_ = 0;
+    bool idle_ = false;
+
+    // recvmmsg 버퍼 (open 할 때 한 번 연결)
+    std::array<can_frame, CAN_BATCH> frames_{};
+    std::array<iovec, CAN_BATCH> iov_{};
+    std::array<mmsghdr, CAN_BATCH> msgs_{};
+    std::array<std::array<char, CMSG_SPACE(sizeof(timeval))>, CAN_BATCH> control_{};
+};
+
+// 스레드 모드: interface 를 열고 running 이 false 가 될 때까지 수신
+void can_thread(std::atomic<bool>& running, std::string interface);
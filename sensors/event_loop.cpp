@@ -0,0 +1,125 @@
+#include "event_loop.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+EventLoop::EventLoop() {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        std::cerr << "[EventLoop] epoll_create1 failed: " << std::strerror(errno) << std::endl;
+    }
+}
+
+EventLoop::~EventLoop() {
+    for (const auto& e : entries_) {
+        if (e->is_timer) close(e->fd);
+    }
+    if (epoll_fd_ >= 0) close(epoll_fd_);
+}
+
+bool EventLoop::add_fd(int fd, FdHandler on_readable) {
+    auto entry = std::make_unique<Entry>();
+    entry->fd = fd;
+    entry->on_readable = std::move(on_readable);
+
+    struct epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = entry.get();
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        std::cerr << "[EventLoop] Failed to add fd " << fd << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    entries_.push_back(std::move(entry));
+    return true;
+}
+
+void EventLoop::remove_fd(int fd) {
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    // 핸들러 안에서 자기 fd 를 지울 수 있다 (GPS / CAN 읽기 실패). 지금 실행 중인 클로저를 없애면 안 되고
+    // 이번 epoll_wait 배치에도 아직 남아 있을 수 있으니 표시만 하고, 배치가 끝난 뒤 run() 에서 지운다
+    for (auto& e : entries_) {
+        if (e->fd == fd && !e->is_timer) {
+            e->fd = -1;
+            e->removed = true;
+            has_removed_ = true;
+        }
+    }
+}
+
+void EventLoop::erase_removed() {
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                  [](const std::unique_ptr<Entry>& e) { return e->removed; }),
+                   entries_.end());
+    has_removed_ = false;
+}
+
+bool EventLoop::set_timer(int timer_id, double interval_sec) {
+    struct itimerspec spec{};   // 전부 0 → disarm
+    if (interval_sec > 0.0) {
+        double whole = std::floor(interval_sec);
+        spec.it_interval.tv_sec = static_cast<time_t>(whole);
+        spec.it_interval.tv_nsec = static_cast<long>((interval_sec - whole) * 1e9);
+        spec.it_value = spec.it_interval;
+    }
+    return timerfd_settime(timer_id, 0, &spec, nullptr) == 0;
+}
+
+int EventLoop::add_timer(double interval_sec, TimerHandler on_tick) {
+    int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (tfd < 0) {
+        std::cerr << "[EventLoop] timerfd_create failed: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+    set_timer(tfd, interval_sec);
+
+    auto entry = std::make_unique<Entry>();
+    entry->fd = tfd;
+    entry->is_timer = true;
+    entry->on_tick = std::move(on_tick);
+
+    struct epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = entry.get();
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, tfd, &ev) < 0) {
+        std::cerr << "[EventLoop] Failed to add timer: " << std::strerror(errno) << std::endl;
+        close(tfd);
+        return -1;
+    }
+    entries_.push_back(std::move(entry));
+    return tfd;
+}
+
+void EventLoop::run(std::atomic<bool>& running) {
+    constexpr int MAX_EVENTS = 16;
+    struct epoll_event events[MAX_EVENTS];
+
+    while (running.load()) {
+        int n = epoll_wait(epoll_fd_, events, MAX_EVENTS, 500);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "[EventLoop] epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        ++wakeups_;
+
+        for (int i = 0; i < n; ++i) {
+            Entry* e = static_cast<Entry*>(events[i].data.ptr);
+            if (e->removed) continue;
+            if (e->is_timer) {
+                uint64_t expirations = 0;
+                if (read(e->fd, &expirations, sizeof(expirations)) == sizeof(expirations) && e->on_tick) {
+                    e->on_tick(expirations);
+                }
+            } else if (e->on_readable) {
+                e->on_readable();
+            }
+        }
+        if (has_removed_) erase_removed();
+    }
+}
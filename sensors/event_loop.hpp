@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// epoll 하나에 fd 와 timerfd 를 모아 한 스레드에서 돌리는 이벤트 루프 (--reactor 모드).
+// 핸들러는 루프 스레드에서 순서대로 불리므로 오래 블록하면 안 된다.
+class EventLoop {
+public:
+    using FdHandler = std::function<void()>;
+    using TimerHandler = std::function<void(uint64_t expirations)>;   // 밀린 주기 수 포함
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    bool ok() const { return epoll_fd_ >= 0; }
+
+    // fd 가 읽을 수 있게 되면 on_readable (level-triggered, fd 소유권은 호출자)
+    bool add_fd(int fd, FdHandler on_readable);
+    // 핸들러 안에서 불러도 된다 (핸들러는 이번 epoll_wait 배치가 끝난 뒤에 없어진다)
+    void remove_fd(int fd);
+
+    // interval_sec 주기 timerfd (CLOCK_MONOTONIC). 0 이면 꺼진 채로 등록.
+    // 반환값은 set_timer 에 쓰는 timer id (실패 시 -1)
+    int add_timer(double interval_sec, TimerHandler on_tick);
+    // 주기 변경, 0 이면 끔
+    bool set_timer(int timer_id, double interval_sec);
+
+    // running 이 false 가 될 때까지 (최대 500ms 마다 확인)
+    void run(std::atomic<bool>& running);
+
+    uint64_t wakeups() const { return wakeups_; }   // epoll_wait 가 돌아온 횟수
+
+private:
+    struct Entry {
+        int fd = -1;
+        bool is_timer = false;
+        bool removed = false;   // remove_fd 됨, 배치가 끝나면 지운다
+        FdHandler on_readable;
+        TimerHandler on_tick;
+    };
+
+    void erase_removed();
+
+    int epoll_fd_ = -1;
+    std::vector<std::unique_ptr<Entry>> entries_;
+    uint64_t wakeups_ = 0;
+    bool has_removed_ = false;
+};
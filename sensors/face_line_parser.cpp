@@ -0,0 +1,235 @@
+#include "face_line_parser.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    constexpr int MAX_SKIP_DEPTH = 16;   // 모르는 키의 값 중첩 한도
+
+    struct Cursor {
+        const char* p;
+        const char* end;
+
+        void skip_ws() {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) ++p;
+        }
+        // 공백 뒤에 c 가 있으면 넘긴다
+        bool consume(char c) {
+            skip_ws();
+            if (p < end && *p == c) {
+                ++p;
+                return true;
+            }
+            return false;
+        }
+    };
+
+    // 따옴표 안쪽 범위 (이스케이프는 건너뛰기만 한다. 키 / source 이름에는 없음)
+    bool parse_string(Cursor& c, const char*& str, size_t& len) {
+        if (!c.consume('"')) return false;
+        str = c.p;
+        while (c.p < c.end && *c.p != '"') {
+            if (*c.p == '\\') ++c.p;
+            ++c.p;
+        }
+        if (c.p >= c.end) return false;
+        len = static_cast<size_t>(c.p - str);
+        ++c.p;
+        return true;
+    }
+
+    bool parse_number(Cursor& c, double& value) {
+        c.skip_ws();
+        if (c.p >= c.end) return false;
+        char* stop = nullptr;
+        value = std::strtod(c.p, &stop);   // Python json.dumps 의 NaN / Infinity 도 읽힌다
+        if (stop == c.p || stop > c.end) return false;
+        c.p = stop;
+        return true;
+    }
+
+    bool parse_literal(Cursor& c, const char* word) {
+        size_t len = std::strlen(word);
+        if (static_cast<size_t>(c.end - c.p) < len || std::memcmp(c.p, word, len) != 0) return false;
+        c.p += len;
+        return true;
+    }
+
+    bool skip_value(Cursor& c, int depth) {
+        if (depth > MAX_SKIP_DEPTH) return false;
+        c.skip_ws();
+        if (c.p >= c.end) return false;
+
+        const char* str;
+        size_t len;
+        double number;
+        switch (*c.p) {
+            case '"':
+                return parse_string(c, str, len);
+            case 't':
+                return parse_literal(c, "true");
+            case 'f':
+                return parse_literal(c, "false");
+            case 'n':
+                return parse_literal(c, "null");
+            case '[':
+                ++c.p;
+                if (c.consume(']')) return true;
+                do {
+                    if (!skip_value(c, depth + 1)) return false;
+                } while (c.consume(','));
+                return c.consume(']');
+            case '{':
+                ++c.p;
+                if (c.consume('}')) return true;
+                do {
+                    if (!parse_string(c, str, len) || !c.consume(':') || !skip_value(c, depth + 1)) return false;
+                } while (c.consume(','));
+                return c.consume('}');
+            default:
+                return parse_number(c, number);
+        }
+    }
+
+    // 숫자 배열. 앞의 capacity 개만 out 에, count 는 전체 원소 수
+    bool parse_number_array(Cursor& c, float* out, size_t capacity, size_t& count) {
+        count = 0;
+        if (!c.consume('[')) return false;
+        if (c.consume(']')) return true;
+        do {
+            double value;
+            if (!parse_number(c, value)) return false;
+            if (count < capacity) out[count] = static_cast<float>(value);
+            ++count;
+        } while (c.consume(','));
+        return c.consume(']');
+    }
+
+    bool parse_rotation(Cursor& c, FaceLine& out) {
+        if (!c.consume('[')) return false;
+        if (c.consume(']')) return true;
+        bool rows_ok = true;
+        do {
+            float row[3];
+            size_t cols = 0;
+            if (!parse_number_array(c, row, 3, cols)) return false;
+            if (out.rotation_rows < 3) {
+                rows_ok = rows_ok && cols >= 3;
+                for (size_t j = 0; j < 3 && j < cols; ++j) out.face.rotation_matrix[out.rotation_rows][j] = row[j];
+            }
+            ++out.rotation_rows;
+        } while (c.consume(','));
+        out.face.has_head_pose = rows_ok && out.rotation_rows >= 3;
+        return c.consume(']');
+    }
+
+    bool parse_blendshapes(Cursor& c, BlendshapeArray& blendshapes, size_t& count) {
+        if (!c.consume('{')) return false;
+        if (c.consume('}')) return true;
+        do {
+            const char* name;
+            size_t len;
+            double value;
+            if (!parse_string(c, name, len) || !c.consume(':') || !parse_number(c, value)) return false;
+            int index = blendshape_index(name, len);
+            if (index >= 0) blendshapes[index] = static_cast<float>(value);
+            ++count;
+        } while (c.consume(','));
+        return c.consume('}');
+    }
+
+    // "source": "passenger" 또는 1. 없으면 운전자(0) — 예전 producer 호환
+    bool parse_source(Cursor& c, int& source_id) {
+        c.skip_ws();
+        source_id = -1;
+        if (c.p < c.end && *c.p == '"') {
+            const char* name;
+            size_t len;
+            if (!parse_string(c, name, len)) return false;
+            for (int i = 0; i < MAX_FACE_SOURCES; ++i) {
+                if (std::strlen(FACE_SOURCE_NAMES[i]) == len && std::memcmp(FACE_SOURCE_NAMES[i], name, len) == 0) {
+                    source_id = i;
+                }
+            }
+            return true;
+        }
+        double value;
+        if (!parse_number(c, value)) return false;
+        if (value >= 0 && value < MAX_FACE_SOURCES && value == static_cast<int>(value)) source_id = static_cast<int>(value);
+        return true;
+    }
+
+    bool key_is(const char* key, size_t len, const char* expected) {
+        return std::strlen(expected) == len && std::memcmp(key, expected, len) == 0;
+    }
+}
+
+bool parse_face_line(const char* begin, const char* end, FaceLine& out, const char** error) {
+    out = FaceLine{};
+    Cursor c{begin, end};
+    bool has_timestamp = false;
+    const char* failure = nullptr;
+
+    if (!c.consume('{')) {
+        failure = "expected '{'";
+    } else if (!c.consume('}')) {
+        do {
+            const char* key;
+            size_t len;
+            if (!parse_string(c, key, len) || !c.consume(':')) {
+                failure = "expected key";
+                break;
+            }
+
+            bool ok;
+            size_t count = 0;
+            double value = 0.0;
+            if (key_is(key, len, "timestamp")) {
+                ok = parse_number(c, out.face.source_timestamp);
+                has_timestamp = ok;
+            } else if (key_is(key, len, "source")) {
+                ok = parse_source(c, out.face.source_id);
+            } else if (key_is(key, len, "frame_id")) {
+                ok = parse_number(c, value) && value >= 0;
+                // uint64 로 표현되는 정수일 때만 캐스트 (NaN / Inf / 1e30 / 소수는 seq = 0)
+                out.has_frame_id = ok && value < 18446744073709551616.0 && value == std::floor(value);
+                out.face.seq = out.has_frame_id ? static_cast<uint64_t>(value) : 0;
+            } else if (key_is(key, len, "capture_time")) {
+                ok = parse_number(c, out.capture_time);
+                out.has_capture_time = ok;
+            } else if (key_is(key, len, "avg_rgb")) {
+                ok = parse_number_array(c, out.face.avg_rgb.data(), 3, out.rgb_count);
+                out.face.has_rgb = out.rgb_count == 3;
+            } else if (key_is(key, len, "blendshapes")) {
+                ok = parse_blendshapes(c, out.face.blendshapes, out.blendshape_count);
+            } else if (key_is(key, len, "rotation_matrix")) {
+                ok = parse_rotation(c, out);
+            } else if (key_is(key, len, "translation_vector")) {
+                ok = parse_number_array(c, out.face.translation_vector.data(), 3, count);
+                out.face.has_translation = count >= 3;
+            } else {
+                ok = skip_value(c, 0);
+            }
+            if (!ok) {
+                failure = "malformed value";
+                break;
+            }
+        } while (c.consume(','));
+
+        if (!failure && !c.consume('}')) failure = "expected '}'";
+    }
+
+    if (!failure && !has_timestamp) failure = "missing timestamp";
+    if (!failure && out.face.source_id < 0) failure = "unknown face source";
+    if (failure && error) *error = failure;
+    return !failure;
+}
+
+bool parse_blendshape_object(const char* begin, const char* end, BlendshapeArray& blendshapes, size_t* count) {
+    Cursor c{begin, end};
+    size_t keys = 0;
+    bool ok = parse_blendshapes(c, blendshapes, keys);
+    if (count) *count = keys;
+    return ok;
+}
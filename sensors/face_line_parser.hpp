@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+#include "../include/shared_structs.hpp"
+
+// face_processor.py 가 보내는 JSON 한 줄 → FaceData (힙 할당 없음).
+// json 트리를 만들지 않고 아는 키만 그 자리에서 읽는다. 모르는 키는 값을 건너뛴다.
+//   {"timestamp": .., "source": "driver" | 0, "frame_id": .., "capture_time": ..,
+//    "blendshapes": {"eyeBlinkLeft": .., ...}, "avg_rgb": [r, g, b],
+//    "rotation_matrix": [[..], [..], [..]], "translation_vector": [x, y, z]}
+struct FaceLine {
+    FaceData face;               // source_id 까지 채워짐
+    bool has_frame_id = false;   // face.seq = frame_id
+    bool has_capture_time = false;
+    double capture_time = 0.0;   // producer 벽시계, 카메라 캡처 시각
+    size_t rgb_count = 0;        // 받은 원소 수 (빈 배열이면 0 → 공유메모리 프레임에서 계산)
+    size_t blendshape_count = 0; // 받은 키 수 (모르는 이름 포함)
+    size_t rotation_rows = 0;
+};
+
+// [begin, end) 는 개행 없는 한 줄이고, end 뒤에 숫자가 아닌 문자 (개행 / NUL) 가 있어야 한다 (strtod 가 멈추도록).
+// 문법 오류, timestamp 없음, 모르는 source 면 false 와 error (문자열 상수)
+bool parse_face_line(const char* begin, const char* end, FaceLine& out, const char** error);
+
+// blendshapes 객체 하나 {"eyeBlinkLeft": .., ...} 만 (DB face.blendshapes 컬럼). 아는 이름만 blendshapes 에 쓰고
+// 다른 칸은 건드리지 않는다. end 조건은 parse_face_line 과 같다. 문법 오류면 false
+bool parse_blendshape_object(const char* begin, const char* end, BlendshapeArray& blendshapes, size_t* count = nullptr);
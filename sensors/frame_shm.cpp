@@ -0,0 +1,121 @@
+#include "frame_shm.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../features/skin_roi.hpp"
+
+namespace {
+    double now_seconds() {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    uint32_t load_seq(const FrameShmSlotHeader* slot) {
+        return __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+    }
+}
+
+FrameShmReader::~FrameShmReader() {
+    close_shm();
+}
+
+void FrameShmReader::close_shm() {
+    if (base_) munmap(base_, size_);
+    base_ = nullptr;
+    size_ = 0;
+}
+
+bool FrameShmReader::try_open() {
+    if (base_) return true;
+
+    // Python 쪽이 아직 안 떴을 수 있으니 1초에 한 번만 재시도
+    double now = now_seconds();
+    if (now - last_open_attempt_ < 1.0) return false;
+    last_open_attempt_ = now;
+
+    int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FrameShmHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+
+    base_ = static_cast<uint8_t*>(p);
+    size_ = st.st_size;
+
+    const auto* header = reinterpret_cast<const FrameShmHeader*>(base_);
+    if (header->magic != FRAME_SHM_MAGIC || header->version != FRAME_SHM_VERSION ||
+        header->slot_count == 0 ||
+        sizeof(FrameShmHeader) + static_cast<size_t>(header->slot_count) * header->slot_size > size_) {
+        std::cerr << "[FrameShm] Unexpected shared memory layout, ignoring." << std::endl;
+        close_shm();
+        return false;
+    }
+
+    std::cout << "[FrameShm] Attached " << name_ << " (" << header->slot_count << " slots, "
+              << header->max_width << "x" << header->max_height << ")." << std::endl;
+    return true;
+}
+
+bool FrameShmReader::mean_skin_rgb(uint64_t frame_id, std::array<float, 3>& avg_rgb) {
+    if (!try_open()) return false;
+
+    const auto* header = reinterpret_cast<const FrameShmHeader*>(base_);
+    const uint8_t* slot_base = base_ + sizeof(FrameShmHeader) +
+        static_cast<size_t>(frame_id % header->slot_count) * header->slot_size;
+    const auto* slot = reinterpret_cast<const FrameShmSlotHeader*>(slot_base);
+
+    uint32_t seq = load_seq(slot);
+    if ((seq & 1u) || slot->frame_id != frame_id) {   // 쓰는 중이거나 이미 다른 프레임
+        if (++consecutive_misses_ > 30) {
+            close_shm();
+            consecutive_misses_ = 0;
+        }
+        return false;
+    }
+
+    const uint32_t width = slot->width;
+    const uint32_t height = slot->height;
+    const uint32_t stride = slot->stride;
+    if (width == 0 || height == 0 || stride < width * 3 ||
+        FRAME_SHM_PIXEL_OFFSET + static_cast<size_t>(stride) * height > header->slot_size) {
+        return false;
+    }
+
+    // 다각형은 작으니 복사해두고, 픽셀은 공유메모리에서 바로 읽는다
+    int16_t points[FRAME_SHM_MAX_POINTS * 2];
+    PolygonI16 polys[SHM_POLY_COUNT];
+    size_t offset = 0;
+    for (int p = 0; p < SHM_POLY_COUNT; ++p) {
+        size_t count = slot->poly_counts[p];
+        if (offset + count > FRAME_SHM_MAX_POINTS) return false;
+        for (size_t i = 0; i < count * 2; ++i) points[offset * 2 + i] = slot->points[offset * 2 + i];
+        polys[p] = {points + offset * 2, count};
+        offset += count;
+    }
+
+    double rgb[3];
+    size_t n = skin_roi_mean_rgb(slot_base + FRAME_SHM_PIXEL_OFFSET,
+                                 static_cast<int>(width), static_cast<int>(height), static_cast<int>(stride),
+                                 polys[SHM_POLY_FACE], &polys[SHM_POLY_LEFT_EYE], 3, rgb);
+
+    // 계산하는 동안 producer 가 슬롯을 덮어썼으면 버린다
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (load_seq(slot) != seq) return false;
+
+    consecutive_misses_ = 0;
+    if (n == 0) return false;   // 피부 픽셀 없음 (Python fallback 처럼 0 을 넣지 않는다)
+    avg_rgb = {static_cast<float>(rgb[0]), static_cast<float>(rgb[1]), static_cast<float>(rgb[2])};
+    return true;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/shared_structs.hpp"
+
+// Python face_processor 가 카메라 프레임과 피부 ROI 다각형을 올려두는 공유메모리.
+// 레이아웃은 python/face_processor.py 의 FrameShmWriter 와 반드시 같아야 한다 (little-endian).
+//
+//   [FrameShmHeader 64B][slot 0][slot 1]...
+//   slot = [FrameShmSlotHeader][padding → FRAME_SHM_PIXEL_OFFSET][BGR8 pixels]
+//
+// 슬롯은 frame_id % slot_count 로 고르고, seq 는 seqlock (홀수 = 쓰는 중).
+
+constexpr const char* FRAME_SHM_NAME = "/motionsick_frames";   // /dev/shm/motionsick_frames
+constexpr uint32_t FRAME_SHM_MAGIC = 0x5246534D;              // "MSFR"
+constexpr uint32_t FRAME_SHM_VERSION = 1;
+constexpr int FRAME_SHM_MAX_POINTS = 128;                     // 다각형 4개 꼭짓점 합
+constexpr size_t FRAME_SHM_PIXEL_OFFSET = 576;
+
+// source 0 은 기존 이름 그대로, 나머지는 "/motionsick_frames_<source name>"
+inline std::string frame_shm_name(int source_id) {
+    if (source_id == 0) return FRAME_SHM_NAME;
+    return std::string(FRAME_SHM_NAME) + "_" + FACE_SOURCE_NAMES[source_id];
+}
+
+// 다각형 순서: face 외곽, 왼눈, 오른눈, 입술 (뒤 3개는 제외 영역)
+enum FrameShmPolygon { SHM_POLY_FACE = 0, SHM_POLY_LEFT_EYE, SHM_POLY_RIGHT_EYE, SHM_POLY_LIP, SHM_POLY_COUNT };
+
+#pragma pack(push, 1)
+struct FrameShmHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size;
+    uint32_t max_width;
+    uint32_t max_height;
+    uint8_t reserved[40];
+};
+
+struct FrameShmSlotHeader {
+    uint32_t seq;
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;          // bytes per row
+    uint64_t frame_id;
+    double timestamp;
+    uint16_t poly_counts[SHM_POLY_COUNT];
+    int16_t points[FRAME_SHM_MAX_POINTS * 2];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(FrameShmHeader) == 64, "shm header layout");
+static_assert(sizeof(FrameShmSlotHeader) <= FRAME_SHM_PIXEL_OFFSET, "shm slot layout");
+
+class FrameShmReader {
+public:
+    explicit FrameShmReader(std::string name = FRAME_SHM_NAME) : name_(std::move(name)) {}
+    ~FrameShmReader();
+
+    FrameShmReader(const FrameShmReader&) = delete;
+    FrameShmReader& operator=(const FrameShmReader&) = delete;
+
+    // frame_id 슬롯의 피부 ROI 평균 RGB 를 avg_rgb 에 [r, g, b] 로 채운다.
+    // 공유메모리가 없거나, 슬롯이 이미 다음 프레임으로 덮였거나, 피부 픽셀이 없으면 false (avg_rgb 는 그대로).
+    bool mean_skin_rgb(uint64_t frame_id, std::array<float, 3>& avg_rgb);
+
+private:
+    bool try_open();
+    void close_shm();
+
+    std::string name_;
+    uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+    double last_open_attempt_ = 0.0;
+    int consecutive_misses_ = 0;   // 많이 놓치면 producer 재시작으로 보고 다시 붙는다
+};
@@ -8,23 +8,29 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <termios.h>
-#include <sstream>
+#include <cstdlib>
 #include <cmath>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 
 #include "gps_thread.hpp"
 #include "../include/shared_structs.hpp"
+#include "../features/gps_kinematics.hpp"
+#include "sensor_status.hpp"
+#include "../logger/feature_publisher.hpp"
+#include "../include/trace.hpp"
+#include "../include/alloc_check.hpp"
+#include "sensor_registry.hpp"
 
 const char* GPS_SERIAL_DEV = "/dev/ttyAMA0";
 int gps_fd = -1;
 
-std::vector<GpsData> gps_buffer;
-std::mutex gps_buffer_mutex;
-const int GPS_BUFFER_MAX_SIZE = 10 * 10;
-
 bool open_gps_serial() {
     gps_fd = open(GPS_SERIAL_DEV, O_RDWR | O_NOCTTY | O_NDELAY);
     if (gps_fd == -1) {
         perror("Failed to open GPS serial port");
+        sensor_status.report_error("GPS", "Failed to open serial port");
         return false;
     }
 
@@ -45,77 +51,144 @@ bool open_gps_serial() {
     return true;
 }
 
-std::string read_line_from_gps() {
-    char c;
-    std::string line;
-    while (read(gps_fd, &c, 1) == 1) {
-        if (c == '\n') break;
-        if (c != '\r') line += c;
+namespace {
+    constexpr size_t MAX_NMEA_FIELDS = 20;   // $GPRMC 는 13개
+
+    // 콤마로 나뉜 필드 하나 (줄 안을 가리킴)
+    struct NmeaField {
+        const char* ptr = nullptr;
+        size_t len = 0;
+
+        bool is(const char* text) const { return std::strlen(text) == len && std::memcmp(ptr, text, len) == 0; }
+    };
+
+    // 숫자 필드 → double. 비었거나 숫자가 아니면 false
+    bool parse_nmea_number(const NmeaField& field, double& value) {
+        char buf[32];
+        if (field.len == 0 || field.len >= sizeof(buf)) return false;
+        std::memcpy(buf, field.ptr, field.len);
+        buf[field.len] = '\0';
+        char* stop = nullptr;
+        value = std::strtod(buf, &stop);
+        return stop != buf;
+    }
+
+    // ddmm.mmmm + 방향 → 십진 도. 좌표가 비었으면 0 (예전 동작), 숫자가 아니면 false
+    bool nmea_to_decimal(const NmeaField& coord, const NmeaField& dir, double& decimal) {
+        decimal = 0.0;
+        if (coord.len == 0) return true;
+        double raw;
+        if (!parse_nmea_number(coord, raw)) return false;
+        int deg = static_cast<int>(raw / 100);
+        double min = raw - deg * 100;
+        decimal = deg + min / 60.0;
+        if (dir.is("S") || dir.is("W")) decimal *= -1;
+        return true;
     }
-    return line;
 }
 
-double nmea_to_decimal(const std::string& coord, const std::string& dir) {
-    if (coord.empty()) return 0.0;
-    double raw = std::stod(coord);
-    int deg = static_cast<int>(raw / 100);
-    double min = raw - deg * 100;
-    double decimal = deg + min / 60.0;
-    if (dir == "S" || dir == "W") decimal *= -1;
-    return decimal;
+// $GPRMC 한 줄 처리 → 버퍼에 저장 (힙 할당 없음)
+void gps_process_sentence(const std::string& line, GpsKinematics& kinematics) {
+    if (line.find("$GPRMC") == std::string::npos) return;
+
+    static SteadyStateLoop steady("gps.sentence");
+    SteadyStateLoop::Iteration steady_iteration(steady);
+
+    NmeaField fields[MAX_NMEA_FIELDS];
+    size_t field_count = 0;
+    const char* p = line.data();
+    const char* end = p + line.size();
+    while (field_count < MAX_NMEA_FIELDS) {
+        const char* comma = static_cast<const char*>(std::memchr(p, ',', end - p));
+        const char* field_end = comma ? comma : end;
+        fields[field_count++] = {p, static_cast<size_t>(field_end - p)};
+        if (!comma) break;
+        p = comma + 1;
+    }
+
+    if (field_count > 8 && fields[2].is("A")) {
+        static uint64_t gps_seq = 0;   // 한 스레드에서만 호출
+        GpsData data;
+        data.seq = ++gps_seq;
+        TraceSpan parse_span("gps.parse", data.seq);
+        data.source_timestamp = std::chrono::duration<double>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        double knots;
+        if (!nmea_to_decimal(fields[3], fields[4], data.lat) ||
+            !nmea_to_decimal(fields[5], fields[6], data.lon) ||
+            !parse_nmea_number(fields[7], knots)) {
+            std::cerr << "[GPS] Malformed sentence skipped" << std::endl;
+            sensor_status.report_error("GPS", "Malformed sentence");
+            return;
+        }
+        data.speed = knots * 1.852;  // knots to km/h
+        kinematics.update(data);  // ENU, heading, 가속도 (fix 당 O(1))
+        sensor_status.gps_fix();
+        feature_publisher.publish(data);
+
+        sensors.channel<GpsSensor>().push(data);
+
+        std::cout << "[GPS] FIXED: Lat=" << data.lat
+                      << ", Lon=" << data.lon
+                      << ", Speed=" << data.speed << " km/h" << std::endl;
+    } else {
+        std::cout << "[GPS] No fix yet (status = V)" << std::endl;
+    }
 }
 
-void gps_thread(ThreadSafeQueue<GpsData>& gps_queue, std::atomic<bool>& running) {
+bool gps_read_available(std::string& partial, GpsKinematics& kinematics) {
+    char temp[GPS_READ_CHUNK];
+    while (true) {
+        ssize_t n = read(gps_fd, temp, sizeof(temp));
+        if (n == 0) break;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            int err = errno;
+            perror("[GPS] read");
+            sensor_status.report_error("GPS", std::strerror(err));
+            return false;
+        }
+
+        for (ssize_t i = 0; i < n; ++i) {
+            char c = temp[i];
+            if (c == '\n') {
+                gps_process_sentence(partial, kinematics);
+                partial.clear();
+            } else if (c != '\r') {
+                partial += c;
+            }
+        }
+        if (partial.size() > GPS_MAX_LINE) partial.clear();  // 개행 없는 쓰레기 입력
+    }
+    return true;
+}
+
+void gps_close_serial() {
+    if (gps_fd >= 0) close(gps_fd);
+    gps_fd = -1;
+}
+
+void gps_thread(std::atomic<bool>& running) {
     std::cout << "[GPS Thread] Started." << std::endl;
+    trace_thread_name("gps");
 
     if (!open_gps_serial()) {
         std::cerr << "[GPS Thread] Failed to open serial port." << std::endl;
         return;
     }
 
-    while (running.load()) {
-        std::string line = read_line_from_gps();
-
-        if (line.find("$GPRMC") != std::string::npos) {
-            std::stringstream ss(line);
-            std::string field;
-            std::vector<std::string> fields;
+    GpsKinematics kinematics;
+    std::string partial;   // 다음 read 로 이어지는 줄 조각
+    partial.reserve(GPS_PARTIAL_RESERVE);
 
-            while (std::getline(ss, field, ',')) {
-                fields.push_back(field);
-            }
-
-            if (fields.size() > 8 && fields[2] == "A") {
-                GpsData data;
-                data.source_timestamp = std::chrono::duration<double>(
-                    std::chrono::system_clock::now().time_since_epoch()).count();
-
-                data.lat = nmea_to_decimal(fields[3], fields[4]);
-                data.lon = nmea_to_decimal(fields[5], fields[6]);
-                data.speed = std::stod(fields[7]) * 1.852;  // knots to km/h
-
-                {
-                    std::lock_guard<std::mutex> lock(gps_buffer_mutex);
-                    gps_buffer.push_back(data);
-                    if (gps_buffer.size() > GPS_BUFFER_MAX_SIZE)
-                        gps_buffer.erase(gps_buffer.begin());
-                }
-
-                gps_queue.push(data);  // optional if you want to push to logger
-                std::cout << "[GPS] FIXED: Lat=" << data.lat
-                              << ", Lon=" << data.lon
-                              << ", Speed=" << data.speed << " km/h" << std::endl;
-            } else {
-                std::cout << "[GPS] No fix yet (status = V)" << std::endl;
-            }
-        } 
-        // else {
-        //     std::cout << "[GPS] Incomplete $GNRMC sentence skipped." << std::endl;
-        // }
+    while (running.load()) {
+        if (!gps_read_available(partial, kinematics)) break;
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));  // ~50Hz check
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));  // ~10Hz check
     }
 
-    close(gps_fd);
+    gps_close_serial();
     std::cout << "[GPS Thread] Stopped." << std::endl;
 }
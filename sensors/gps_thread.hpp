@@ -1,6 +1,20 @@
 #pragma once
 #include <atomic>
-#include "threadsafe_queue.hpp"
+#include <string>
 #include "../include/shared_structs.hpp"
+#include "../features/gps_kinematics.hpp"
 
-void gps_thread(ThreadSafeQueue<GpsData>& gps_queue, std::atomic<bool>& running);
\ No newline at end of file
+extern int gps_fd;
+
+void gps_thread(std::atomic<bool>& running);
+
+// 이벤트 루프 모드에서도 쓰는 조각들 (gps_thread 는 이걸 100ms 마다 호출)
+bool open_gps_serial();   // gps_fd 를 non-blocking 으로 연다
+void gps_close_serial();
+// gps_fd 에서 읽을 수 있는 만큼 읽고 완성된 NMEA 줄을 처리. 읽기 오류면 false
+// partial 은 다음 read 로 이어지는 줄 조각. 미리 GPS_PARTIAL_RESERVE 만큼 reserve 해두면 줄마다 할당하지 않는다
+bool gps_read_available(std::string& partial, GpsKinematics& kinematics);
+
+constexpr size_t GPS_READ_CHUNK = 256;
+constexpr size_t GPS_MAX_LINE = 1024;    // 개행 없이 이보다 길면 쓰레기 입력으로 버림
+constexpr size_t GPS_PARTIAL_RESERVE = GPS_MAX_LINE + GPS_READ_CHUNK;
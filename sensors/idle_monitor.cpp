@@ -0,0 +1,64 @@
+#include "idle_monitor.hpp"
+
+#include <iostream>
+
+#include "../include/shared_structs.hpp"
+
+IdleMonitor idle_monitor;
+
+void IdleMonitor::face_detected(double now) {
+    last_face_detected_time.store(now);
+    if (idle()) set_idle(false);
+}
+
+bool IdleMonitor::refresh(double now) {
+    if (!idle() && now - last_face_detected_time.load() > timeout_sec_) {
+        set_idle(true);
+    }
+    return idle();
+}
+
+void IdleMonitor::set_idle(bool idle) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idle_.load() == idle) return;
+        idle_.store(idle, std::memory_order_release);
+        transitions_.fetch_add(1, std::memory_order_acq_rel);
+    }
+    if (!idle) active_cv_.notify_all();
+
+    if (idle) {
+        std::cout << "[Idle] No face for " << timeout_sec_ << " s → idle (IMU / DB / CSV paused)." << std::endl;
+    } else {
+        std::cout << "[Idle] Face detected → active." << std::endl;
+    }
+}
+
+bool IdleMonitor::wait_until_active() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    active_cv_.wait(lock, [this] { return !idle_.load() || stopped_; });
+    return !stopped_;
+}
+
+void IdleMonitor::wake() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        woken_ = true;
+    }
+    active_cv_.notify_all();
+}
+
+bool IdleMonitor::wait_until_active_or_woken() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    active_cv_.wait(lock, [this] { return !idle_.load() || stopped_ || woken_; });
+    woken_ = false;
+    return !stopped_;
+}
+
+void IdleMonitor::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    active_cv_.notify_all();
+}
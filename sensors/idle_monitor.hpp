@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+// 얼굴 감지 기준 ACTIVE ↔ IDLE 상태 머신.
+// - 마지막 얼굴 이후 timeout(60초) 이 지나면 IDLE: IMU 샘플링, DB/CSV 단계가 condition variable 에서 잠들고
+//   face producer 에는 frame rate 를 낮추라고 알린다.
+// - 얼굴이 다시 들어오면 그 프레임을 받는 즉시 ACTIVE 로 돌아가 대기 중인 스레드를 깨운다.
+class IdleMonitor {
+public:
+    explicit IdleMonitor(double timeout_sec = 60.0) : timeout_sec_(timeout_sec) {}
+
+    // 얼굴이 감지된 프레임마다 호출 (socket receiver). last_face_detected_time 도 갱신
+    void face_detected(double now);
+
+    // timeout 이 지났으면 IDLE 로 전환. 현재 idle 여부 반환
+    bool refresh(double now);
+
+    bool idle() const { return idle_.load(std::memory_order_acquire); }
+
+    // ACTIVE 가 될 때까지 블록 (이미 ACTIVE 면 바로 반환). shutdown() 되면 false
+    bool wait_until_active();
+
+    // idle 중에도 처리할 일이 생겼을 때 (토글 클릭) wait_until_active_or_woken 으로 자는 스레드를 한 번 깨운다
+    void wake();
+
+    // ACTIVE 가 되거나 wake() 가 오면 반환 (DB 스레드: idle 중에도 토글은 기록). shutdown() 되면 false
+    bool wait_until_active_or_woken();
+
+    // 대기 중인 스레드를 모두 풀어준다 (종료 시)
+    void shutdown();
+
+    // 상태가 바뀔 때마다 증가 — producer 알림 등 "바뀌었는지" 확인용
+    uint64_t transitions() const { return transitions_.load(std::memory_order_acquire); }
+
+private:
+    void set_idle(bool idle);
+
+    const double timeout_sec_;
+    std::atomic<bool> idle_{true};   // 시작 시에는 얼굴이 들어올 때까지 IDLE
+    std::atomic<uint64_t> transitions_{0};
+    bool stopped_ = false;
+    bool woken_ = false;
+    std::mutex mutex_;
+    std::condition_variable active_cv_;
+};
+
+extern IdleMonitor idle_monitor;
@@ -0,0 +1,39 @@
+#include "imu_raw_ring.hpp"
+
+#include <cstdio>
+#include <iostream>
+
+ImuRawRing imu_raw_ring;
+
+void ImuRawRing::allocate(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    samples_.assign(capacity, ImuRawSample{});
+    next_ = 0;
+    count_ = 0;
+}
+
+void ImuRawRing::push(const ImuRawSample& sample) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (samples_.empty()) return;
+    samples_[next_] = sample;
+    next_ = next_ + 1 == samples_.size() ? 0 : next_ + 1;
+    if (count_ < samples_.size()) ++count_;
+}
+
+bool ImuRawRing::write_csv(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        std::cerr << "[IMU] Failed to write " << path << std::endl;
+        return false;
+    }
+    std::fprintf(f, "timestamp,ax,ay,az\n");
+    const size_t start = (next_ + samples_.size() - count_) % (samples_.empty() ? 1 : samples_.size());
+    for (size_t i = 0; i < count_; ++i) {
+        const ImuRawSample& s = samples_[(start + i) % samples_.size()];
+        std::fprintf(f, "%.4f,%.4f,%.4f,%.4f\n", s.timestamp, s.accel[0], s.accel[1], s.accel[2]);
+    }
+    std::fclose(f);
+    std::cout << "[IMU] Wrote " << count_ << " raw samples to " << path << std::endl;
+    return true;
+}
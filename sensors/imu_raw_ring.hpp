@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// --imu-oversample 로 읽은 decimate 전 가속도 (진동 분석용)
+struct ImuRawSample {
+    double timestamp = 0.0;           // 벽시계 초
+    std::array<float, 3> accel{};     // m/s², ImuData::accel 과 같은 축
+};
+
+// 최근 샘플만 고정 크기 링에 보관 (--imu-raw=PATH 일 때 종료하면서 CSV 로).
+// 크기는 시작할 때 한 번 정하고 push 는 할당하지 않는다. 쓰는 쪽은 IMU 스레드 하나
+class ImuRawRing {
+public:
+    void allocate(size_t capacity);
+    bool enabled() const { return !samples_.empty(); }
+
+    void push(const ImuRawSample& sample);
+
+    // timestamp,ax,ay,az (오래된 것부터)
+    bool write_csv(const std::string& path) const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<ImuRawSample> samples_;
+    size_t next_ = 0;
+    size_t count_ = 0;
+};
+
+extern ImuRawRing imu_raw_ring;
@@ -2,90 +2,68 @@
 #include <thread>
 #include <chrono>
 #include <cmath>
+#include <ctime>
+#include <cstdio>
+#include <array>
+#include <vector>
 
 #include <linux/i2c-dev.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
 
-#include <deque>
-#include <numeric>  // For std::accumulate
-
-
-
 #include "imu_thread.hpp"
 #include "../include/shared_structs.hpp"
+#include "../features/msdv.hpp"
+#include "../features/fir_decimator.hpp"
+#include "idle_monitor.hpp"
+#include "imu_raw_ring.hpp"
+#include "sensor_status.hpp"
+#include "../logger/feature_publisher.hpp"
+#include "../include/trace.hpp"
+#include "../include/alloc_check.hpp"
+#include "sensor_registry.hpp"
 
 const int BNO055_ADDR = 0x28;
 const char *I2C_DEV_PATH = "/dev/i2c-1";
 
 int i2c_fd = -1;
+bool i2c_read_failed = false;   // 이번 샘플에서 I2C 읽기가 한 번이라도 실패했는지
 
 int16_t read16(uint8_t reg) {
-    uint8_t buf[2];
-    write(i2c_fd, &reg, 1);
-    read(i2c_fd, buf, 2);
+    uint8_t buf[2] = {0, 0};
+    if (write(i2c_fd, &reg, 1) != 1 || read(i2c_fd, buf, 2) != 2) {
+        i2c_read_failed = true;
+    }
     return (int16_t)(buf[0] | (buf[1] << 8));
 }
 
-std::vector<ImuData> imu_buffer;
-std::mutex imu_buffer_mutex;
-const int IMU_BUFFER_MAX_SIZE = 50 * 10;
-
-void imu_thread(ThreadSafeQueue<ImuData>& imu_queue, std::atomic<bool>& running) {
-    std::cout << "[IMU Thread] Started." << std::endl;
-
-    i2c_fd = open(I2C_DEV_PATH, O_RDWR);
-    if (i2c_fd < 0 || ioctl(i2c_fd, I2C_SLAVE, BNO055_ADDR) < 0) {
-        std::cerr << "Failed to open BNO055 I2C device." << std::endl;
-        return;
-    }
-
-    // Set to NDOF mode (optional, depends on your Python config)
-    uint8_t opmode_reg[2] = {0x3D, 0x0C}; // NDOF
-    write(i2c_fd, opmode_reg, 2);
-    std::this_thread::sleep_for(std::chrono::milliseconds(20));
-
-    // Sampling rate check
-    std::deque<double> interval_buffer;
-    const int max_samples = 100;
-    auto last_time = std::chrono::high_resolution_clock::now();
-
-    while (running.load()) {
-        // auto now = std::chrono::high_resolution_clock::now();
-        // std::chrono::duration<double> interval = now - last_time;
-        // last_time = now;
-
-        // interval_buffer.push_back(interval.count());
-        // if (interval_buffer.size() > max_samples)
-        //     interval_buffer.pop_front();
-
-        // // Print average rate every 1 second
-        // if (interval_buffer.size() == max_samples) {
-        //     double avg_interval = std::accumulate(interval_buffer.begin(), interval_buffer.end(), 0.0) / interval_buffer.size();
-        //     double effective_hz = 1.0 / avg_interval;
-        //     std::cout << "[IMU] Effective Sampling Rate: " << effective_hz << " Hz" << std::endl;
-        // }
-
-        ImuData data;
-
-        // 현재 시간 기록 (초 단위)
-        data.source_timestamp = std::chrono::duration<double>(
-            std::chrono::system_clock::now().time_since_epoch()
-        ).count();
+bool write8(uint8_t reg, uint8_t value) {
+    uint8_t buf[2] = {reg, value};
+    return write(i2c_fd, buf, 2) == 2;
+}
 
-        // Read linear acceleration (registers: 0x28 to 0x2D)
-        int16_t ax = read16(0x08);
-        int16_t ay = read16(0x0A);
-        int16_t az = read16(0x0C);
+namespace {
+    // 가속도 레지스터 6바이트를 한 번에 (축 변환은 예전 read16 세 번과 같음)
+    void read_accel(std::array<float, 3>& accel) {
+        uint8_t reg = 0x08;
+        uint8_t buf[6] = {0, 0, 0, 0, 0, 0};
+        if (write(i2c_fd, &reg, 1) != 1 || read(i2c_fd, buf, 6) != 6) {
+            i2c_read_failed = true;
+        }
+        int16_t ax = (int16_t)(buf[0] | (buf[1] << 8));
+        int16_t ay = (int16_t)(buf[2] | (buf[3] << 8));
+        int16_t az = (int16_t)(buf[4] | (buf[5] << 8));
 
         // Transform acceleration to match your Python coordinate logic
-        data.accel = {
+        accel = {
             static_cast<float>(-az) / 100.0f,  // device x
             static_cast<float>(-ax) / 100.0f,   // device y
             static_cast<float>(ay) / 100.0f  // device z
         };
+    }
 
+    void read_gyro(std::array<float, 3>& gyro) {
         // Read raw gyro values (X, Y, Z)
         int16_t gyro_x_raw = read16(0x14);  // Gyro X (Pitch)
         int16_t gyro_y_raw = read16(0x16);  // Gyro Y (Roll)
@@ -101,27 +79,285 @@ void imu_thread(ThreadSafeQueue<ImuData>& imu_queue, std::atomic<bool>& running)
         float device_y_rate = -pitch_rate;       // Y: 회전축 X (Pitch)
         float device_z_rate = roll_rate;       // Z: 회전축 Y (Roll → 반전 필요)
 
-        // Store heading instead of gyro
-        data.gyro = {device_x_rate, device_y_rate, device_z_rate};
-        
-        // // Print accel values
-        // std::cout << "Accel (X, Y, Z): ";
-        // for (const auto& a : data.accel) {
-        //     std::cout << a << " ";
-        // }
-        // std::cout << std::endl;
-
-        {
-            std::lock_guard<std::mutex> lock(imu_buffer_mutex);
-            imu_buffer.push_back(data);
-            if (imu_buffer.size() > IMU_BUFFER_MAX_SIZE) {
-                imu_buffer.erase(imu_buffer.begin()); // 오래된 것 제거
+        gyro = {device_x_rate, device_y_rate, device_z_rate};
+    }
+
+    double wall_now() {
+        return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // 읽은 샘플의 나머지: 상태판, MSDV, GPS 융합, 스펙트럼, pub/sub, IMU 채널
+    void finish_sample(ImuData& data, MsdvAccumulator& msdv, GpsImuFusion& fusion, MotionSpectrum& spectrum) {
+        // UI 상태판: 정상 샘플만 센다 (실패가 이어지면 IMU 표시등이 꺼짐)
+        if (i2c_read_failed) {
+            sensor_status.report_error("IMU", "I2C read failed");
+        } else {
+            sensor_status.imu_sample();
+        }
+
+        msdv.process(data);
+
+        // 지난 샘플 이후 들어온 GPS fix 로 보정 (같은 fix 는 fusion 이 무시) 후 이 샘플까지 적분
+        static GpsData fix;
+        if (sensors.channel<GpsSensor>().latest(fix)) fusion.correct(fix);
+        fusion.process(data);
+
+        spectrum.process(data);   // segment 가 끝나는 샘플 (10 s 마다) 만 FFT
+
+        feature_publisher.publish(data);
+
+        sensors.channel<ImuSensor>().push(data);
+    }
+
+    // 출력 주기로 읽은 자이로를 FIR 지연 (출력 샘플 단위) 만큼 늦춰서 같은 ImuData 의 가속도와 같은 시점으로 맞춘다
+    class GyroDelayLine {
+    public:
+        explicit GyroDelayLine(size_t delay) : slots_(delay + 1) {}
+
+        // delay 출력 전에 넣은 값을 out 에. 그만큼 차기 전에는 false
+        bool push(const std::array<float, 3>& in, std::array<float, 3>& out) {
+            slots_[pos_] = in;
+            pos_ = (pos_ + 1) % slots_.size();
+            if (filled_ < slots_.size()) ++filled_;
+            if (filled_ < slots_.size()) return false;
+            out = slots_[pos_];   // 가장 오래된 값
+            return true;
+        }
+        void reset() { pos_ = filled_ = 0; }
+
+    private:
+        std::vector<std::array<float, 3>> slots_;
+        size_t pos_ = 0;
+        size_t filled_ = 0;
+    };
+
+    // --imu-oversample 구간별 비용 (IMU 스레드가 쓰고 --stats 스레드가 읽음)
+    struct OversampleStats {
+        std::atomic<uint64_t> outputs{0};
+        std::atomic<uint64_t> cpu_ns{0};       // 출력 하나당 스레드 CPU 시간 (원시 읽기 factor 번 + 필터) 합
+        std::atomic<uint64_t> max_cpu_ns{0};
+        std::atomic<uint64_t> filter_ns{0};    // 그 중 FIR 계산
+        std::atomic<uint64_t> overruns{0};     // 원시 주기를 놓친 횟수
+        double raw_rate_hz = 0.0;
+        size_t taps = 0;
+    };
+    OversampleStats oversample_stats;
+
+    int64_t thread_cpu_ns() {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    int64_t steady_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // BNO055: CONFIG 모드 → page 1 ACC_Config (±4g, bandwidth = raw/2, normal power) → AMG 모드
+    bool configure_oversampling(double raw_rate_hz) {
+        uint8_t bandwidth;
+        if (raw_rate_hz == 500.0) bandwidth = 0x05;        // 250 Hz
+        else if (raw_rate_hz == 1000.0) bandwidth = 0x06;  // 500 Hz
+        else if (raw_rate_hz == 2000.0) bandwidth = 0x07;  // 1000 Hz
+        else return false;
+
+        bool ok = write8(0x3D, 0x00);   // OPR_MODE = CONFIG
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        ok = ok && write8(0x07, 0x01);  // PAGE_ID = 1
+        ok = ok && write8(0x08, static_cast<uint8_t>((bandwidth << 2) | 0x01));
+        ok = ok && write8(0x07, 0x00);
+        ok = ok && write8(0x3D, 0x07);  // OPR_MODE = AMG
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return ok;
+    }
+
+    // 원시 가속도를 raw_rate_hz 로 읽어서 decimate. running 이 false 가 되거나 shutdown 되면 반환
+    void run_oversampled(std::atomic<bool>& running, const ImuCaptureConfig& capture,
+                         MsdvAccumulator& msdv, GpsImuFusion& fusion, MotionSpectrum& spectrum) {
+        static uint64_t imu_seq = 0;
+        static SteadyStateLoop steady("imu.raw", 1000);
+
+        const int factor = static_cast<int>(std::lround(capture.raw_rate_hz / IMU_SAMPLE_RATE_HZ));
+        FirDecimator decimator(factor);
+        const double delay_sec = decimator.delay() / capture.raw_rate_hz;
+        GyroDelayLine gyro_delay(static_cast<size_t>(std::lround(decimator.delay() / factor)));   // 14 탭/출력 → 7
+        const int64_t period_ns = static_cast<int64_t>(std::llround(1e9 / capture.raw_rate_hz));
+        oversample_stats.raw_rate_hz = capture.raw_rate_hz;
+        oversample_stats.taps = decimator.taps();
+
+        timespec next;
+        clock_gettime(CLOCK_MONOTONIC, &next);
+        int64_t cpu_start = thread_cpu_ns();
+
+        while (running.load()) {
+            if (idle_monitor.idle()) {
+                imu_clear_buffer();
+                decimator.reset();
+                gyro_delay.reset();
+                if (!idle_monitor.wait_until_active()) break;
+                clock_gettime(CLOCK_MONOTONIC, &next);
+                cpu_start = thread_cpu_ns();
+            }
+
+            // 절대 시각으로 잠들어서 주기가 밀리지 않게. 이미 한 주기 이상 늦었으면 건너뛰고 지금부터
+            next.tv_nsec += period_ns;
+            while (next.tv_nsec >= 1000000000) { next.tv_nsec -= 1000000000; ++next.tv_sec; }
+            timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            int64_t late_ns = (now.tv_sec - next.tv_sec) * 1000000000LL + (now.tv_nsec - next.tv_nsec);
+            if (late_ns > period_ns) {
+                oversample_stats.overruns.fetch_add(1, std::memory_order_relaxed);
+                next = now;
+            } else if (late_ns < 0) {
+                clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+            }
+
+            SteadyStateLoop::Iteration steady_iteration(steady);
+            i2c_read_failed = false;
+            ImuRawSample raw;
+            raw.timestamp = wall_now();
+            read_accel(raw.accel);
+            if (capture.keep_raw) imu_raw_ring.push(raw);
+
+            ImuData data;
+            const int64_t filter_start = steady_ns();
+            if (!decimator.push(raw.accel, data.accel)) continue;
+            const int64_t filter_ns = steady_ns() - filter_start;
+
+            // 자이로도 같은 지연으로 (지연선이 찰 때까지 처음 몇 출력은 버림)
+            std::array<float, 3> gyro_now;
+            read_gyro(gyro_now);
+            if (!gyro_delay.push(gyro_now, data.gyro)) continue;
+
+            data.seq = ++imu_seq;
+            TraceSpan read_span("imu.read", data.seq);
+            data.source_timestamp = raw.timestamp - delay_sec;   // FIR group delay 만큼 이전 시점의 값
+            finish_sample(data, msdv, fusion, spectrum);
+
+            const int64_t cpu_end = thread_cpu_ns();
+            const uint64_t cpu_ns = static_cast<uint64_t>(cpu_end - cpu_start);
+            cpu_start = cpu_end;
+            oversample_stats.outputs.fetch_add(1, std::memory_order_relaxed);
+            oversample_stats.cpu_ns.fetch_add(cpu_ns, std::memory_order_relaxed);
+            oversample_stats.filter_ns.fetch_add(static_cast<uint64_t>(filter_ns), std::memory_order_relaxed);
+            if (cpu_ns > oversample_stats.max_cpu_ns.load(std::memory_order_relaxed)) {
+                oversample_stats.max_cpu_ns.store(cpu_ns, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+bool imu_oversample_supported(double raw_rate_hz) {
+    return raw_rate_hz == 500.0 || raw_rate_hz == 1000.0 || raw_rate_hz == 2000.0;
+}
+
+bool imu_open() {
+    i2c_fd = open(I2C_DEV_PATH, O_RDWR);
+    if (i2c_fd < 0 || ioctl(i2c_fd, I2C_SLAVE, BNO055_ADDR) < 0) {
+        std::cerr << "Failed to open BNO055 I2C device." << std::endl;
+        sensor_status.report_error("IMU", "Failed to open BNO055 I2C device");
+        return false;
+    }
+
+    // Set to NDOF mode (optional, depends on your Python config)
+    uint8_t opmode_reg[2] = {0x3D, 0x0C}; // NDOF
+    write(i2c_fd, opmode_reg, 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return true;
+}
+
+void imu_close() {
+    if (i2c_fd >= 0) close(i2c_fd);
+    i2c_fd = -1;
+}
+
+void imu_read_sample(MsdvAccumulator& msdv, GpsImuFusion& fusion, MotionSpectrum& spectrum) {
+    static uint64_t imu_seq = 0;   // 읽기는 한 스레드(IMU 스레드 또는 이벤트 루프)에서만
+    static SteadyStateLoop steady("imu.sample");
+    SteadyStateLoop::Iteration steady_iteration(steady);
+
+    ImuData data;
+    data.seq = ++imu_seq;
+    TraceSpan read_span("imu.read", data.seq);
+    i2c_read_failed = false;
+
+    // 현재 시간 기록 (초 단위)
+    data.source_timestamp = wall_now();
+
+    read_accel(data.accel);
+    read_gyro(data.gyro);
+    finish_sample(data, msdv, fusion, spectrum);
+}
+
+void imu_clear_buffer() {
+    sensors.channel<ImuSensor>().clear();
+}
+
+void imu_report_oversampling() {
+    static uint64_t last_outputs = 0, last_cpu = 0, last_filter = 0, last_overruns = 0;
+    uint64_t outputs = oversample_stats.outputs.load();
+    uint64_t cpu = oversample_stats.cpu_ns.load();
+    uint64_t filter = oversample_stats.filter_ns.load();
+    uint64_t overruns = oversample_stats.overruns.load();
+    uint64_t max_cpu = oversample_stats.max_cpu_ns.exchange(0);
+    uint64_t n = outputs - last_outputs;
+    if (n > 0) {
+        char line[200];
+        std::snprintf(line, sizeof(line),
+                      "[IMU] %.0f Hz -> %.0f Hz (%zu taps): %.1f us CPU / output sample (max %.1f), FIR %.2f us, %llu overruns",
+                      oversample_stats.raw_rate_hz, IMU_SAMPLE_RATE_HZ, oversample_stats.taps,
+                      (cpu - last_cpu) / 1e3 / n, max_cpu / 1e3, (filter - last_filter) / 1e3 / n,
+                      static_cast<unsigned long long>(overruns - last_overruns));
+        std::cout << line << std::endl;
+    }
+    last_outputs = outputs;
+    last_cpu = cpu;
+    last_filter = filter;
+    last_overruns = overruns;
+}
+
+void imu_thread(ThreadSafeQueue<ImuData>& imu_queue, std::atomic<bool>& running, ImuCaptureConfig capture) {
+    std::cout << "[IMU Thread] Started." << std::endl;
+    trace_thread_name("imu");
+
+    if (!imu_open()) return;
+
+    // ISO 2631-1 Wf 가중 + MSDV 누적 (샘플당 고정 비용)
+    MsdvAccumulator msdv(IMU_SAMPLE_RATE_HZ);
+    GpsImuFusion fusion;   // GPS 속도 / heading + IMU → 100Hz 속도
+    MotionSpectrum spectrum(IMU_SAMPLE_RATE_HZ);   // 축별 Welch PSD 밴드 파워
+
+    if (capture.raw_rate_hz > 0.0) {
+        if (configure_oversampling(capture.raw_rate_hz)) {
+            if (capture.keep_raw) {
+                imu_raw_ring.allocate(static_cast<size_t>(IMU_RAW_RING_SEC * capture.raw_rate_hz));
             }
+            std::cout << "[IMU Thread] Oversampling accel at " << capture.raw_rate_hz << " Hz (AMG mode)." << std::endl;
+            run_oversampled(running, capture, msdv, fusion, spectrum);
+            imu_close();
+            std::cout << "[IMU Thread] Stopped." << std::endl;
+            return;
+        }
+        std::cerr << "[IMU Thread] Failed to configure " << capture.raw_rate_hz << " Hz accel, using 100 Hz NDOF reads." << std::endl;
+        write8(0x07, 0x00);
+        write8(0x3D, 0x0C);   // NDOF 로 되돌림
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    while (running.load()) {
+        // 얼굴이 없는 동안은 샘플링을 멈추고 얼굴이 돌아올 때까지 잠든다
+        if (idle_monitor.idle()) {
+            imu_clear_buffer();  // 재개 직후 summary 에 멈추기 전 샘플이 섞이지 않도록
+            if (!idle_monitor.wait_until_active()) break;
         }
 
+        imu_read_sample(msdv, fusion, spectrum);
+
         // 100Hz (10ms 간격)
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 
+    imu_close();
     std::cout << "[IMU Thread] Stopped." << std::endl;
 }
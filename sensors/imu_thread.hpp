@@ -2,5 +2,34 @@
 #include <atomic>
 #include "threadsafe_queue.hpp"
 #include "../include/shared_structs.hpp"
+#include "../features/msdv.hpp"
+#include "../features/gps_imu_fusion.hpp"
+#include "../features/motion_spectrum.hpp"
 
-void imu_thread(ThreadSafeQueue<ImuData>& imu_queue, std::atomic<bool>& running);
+constexpr double IMU_SAMPLE_RATE_HZ = 100.0;
+constexpr double IMU_RAW_RING_SEC = 60.0;   // --imu-raw 로 남기는 원시 가속도 길이
+
+// --imu-oversample=HZ: BNO055 를 AMG (비융합) 모드로 두고 가속도만 HZ 로 읽어서 IMU 스레드에서
+// FirDecimator 로 IMU_SAMPLE_RATE_HZ 로 줄인다 (50Hz 위 진동이 RMS 컬럼에 aliasing 되지 않도록).
+// 자이로는 출력 주기로 읽고 (칩 내부 32Hz 저역통과) FIR 지연만큼 늦춰서 가속도와 시점을 맞춘다. 스레드 모드 전용
+struct ImuCaptureConfig {
+    double raw_rate_hz = 0.0;   // 0 = 끔 (기존 100Hz 읽기)
+    bool keep_raw = false;      // imu_raw_ring 에 IMU_RAW_RING_SEC 만큼 보관
+};
+
+// 지원하는 원시 주기 (BNO055 가속도 bandwidth 250 / 500 / 1000 Hz → 출력 데이터 2배)
+bool imu_oversample_supported(double raw_rate_hz);
+
+void imu_thread(ThreadSafeQueue<ImuData>& imu_queue, std::atomic<bool>& running, ImuCaptureConfig capture = {});
+
+// --stats: 지난 호출 이후 출력 샘플당 CPU 시간 (원시 읽기 + FIR), FIR 만의 시간, 주기 놓친 횟수 (oversampling 중일 때만)
+void imu_report_oversampling();
+
+// 이벤트 루프 모드에서도 쓰는 조각들 (imu_thread 는 10ms 마다 imu_read_sample)
+bool imu_open();
+void imu_close();
+// 샘플 하나 읽어서 MSDV / GPS 융합 / 스펙트럼 처리 후 IMU 채널에 저장 (I2C 읽기라 수백 µs 블록)
+// 새 GPS fix 는 GPS 채널의 최신 샘플로 확인한다 (스레드 모드에서는 GPS 스레드가 따로 넣음)
+void imu_read_sample(MsdvAccumulator& msdv, GpsImuFusion& fusion, MotionSpectrum& spectrum);
+// idle 진입 시 오래된 샘플 정리
+void imu_clear_buffer();
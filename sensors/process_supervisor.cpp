@@ -0,0 +1,283 @@
+#include "process_supervisor.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace {
+    constexpr int HEARTBEAT_CHILD_FD = 3;
+    constexpr double BACKOFF_MIN = 1.0;
+    constexpr double BACKOFF_MAX = 30.0;
+    constexpr double HEALTHY_RUN_SEC = 60.0;   // 이만큼 돌았으면 backoff 리셋
+    constexpr double TERM_GRACE_SEC = 3.0;
+
+    double now_sec() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void close_fd(int& fd) {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+
+    // 자식 출력 한 스트림 (줄 단위로 잘라서 출력)
+    struct OutputStream {
+        int fd = -1;
+        std::string partial;
+        bool is_stderr = false;
+    };
+
+    // 읽을 수 있는 만큼 읽는다. EOF / 오류면 false
+    bool forward_output(OutputStream& out, const std::string& name) {
+        char buf[4096];
+        ssize_t n = read(out.fd, buf, sizeof(buf));
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) return true;
+        if (n <= 0) {
+            if (!out.partial.empty()) {
+                (out.is_stderr ? std::cerr : std::cout) << "[" << name << "] " << out.partial << std::endl;
+                out.partial.clear();
+            }
+            return false;
+        }
+        out.partial.append(buf, n);
+        size_t start = 0, pos;
+        while ((pos = out.partial.find('\n', start)) != std::string::npos) {
+            (out.is_stderr ? std::cerr : std::cout) << "[" << name << "] "
+                << out.partial.substr(start, pos - start) << std::endl;
+            start = pos + 1;
+        }
+        out.partial.erase(0, start);
+        if (out.partial.size() > 64 * 1024) out.partial.clear();   // 개행 없는 출력
+        return true;
+    }
+
+    std::string describe_status(int status) {
+        if (WIFEXITED(status)) return "exited with code " + std::to_string(WEXITSTATUS(status));
+        if (WIFSIGNALED(status)) return std::string("killed by signal ") + strsignal(WTERMSIG(status));
+        return "stopped";
+    }
+}
+
+struct ProcessSupervisor::Child {
+    pid_t pid = -1;
+    OutputStream out;
+    OutputStream err;
+    int heartbeat_fd = -1;
+    double started = 0.0;
+    double last_heartbeat = -1.0;   // 아직 없음
+};
+
+ProcessSupervisor::ProcessSupervisor(Spec spec) : spec_(std::move(spec)) {
+    if (pipe2(wake_pipe_, O_CLOEXEC | O_NONBLOCK) != 0) {
+        std::cerr << "[Supervisor] pipe2 failed: " << std::strerror(errno) << std::endl;
+    }
+}
+
+ProcessSupervisor::~ProcessSupervisor() {
+    stop();
+    close_fd(wake_pipe_[0]);
+    close_fd(wake_pipe_[1]);
+}
+
+void ProcessSupervisor::start() {
+    if (thread_.joinable() || spec_.argv.empty()) return;
+    thread_ = std::thread(&ProcessSupervisor::run, this);
+}
+
+void ProcessSupervisor::stop() {
+    if (stopping_.exchange(true)) {
+        if (thread_.joinable()) thread_.join();
+        return;
+    }
+    if (wake_pipe_[1] >= 0) {
+        char c = 1;
+        (void)!write(wake_pipe_[1], &c, 1);
+    }
+    if (thread_.joinable()) thread_.join();
+}
+
+bool ProcessSupervisor::sleep_interruptible(double seconds) {
+    struct pollfd pfd{wake_pipe_[0], POLLIN, 0};
+    int timeout_ms = static_cast<int>(seconds * 1000.0);
+    while (!stopping_) {
+        double t0 = now_sec();
+        int r = poll(&pfd, 1, timeout_ms);
+        if (r != 0) return !stopping_;   // 깨움 (또는 오류)
+        timeout_ms -= static_cast<int>((now_sec() - t0) * 1000.0);
+        if (timeout_ms <= 0) return true;
+    }
+    return false;
+}
+
+bool ProcessSupervisor::spawn(Child& child) {
+    int out_pipe[2], err_pipe[2], hb_pipe[2];
+    if (pipe2(out_pipe, O_CLOEXEC) != 0) return false;
+    if (pipe2(err_pipe, O_CLOEXEC) != 0) {
+        close(out_pipe[0]); close(out_pipe[1]);
+        return false;
+    }
+    if (pipe2(hb_pipe, O_CLOEXEC) != 0) {
+        close(out_pipe[0]); close(out_pipe[1]);
+        close(err_pipe[0]); close(err_pipe[1]);
+        return false;
+    }
+    // dup2(3, 3) 은 CLOEXEC 를 안 지우므로 3번이 걸리면 옮겨둔다
+    if (hb_pipe[1] == HEARTBEAT_CHILD_FD) {
+        int moved = fcntl(hb_pipe[1], F_DUPFD_CLOEXEC, HEARTBEAT_CHILD_FD + 1);
+        close(hb_pipe[1]);
+        hb_pipe[1] = moved;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, out_pipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, err_pipe[1], STDERR_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, hb_pipe[1], HEARTBEAT_CHILD_FD);
+
+    // 자기 process group: 종료 시 자식이 띄운 것까지 같이 정리
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+
+    // 환경: 현재 환경 + spec.env (같은 키는 덮어씀)
+    std::vector<std::string> env_strings;
+    for (char** e = environ; e && *e; ++e) {
+        std::string kv = *e;
+        std::string key = kv.substr(0, kv.find('='));
+        bool overridden = std::any_of(spec_.env.begin(), spec_.env.end(),
+            [&key](const std::string& s) { return s.compare(0, key.size() + 1, key + "=") == 0; });
+        if (!overridden && key != "MOTIONSICK_HEARTBEAT_FD") env_strings.push_back(kv);
+    }
+    for (const auto& kv : spec_.env) env_strings.push_back(kv);
+    env_strings.push_back("MOTIONSICK_HEARTBEAT_FD=" + std::to_string(HEARTBEAT_CHILD_FD));
+
+    std::vector<char*> argv, envp;
+    for (auto& a : spec_.argv) argv.push_back(const_cast<char*>(a.c_str()));
+    argv.push_back(nullptr);
+    for (auto& e : env_strings) envp.push_back(const_cast<char*>(e.c_str()));
+    envp.push_back(nullptr);
+
+    pid_t pid = -1;
+    int rc = posix_spawn(&pid, argv[0], &actions, &attr, argv.data(), envp.data());
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+
+    close(out_pipe[1]);
+    close(err_pipe[1]);
+    close(hb_pipe[1]);
+
+    if (rc != 0) {
+        std::cerr << "[Supervisor] " << spec_.name << ": posix_spawn(" << spec_.argv[0] << ") failed: "
+                  << std::strerror(rc) << std::endl;
+        close(out_pipe[0]);
+        close(err_pipe[0]);
+        close(hb_pipe[0]);
+        return false;
+    }
+
+    child = Child{};
+    child.pid = pid;
+    child.out.fd = out_pipe[0];
+    child.err.fd = err_pipe[0];
+    child.err.is_stderr = true;
+    child.heartbeat_fd = hb_pipe[0];
+    child.started = now_sec();
+    std::cout << "[Supervisor] " << spec_.name << " started (pid " << pid << ")" << std::endl;
+    return true;
+}
+
+void ProcessSupervisor::terminate(Child& child) {
+    if (child.pid <= 0) return;
+
+    kill(-child.pid, SIGTERM);
+    double deadline = now_sec() + TERM_GRACE_SEC;
+    int status = 0;
+    while (waitpid(child.pid, &status, WNOHANG) == 0) {
+        if (now_sec() > deadline) {
+            std::cerr << "[Supervisor] " << spec_.name << " ignored SIGTERM, sending SIGKILL" << std::endl;
+            kill(-child.pid, SIGKILL);
+            waitpid(child.pid, &status, 0);
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    child.pid = -1;
+}
+
+void ProcessSupervisor::supervise(Child& child) {
+    while (true) {
+        struct pollfd fds[4];
+        int n = 0;
+        fds[n++] = {wake_pipe_[0], POLLIN, 0};
+        int hb_index = -1, out_index = -1, err_index = -1;
+        if (child.heartbeat_fd >= 0) { hb_index = n; fds[n++] = {child.heartbeat_fd, POLLIN, 0}; }
+        if (child.out.fd >= 0) { out_index = n; fds[n++] = {child.out.fd, POLLIN, 0}; }
+        if (child.err.fd >= 0) { err_index = n; fds[n++] = {child.err.fd, POLLIN, 0}; }
+
+        poll(fds, n, 500);
+
+        if (stopping_) {
+            terminate(child);
+            return;
+        }
+
+        if (hb_index >= 0 && fds[hb_index].revents) {
+            char buf[64];
+            ssize_t r = read(child.heartbeat_fd, buf, sizeof(buf));
+            if (r > 0) child.last_heartbeat = now_sec();
+            else if (r == 0) close_fd(child.heartbeat_fd);   // 자식이 fd 를 닫음 → 아래 timeout 으로 판단
+        }
+        if (out_index >= 0 && fds[out_index].revents && !forward_output(child.out, spec_.name)) close_fd(child.out.fd);
+        if (err_index >= 0 && fds[err_index].revents && !forward_output(child.err, spec_.name)) close_fd(child.err.fd);
+
+        int status = 0;
+        if (waitpid(child.pid, &status, WNOHANG) == child.pid) {
+            std::cerr << "[Supervisor] " << spec_.name << " " << describe_status(status) << std::endl;
+            child.pid = -1;
+            return;
+        }
+
+        double now = now_sec();
+        bool timed_out = child.last_heartbeat < 0.0
+            ? now - child.started > spec_.startup_timeout
+            : now - child.last_heartbeat > spec_.heartbeat_timeout;
+        if (timed_out) {
+            std::cerr << "[Supervisor] " << spec_.name << " heartbeat lost ("
+                      << (child.last_heartbeat < 0.0 ? "none since start" : "hung") << "), restarting" << std::endl;
+            terminate(child);
+            return;
+        }
+    }
+}
+
+void ProcessSupervisor::run() {
+    double backoff = BACKOFF_MIN;
+    while (!stopping_) {
+        Child child;
+        if (spawn(child)) {
+            supervise(child);
+            close_fd(child.out.fd);
+            close_fd(child.err.fd);
+            close_fd(child.heartbeat_fd);
+            if (stopping_) break;
+            if (now_sec() - child.started > HEALTHY_RUN_SEC) backoff = BACKOFF_MIN;
+        }
+
+        std::cerr << "[Supervisor] " << spec_.name << " restarting in " << backoff << " s" << std::endl;
+        if (!sleep_interruptible(backoff)) break;
+        backoff = std::min(backoff * 2.0, BACKOFF_MAX);
+        restarts_++;
+    }
+    std::cout << "[Supervisor] " << spec_.name << " stopped." << std::endl;
+}
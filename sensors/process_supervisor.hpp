@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+#include <vector>
+
+// 자식 프로세스(얼굴 producer) 하나를 posix_spawn 으로 띄우고 지켜보는 감독 스레드.
+// - stdout / stderr 는 pipe 로 받아 "[name] ..." 로 그대로 출력
+// - 자식은 heartbeat fd(환경변수 MOTIONSICK_HEARTBEAT_FD) 에 주기적으로 1바이트를 쓴다.
+//   제한 시간 동안 안 오면 멈춘 것으로 보고 죽인 뒤 다시 띄운다
+// - 죽거나 멈추면 1초부터 두 배씩(최대 30초) 기다렸다가 재시작. 60초 이상 잘 돌았으면 1초로 리셋
+// - stop(): SIGTERM → 3초 안에 안 끝나면 SIGKILL, 스레드 join
+class ProcessSupervisor {
+public:
+    struct Spec {
+        std::string name;                  // 로그 prefix, 예: "face:driver"
+        std::vector<std::string> argv;     // argv[0] = 실행 파일 경로
+        std::vector<std::string> env;      // 추가 / 덮어쓸 환경 변수 "KEY=VALUE"
+        double startup_timeout = 30.0;     // 첫 heartbeat 까지 (모델 로딩 포함)
+        double heartbeat_timeout = 10.0;   // 그 뒤 heartbeat 간격 상한
+    };
+
+    explicit ProcessSupervisor(Spec spec);
+    ~ProcessSupervisor();
+
+    ProcessSupervisor(const ProcessSupervisor&) = delete;
+    ProcessSupervisor& operator=(const ProcessSupervisor&) = delete;
+
+    void start();
+    void stop();
+
+    int restarts() const { return restarts_.load(); }
+
+private:
+    struct Child;
+
+    void run();
+    bool spawn(Child& child);
+    // 자식이 끝날 때까지 출력 / heartbeat 를 처리. stop() 이면 자식을 정리하고 반환
+    void supervise(Child& child);
+    void terminate(Child& child);
+    // stop() 이 오면 바로 깨는 sleep. stop 이면 false
+    bool sleep_interruptible(double seconds);
+
+    Spec spec_;
+    std::thread thread_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<int> restarts_{0};
+    int wake_pipe_[2] = {-1, -1};   // stop() → 감독 스레드 깨우기
+};
@@ -0,0 +1,111 @@
+#include "sensor_registry.hpp"
+
+#include <sqlite3.h>
+#include <cmath>
+#include <cstdio>
+
+#include "../features/msdv.hpp"
+#include "../features/motion_spectrum.hpp"
+#include "../features/gps_imu_fusion.hpp"
+#include "../features/summary_pyramid.hpp"
+#include "../logger/database_logger.hpp"
+
+// ✅ 전역 센서 버퍼 (채널마다 source 별 버퍼 + 뮤텍스)
+Sensors sensors;
+
+void FaceSensor::bind(sqlite3_stmt* stmt, const FaceData& face, std::string& text) {
+    // {"name":value,...} — 프레임에 있던 blendshape 만, BLENDSHAPE_NAMES 순서
+    char number[32];
+    text.clear();
+    text += '{';
+    for (int i = 0; i < BLENDSHAPE_COUNT; ++i) {
+        if (std::isnan(face.blendshapes[i])) continue;
+        if (text.size() > 1) text += ',';
+        text += '"';
+        text += BLENDSHAPE_NAMES[i];
+        text += "\":";
+        std::snprintf(number, sizeof(number), "%g", face.blendshapes[i]);
+        text += number;
+    }
+    text += '}';
+
+    sqlite3_bind_double(stmt, 1, face.source_timestamp);
+    for (int i = 0; i < 3; ++i) {
+        if (face.has_rgb) {
+            sqlite3_bind_double(stmt, 2 + i, face.avg_rgb[i]);
+        } else {
+            sqlite3_bind_null(stmt, 2 + i);   // RGB 없는 프레임
+        }
+    }
+    sqlite3_bind_text(stmt, 5, text.data(), static_cast<int>(text.size()), SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 6, face.source_id);
+}
+
+void FaceSensor::compute_features(SampleSpan<FaceData> faces, SummaryRow& row, int source) {
+    // 전제: 얼굴 특징은 100개 이상일 때만 (카메라마다 따로)
+    if (faces.size() >= FACE_MIN_SAMPLES_FOR_FEATURES) {
+        compute_face_features(faces, row, source);
+    }
+}
+
+void FaceSensor::add_to_pyramid(SummaryPyramid& pyramid, const FaceData& face) {
+    pyramid_add(pyramid, face);
+}
+
+void ImuSensor::bind(sqlite3_stmt* stmt, const ImuData& imu, std::string&) {
+    sqlite3_bind_double(stmt, 1, imu.source_timestamp);
+    for (int i = 0; i < 3; ++i) {
+        sqlite3_bind_double(stmt, 2 + i, imu.accel[i]);
+        sqlite3_bind_double(stmt, 5 + i, imu.gyro[i]);
+    }
+}
+
+void ImuSensor::after_insert(DatabaseLogger& db, SampleSpan<ImuData> inserted) {
+    db.insertMsdvData(compute_msdv_summary(inserted), inserted.back().source_timestamp);
+}
+
+void ImuSensor::compute_features(SampleSpan<ImuData> imu, SummaryRow& row, int) {
+    compute_imu_features(imu, row);
+    compute_msdv_features(imu, row);
+    compute_fusion_features(imu, row);
+    compute_spectrum_features(imu, row);
+}
+
+void ImuSensor::add_to_pyramid(SummaryPyramid& pyramid, const ImuData& imu) {
+    pyramid_add(pyramid, imu);
+}
+
+void GpsSensor::bind(sqlite3_stmt* stmt, const GpsData& gps, std::string&) {
+    sqlite3_bind_double(stmt, 1, gps.source_timestamp);
+    sqlite3_bind_double(stmt, 2, gps.lat);
+    sqlite3_bind_double(stmt, 3, gps.lon);
+    sqlite3_bind_double(stmt, 4, gps.speed);
+}
+
+void GpsSensor::compute_features(SampleSpan<GpsData> gps, SummaryRow& row, int) {
+    compute_gps_features(gps, row);
+}
+
+void GpsSensor::add_to_pyramid(SummaryPyramid& pyramid, const GpsData& gps) {
+    pyramid_add(pyramid, gps);
+}
+
+void CanSensor::bind(sqlite3_stmt* stmt, const CanData& can, std::string&) {
+    sqlite3_bind_double(stmt, 1, can.source_timestamp);
+    const float values[] = {can.speed, can.steer_angle, can.steer_rate, can.accel_pedal, can.brake_pressure};
+    for (int i = 0; i < 5; ++i) {
+        if (std::isnan(values[i])) {
+            sqlite3_bind_null(stmt, 2 + i);
+        } else {
+            sqlite3_bind_double(stmt, 2 + i, values[i]);
+        }
+    }
+}
+
+void CanSensor::compute_features(SampleSpan<CanData> can, SummaryRow& row, int) {
+    compute_can_features(can, row);
+}
+
+void CanSensor::add_to_pyramid(SummaryPyramid& pyramid, const CanData& can) {
+    pyramid_add(pyramid, can);
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <string>
+
+#include "../include/shared_structs.hpp"
+#include "../include/sensor_channel.hpp"
+#include "../features/summary_features.hpp"
+
+// 라이브 로거의 센서들. 새 센서는 traits 하나 + Sensors 목록에 추가 (각 항목은 include/sensor_channel.hpp 참고)
+// summary CSV / 피라미드 컬럼 목록은 재처리 툴과 같이 쓰므로 features/ 에 그대로 있다
+
+typedef struct sqlite3_stmt sqlite3_stmt;
+
+// 얼굴 (카메라별 source, FACE_SOURCE_NAMES)
+struct FaceSensor : SensorTraitsBase {
+    using Sample = FaceData;
+    static constexpr const char* name = "face";
+    static constexpr int sources = MAX_FACE_SOURCES;
+    static constexpr size_t capacity = 10 * 10;
+    static const char* source_name(int source) { return FACE_SOURCE_NAMES[source]; }
+
+    static constexpr const char* insert_span = "face.buffer_insert";
+    static constexpr const char* db_span = "db.commit_face";
+    static constexpr const char* summary_span = "summary.face";
+
+    static constexpr const char* table = "face_data";
+    static constexpr const char* create_sql = R"(
+        CREATE TABLE IF NOT EXISTS face_data (
+            timestamp REAL,
+            r REAL, g REAL, b REAL,
+            blendshapes TEXT,
+            source_id INTEGER DEFAULT 0
+        );
+    )";
+    // 예전 DB (source_id 이전) 는 컬럼만 추가. 이미 있으면 실패하고 무시됨
+    static constexpr const char* migrate_sql = "ALTER TABLE face_data ADD COLUMN source_id INTEGER DEFAULT 0;";
+    static constexpr const char* insert_sql = "INSERT INTO face_data VALUES (?1, ?2, ?3, ?4, ?5, ?6);";
+    static void bind(sqlite3_stmt* stmt, const Sample& face, std::string& text);
+
+    // 버퍼에 FACE_MIN_SAMPLES_FOR_FEATURES 개 이상일 때만, 컬럼은 face_column(source, ...)
+    static void compute_features(SampleSpan<Sample> faces, SummaryRow& row, int source);
+    static void add_to_pyramid(SummaryPyramid& pyramid, const Sample& face);
+};
+
+// BNO055 (100Hz)
+struct ImuSensor : SensorTraitsBase {
+    using Sample = ImuData;
+    static constexpr const char* name = "imu";
+    static constexpr size_t capacity = 50 * 10;
+    static const char* source_name(int) { return name; }
+
+    static constexpr const char* insert_span = "imu.buffer_insert";
+    static constexpr const char* db_span = "db.commit_imu";
+    static constexpr const char* summary_span = "summary.imu";
+
+    static constexpr const char* table = "imu_data";
+    static constexpr const char* create_sql = R"(
+        CREATE TABLE IF NOT EXISTS imu_data (
+            timestamp REAL,
+            ax REAL, ay REAL, az REAL,
+            gx REAL, gy REAL, gz REAL
+        );
+    )";
+    static constexpr const char* insert_sql = "INSERT INTO imu_data VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7);";
+    static void bind(sqlite3_stmt* stmt, const Sample& imu, std::string& text);
+    // ✅ 세션별 MSDV 기록 (새 구간의 가중 RMS + 누적 MSDV)
+    static void after_insert(DatabaseLogger& db, SampleSpan<Sample> inserted);
+
+    // IMU + MSDV 컬럼, 융합 speed, 밴드 파워
+    static void compute_features(SampleSpan<Sample> imu, SummaryRow& row, int source);
+    static void add_to_pyramid(SummaryPyramid& pyramid, const Sample& imu);
+};
+
+// NMEA GPRMC fix (~1Hz)
+struct GpsSensor : SensorTraitsBase {
+    using Sample = GpsData;
+    static constexpr const char* name = "gps";
+    static constexpr size_t capacity = 10 * 10;
+    static const char* source_name(int) { return name; }
+
+    static constexpr const char* insert_span = "gps.buffer_insert";
+    static constexpr const char* db_span = "db.commit_gps";
+    static constexpr const char* summary_span = "summary.gps";
+
+    static constexpr const char* table = "gps_data";
+    static constexpr const char* create_sql = R"(
+        CREATE TABLE IF NOT EXISTS gps_data (
+            timestamp REAL,
+            lat REAL,
+            lon REAL,
+            speed REAL
+        );
+    )";
+    static constexpr const char* insert_sql = "INSERT INTO gps_data VALUES (?1, ?2, ?3, ?4);";
+    static void bind(sqlite3_stmt* stmt, const Sample& gps, std::string& text);
+
+    static void compute_features(SampleSpan<Sample> gps, SummaryRow& row, int source);
+    static void add_to_pyramid(SummaryPyramid& pyramid, const Sample& gps);
+};
+
+// 차량 CAN (CanReceiver, CAN_SAMPLE_RATE_HZ). 못 받은 신호는 NaN → DB 에는 NULL
+struct CanSensor : SensorTraitsBase {
+    using Sample = CanData;
+    static constexpr const char* name = "can";
+    static constexpr size_t capacity = 50 * 10;
+    static const char* source_name(int) { return name; }
+
+    static constexpr const char* insert_span = "can.buffer_insert";
+    static constexpr const char* db_span = "db.commit_can";
+    static constexpr const char* summary_span = "summary.can";
+
+    static constexpr const char* table = "can_data";
+    static constexpr const char* create_sql = R"(
+        CREATE TABLE IF NOT EXISTS can_data (
+            timestamp REAL,
+            speed REAL,
+            steer_angle REAL,
+            steer_rate REAL,
+            accel_pedal REAL,
+            brake_pressure REAL
+        );
+    )";
+    static constexpr const char* insert_sql = "INSERT INTO can_data VALUES (?1, ?2, ?3, ?4, ?5, ?6);";
+    static void bind(sqlite3_stmt* stmt, const Sample& can, std::string& text);
+
+    static void compute_features(SampleSpan<Sample> can, SummaryRow& row, int source);
+    static void add_to_pyramid(SummaryPyramid& pyramid, const Sample& can);
+};
+
+// 채널 순서 = summary 작업 순서 (카메라별 얼굴, IMU, GPS, CAN)
+using Sensors = SensorRegistry<FaceSensor, ImuSensor, GpsSensor, CanSensor>;
+
+extern Sensors sensors;
@@ -0,0 +1,53 @@
+#include "sensor_status.hpp"
+
+#include <cstdio>
+#include <thread>
+
+SensorStatus sensor_status;
+
+void SensorStatus::report_error(const char* source, const char* message) {
+    char text[MAX_ERROR_LEN] = {};
+    std::snprintf(text, sizeof(text), "[%s] %s", source, message);
+
+    while (error_writer_.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+
+    uint64_t seq = error_seq_.load(std::memory_order_relaxed);
+    error_seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < MAX_ERROR_LEN; ++i) {
+        error_text_[i].store(text[i], std::memory_order_relaxed);
+    }
+    error_seq_.store(seq + 2, std::memory_order_release);
+
+    error_writer_.clear(std::memory_order_release);
+}
+
+SensorStatus::Snapshot SensorStatus::snapshot() const {
+    Snapshot s;
+    s.face_detected = face_detected_.load(std::memory_order_relaxed);
+    s.face_frames = face_frames_.load(std::memory_order_relaxed);
+    s.imu_samples = imu_samples_.load(std::memory_order_relaxed);
+    s.gps_fixes = gps_fixes_.load(std::memory_order_relaxed);
+
+    // 쓰는 도중이면 다시 읽는다 (에러는 드물어서 거의 한 번에 끝남)
+    char text[MAX_ERROR_LEN] = {};
+    uint64_t before, after;
+    do {
+        before = error_seq_.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < MAX_ERROR_LEN; ++i) {
+            text[i] = error_text_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = error_seq_.load(std::memory_order_relaxed);
+        if (before == after) break;
+    } while (true);
+
+    text[MAX_ERROR_LEN - 1] = '\0';
+    s.last_error = text;
+    s.error_count = before / 2;
+    return s;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// 센서 스레드 → UI 상태판 (lock-free).
+// - 센서 쪽은 atomic store / fetch_add 만 한다. Qt 이벤트를 만들지 않음
+// - UI 는 QTimer 로 snapshot() 을 떠서 이전 값과 다를 때만 다시 그린다
+// - 카운터는 누적값이라 rate(fps, IMU Hz) 와 "최근에 들어왔는지" 는 읽는 쪽이 차이로 계산
+class SensorStatus {
+public:
+    static constexpr size_t MAX_ERROR_LEN = 96;
+
+    struct Snapshot {
+        bool face_detected = false;   // 운전자 카메라 기준
+        uint64_t face_frames = 0;     // 받은 얼굴 프레임 수 (감지 여부 무관)
+        uint64_t imu_samples = 0;     // 정상적으로 읽은 IMU 샘플 수
+        uint64_t gps_fixes = 0;       // status = A 인 $GPRMC 수
+        uint64_t error_count = 0;     // report_error 호출 수 (바뀌었으면 last_error 갱신)
+        std::string last_error;       // "[IMU] I2C read failed" 형태
+    };
+
+    // socket receiver: 프레임마다
+    void face_frame(bool detected) {
+        face_detected_.store(detected, std::memory_order_relaxed);
+        face_frames_.fetch_add(1, std::memory_order_relaxed);
+    }
+    void imu_sample() { imu_samples_.fetch_add(1, std::memory_order_relaxed); }
+    void gps_fix() { gps_fixes_.fetch_add(1, std::memory_order_relaxed); }
+
+    // 어느 스레드에서나 호출 가능. 마지막 메시지 하나만 보관 (힙 할당 없음, MAX_ERROR_LEN 에서 자름)
+    void report_error(const char* source, const char* message);
+
+    Snapshot snapshot() const;
+
+private:
+    std::atomic<bool> face_detected_{false};
+    std::atomic<uint64_t> face_frames_{0};
+    std::atomic<uint64_t> imu_samples_{0};
+    std::atomic<uint64_t> gps_fixes_{0};
+
+    // last_error: seqlock (쓰는 쪽끼리는 error_writer_ 로 직렬화, 읽는 쪽은 재시도)
+    std::atomic_flag error_writer_ = ATOMIC_FLAG_INIT;
+    std::atomic<uint64_t> error_seq_{0};   // 홀수 = 쓰는 중, 완료된 쓰기마다 +2
+    std::array<std::atomic<char>, MAX_ERROR_LEN> error_text_{};
+};
+
+extern SensorStatus sensor_status;
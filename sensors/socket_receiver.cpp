@@ -4,126 +4,307 @@
 #include <sstream>
 #include <vector>
 #include <netinet/in.h>
+#include <sys/socket.h>
 #include <unistd.h>
-#include <nlohmann/json.hpp>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
 #include <unordered_map>
+#include <memory>
 #include <mutex>
 
 #include "../include/shared_structs.hpp"
 #include "threadsafe_queue.hpp"
-#include "toggle_window.hpp"
+#include "../features/head_pose.hpp"
+#include "frame_shm.hpp"
+#include "socket_receiver.hpp"
+#include "idle_monitor.hpp"
+#include "sensor_status.hpp"
+#include "../logger/feature_publisher.hpp"
+#include "../include/trace.hpp"
+#include "../include/alloc_check.hpp"
+#include "face_line_parser.hpp"
+#include "sensor_registry.hpp"
 
-using json = nlohmann::json;
+namespace {
+    constexpr int FACE_PORT = 50007;
+    constexpr int MAX_EVENTS = 16;
+    constexpr size_t MAX_LINE_BUFFER = 1 << 20;   // 개행 없이 1MB 넘게 오면 끊는다
+    constexpr size_t CONNECTION_BUFFER_RESERVE = 64 * 1024;
 
-// ✅ 전역 버퍼 및 뮤텍스 선언 (정의는 socket_receiver.hpp 혹은 cpp 상단에서)
-std::vector<FaceData> face_buffer;
-std::mutex face_buffer_mutex;
-const int FACE_BUFFER_MAX_SIZE = 10 * 10;
+    using FaceConnection = FaceServer::Connection;
 
-void socket_receiver(ThreadSafeQueue<FaceData>& face_queue, std::atomic<bool>& running, ToggleWindow* ui_window) {
-    int server_fd, new_socket;
-    struct sockaddr_in address;
+    // producer 에게 보내는 frame rate 명령 (face_processor.py 가 읽음)
+    const char* rate_command(bool idle) {
+        return idle ? "{\"cmd\":\"rate\",\"mode\":\"idle\"}\n"
+                    : "{\"cmd\":\"rate\",\"mode\":\"active\"}\n";
+    }
+
+    void send_line(int fd, const char* line) {
+        // 몇십 바이트라 보통 한 번에 들어간다. 버퍼가 꽉 찬 producer 는 다음 전환 때 다시 받음
+        send(fd, line, std::strlen(line), MSG_NOSIGNAL | MSG_DONTWAIT);
+    }
+
+    bool set_nonblocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    // JSON 한 줄 [begin, end) 처리 → 해당 source 버퍼에 저장. 샘플 순번(frame_id, 없으면 0) 반환
+    uint64_t handle_face_line(const char* begin, const char* end, FaceConnection& conn,
+                              std::vector<std::unique_ptr<FrameShmReader>>& frame_shm) {
+        static SteadyStateLoop steady("face.line");
+        SteadyStateLoop::Iteration steady_iteration(steady);
+        TraceSpan parse_span("face.parse");
+
+        FaceLine line;
+        const char* error = nullptr;
+        if (!parse_face_line(begin, end, line, &error)) {
+            std::cerr << "[SocketReceiver] JSON parse error: " << error << std::endl;
+            sensor_status.report_error("Face", "JSON parse error");
+            return 0;
+        }
+
+        FaceData& data = line.face;
+        const int source_id = data.source_id;
+        if (conn.source_id != source_id) {
+            std::cout << "[SocketReceiver] fd " << conn.fd << " → source '"
+                      << FACE_SOURCE_NAMES[source_id] << "'" << std::endl;
+            conn.source_id = source_id;
+        }
+        parse_span.set_seq(data.seq);
+
+        // producer 쪽 구간 (카메라 캡처 → 얼굴 검출 끝). 시각은 producer 벽시계
+        if (trace_enabled() && line.has_capture_time) {
+            trace_record("face.producer", trace_from_wall(line.capture_time),
+                         trace_from_wall(data.source_timestamp), data.seq);
+        }
+
+        // 얼굴 감지 실패: avg_rgb, blendshapes, rotation_matrix 모두 비어 있으면 clear
+        bool is_empty_face = line.rgb_count == 0 &&
+                            line.blendshape_count == 0 &&
+                            line.rotation_rows == 0;
+
+        if (!is_empty_face) {
+            double now = std::chrono::duration<double>(
+                std::chrono::system_clock::now().time_since_epoch()
+            ).count();
+            idle_monitor.face_detected(now);  // ✅ 60초 idle 타이머 갱신, idle 이었으면 즉시 복귀 (어느 카메라든)
+        }
+
+        // ✅ UI 표시등은 운전자 카메라 기준. Qt 신호 대신 상태판에 쓰고 UI 가 타이머로 읽는다
+        if (source_id == 0) {
+            sensor_status.face_frame(!is_empty_face);
+        }
+
+        if (is_empty_face) {
+            sensors.channel<FaceSensor>().clear(source_id);
+            return data.seq;  // skip further processing
+        }
+
+        // avg_rgb: Python 이 직접 계산해서 보냈으면 그대로, frame_id 만 왔으면 공유메모리 프레임에서 계산
+        // 슬롯을 놓치면 (덮어써짐, 아직 안 붙음, producer 재시작) has_rgb = false 로 두고 RGB 없이 저장
+        // (0 을 넣으면 rPPG 창에 계단이 생기고 r/g/b 평균, 피라미드, DB 가 틀어진다)
+        if (line.rgb_count == 0 && line.has_frame_id) {
+            data.has_rgb = frame_shm[source_id]->mean_skin_rgb(data.seq, data.avg_rgb);
+        }
+
+        // ✅ 쿼터니언은 여기서 한 번만 계산 (summary 에서는 재사용)
+        if (data.has_head_pose) {
+            double m[3][3];
+            for (int i = 0; i < 3; ++i) {
+                for (int jx = 0; jx < 3; ++jx) m[i][jx] = data.rotation_matrix[i][jx];
+            }
+            data.head_quat = quat_from_rotation_matrix(m);
+        }
+
+        feature_publisher.publish(data);
+
+        // ✅ Save to buffer
+        sensors.channel<FaceSensor>().push(data, source_id);
+        return data.seq;
+    }
+
+    // 읽을 수 있는 만큼 읽고 완성된 줄을 처리. 연결이 끝났으면 false
+    bool drain_connection(FaceConnection& conn, std::vector<std::unique_ptr<FrameShmReader>>& frame_shm) {
+        char temp[4096];
+        bool alive = true;
+        const int64_t receive_start = trace_enabled() ? trace_now_ns() : 0;
+        while (true) {
+            ssize_t bytes_read = read(conn.fd, temp, sizeof(temp));
+            if (bytes_read == 0) {
+                alive = false;   // EOF: 이미 받은 줄은 아래에서 처리
+                break;
+            }
+            if (bytes_read < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    std::cerr << "[SocketReceiver] read error on fd " << conn.fd << ": " << std::strerror(errno) << std::endl;
+                    sensor_status.report_error("Face", std::strerror(errno));
+                    alive = false;
+                }
+                break;
+            }
+            conn.buffer.append(temp, bytes_read);
+        }
+        const int64_t receive_end = trace_enabled() ? trace_now_ns() : 0;
+
+        // face.receive 는 이번에 읽은 바이트로 완성된 프레임들의 순번 구간으로 태그
+        uint64_t first_seq = 0, last_seq = 0;
+        size_t start = 0, pos;
+        while ((pos = conn.buffer.find('\n', start)) != std::string::npos) {
+            uint64_t seq = handle_face_line(conn.buffer.data() + start, conn.buffer.data() + pos, conn, frame_shm);
+            if (seq != 0) {
+                if (first_seq == 0) first_seq = seq;
+                last_seq = seq;
+            }
+            start = pos + 1;
+        }
+        conn.buffer.erase(0, start);
+        if (trace_enabled()) trace_record("face.receive", receive_start, receive_end, first_seq, last_seq);
+
+        if (conn.buffer.size() > MAX_LINE_BUFFER) {
+            std::cerr << "[SocketReceiver] Line too long on fd " << conn.fd << ", dropping connection." << std::endl;
+            return false;
+        }
+        return alive;
+    }
+}
+
+FaceServer::FaceServer() {
+    // 얼굴 ROI 평균 RGB 는 source 별 공유메모리 프레임에서 여기서 직접 계산
+    for (int i = 0; i < MAX_FACE_SOURCES; ++i) {
+        frame_shm_.push_back(std::make_unique<FrameShmReader>(frame_shm_name(i)));
+    }
+}
+
+FaceServer::~FaceServer() {
+    for (const auto& [fd, conn] : connections_) close(fd);
+    if (epoll_fd_ >= 0) close(epoll_fd_);
+    if (server_fd_ >= 0) close(server_fd_);
+}
+
+bool FaceServer::open() {
     int opt = 1;
-    int addrlen = sizeof(address);
+    struct sockaddr_in address{};
 
-    server_fd = socket(AF_INET, SOCK_STREAM, 0);
-    setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt, sizeof(opt));
+    server_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);   // 자식(producer)에게 넘어가지 않게
+    if (server_fd_ < 0) {
+        std::cerr << "[SocketReceiver] socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    setsockopt(server_fd_, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt, sizeof(opt));
 
     address.sin_family = AF_INET;
     address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(50007);
+    address.sin_port = htons(FACE_PORT);
 
-    bind(server_fd, (struct sockaddr *)&address, sizeof(address));
-    listen(server_fd, 1);
-    std::cout << "[SocketReceiver] Waiting for Python connection..." << std::endl;
-    new_socket = accept(server_fd, (struct sockaddr *)&address, (socklen_t*)&addrlen);
-    std::cout << "[SocketReceiver] Connected." << std::endl;
+    if (bind(server_fd_, (struct sockaddr *)&address, sizeof(address)) < 0 ||
+        listen(server_fd_, SOMAXCONN) < 0 || !set_nonblocking(server_fd_)) {
+        std::cerr << "[SocketReceiver] Failed to listen on port " << FACE_PORT << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
 
-    std::string buffer, line;
-    char temp[2048];
-    while (running) {
-        int bytes_read = read(new_socket, temp, sizeof(temp));
-        if (bytes_read <= 0) break;
-
-        buffer.append(temp, bytes_read);
-
-        size_t pos;
-        while ((pos = buffer.find('\n')) != std::string::npos) {
-            line = buffer.substr(0, pos);
-            buffer.erase(0, pos + 1);
-
-            try {
-                json j = json::parse(line);
-
-                FaceData data;
-                data.source_timestamp = j["timestamp"].get<double>();
-
-                // 얼굴 감지 실패: avg_rgb, blendshapes, rotation_matrix 모두 비어 있으면 clear
-                bool is_empty_face = j["avg_rgb"].empty() &&
-                                    j["blendshapes"].empty() &&
-                                    j["rotation_matrix"].empty();
-
-                // ✅ emit face detection signal to UI
-                if (ui_window) {
-                    // emit ui_window->faceDetectionChanged(!is_empty_face);
-                    bool detected = !is_empty_face;
-                    emit ui_window->faceDetectionChanged(detected);  // ✅ 그대로 유지 (UI는 즉시 반응)
-
-                    if (detected) {
-                        double now = std::chrono::duration<double>(
-                            std::chrono::system_clock::now().time_since_epoch()
-                        ).count();
-                        last_face_detected_time.store(now);  // ✅ 60초 타이머용 상태값 업데이트
-                    }
-                }
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        std::cerr << "[SocketReceiver] epoll_create1 failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
 
-                if (is_empty_face) {
-                    std::lock_guard<std::mutex> lock(face_buffer_mutex);
-                    face_buffer.clear();
-                    continue;  // skip further processing
-                }
+    struct epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = server_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, server_fd_, &ev);
 
-                // Blendshapes
-                for (auto& [key, val] : j["blendshapes"].items()) {
-                    data.blendshapes[key] = val.get<float>();
-                }
+    std::cout << "[SocketReceiver] Waiting for Python connections on port " << FACE_PORT << "..." << std::endl;
+    return true;
+}
 
-                // avg_rgb
-                for (const auto& val : j["avg_rgb"]) {
-                    data.avg_rgb.push_back(val);
-                }
+void FaceServer::accept_all() {
+    while (true) {
+        int client_fd = accept4(server_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_fd < 0) break;   // EAGAIN: 더 없음
 
-                // rotation_matrix (3x3 from 4x4 input)
-                const auto& rot_mat_raw = j["rotation_matrix"];
-                if (rot_mat_raw.size() >= 3) {
-                    for (int i = 0; i < 3; ++i) {
-                        std::vector<float> row;
-                        for (int jx = 0; jx < 3; ++jx) {
-                            row.push_back(rot_mat_raw[i][jx].get<float>());
-                        }
-                        data.rotation_matrix.push_back(row);
-                    }
-                }
+        struct epoll_event cev{};
+        cev.events = EPOLLIN | EPOLLRDHUP;
+        cev.data.fd = client_fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, client_fd, &cev) < 0) {
+            close(client_fd);
+            continue;
+        }
+        FaceConnection& conn = connections_[client_fd];
+        conn.fd = client_fd;
+        conn.buffer.reserve(CONNECTION_BUFFER_RESERVE);   // 한 줄 ~3KB, read 는 4KB 씩
+        std::cout << "[SocketReceiver] Connected (fd " << client_fd << ", "
+                  << connections_.size() << " producers)." << std::endl;
 
-                // translation_vector (3 elements from 4x4 matrix’s last column)
-                const auto& tvec_raw = j["translation_vector"];
-                for (int i = 0; i < 3 && i < tvec_raw.size(); ++i) {
-                    data.translation_vector.push_back(tvec_raw[i].get<float>());
-                }
+        // 새 producer 는 현재 모드로 시작
+        send_line(client_fd, rate_command(idle_monitor.idle()));
+    }
+}
 
-                // ✅ Save to buffer
-                std::lock_guard<std::mutex> lock(face_buffer_mutex);
-                face_buffer.push_back(data);
-                if (face_buffer.size() > FACE_BUFFER_MAX_SIZE) {
-                    face_buffer.erase(face_buffer.begin());
-                }
+void FaceServer::close_connection(int fd) {
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) return;
+    int source_id = it->second.source_id;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections_.erase(it);
 
-            } catch (const std::exception& e) {
-                std::cerr << "[SocketReceiver] JSON parse error: " << e.what() << std::endl;
-            }
+    // 끊긴 카메라의 오래된 샘플로 summary 를 계속 만들지 않도록 비운다
+    if (source_id >= 0) sensors.channel<FaceSensor>().clear(source_id);
+    std::cout << "[SocketReceiver] Producer disconnected (fd " << fd << "), waiting for reconnect..." << std::endl;
+}
+
+bool FaceServer::poll(int timeout_ms) {
+    struct epoll_event events[MAX_EVENTS];
+    int n = epoll_wait(epoll_fd_, events, MAX_EVENTS, timeout_ms);
+    if (n < 0) {
+        if (errno == EINTR) return true;
+        std::cerr << "[SocketReceiver] epoll_wait failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        int fd = events[i].data.fd;
+
+        if (fd == server_fd_) {
+            accept_all();
+            continue;
+        }
+
+        auto it = connections_.find(fd);
+        if (it == connections_.end()) continue;
+
+        // EPOLLRDHUP 이어도 남은 데이터는 먼저 처리
+        bool alive = drain_connection(it->second, frame_shm_);
+        if (!alive || (events[i].events & (EPOLLERR | EPOLLHUP))) {
+            close_connection(fd);
         }
     }
 
-    close(new_socket);
-    close(server_fd);
+    announce_rate_mode();
+    return true;
+}
+
+void FaceServer::announce_rate_mode() {
+    uint64_t transitions = idle_monitor.transitions();
+    if (transitions == announced_transitions_) return;
+    announced_transitions_ = transitions;
+
+    const char* line = rate_command(idle_monitor.idle());
+    for (const auto& [fd, conn] : connections_) send_line(fd, line);
+}
+
+// 스레드 모드: producer(카메라별 Python 프로세스)가 여러 개 붙거나
+// 재시작해서 다시 붙어도 계속 받는다.
+void socket_receiver(ThreadSafeQueue<FaceData>& face_queue, std::atomic<bool>& running) {
+    trace_thread_name("face-rx");
+    FaceServer server;
+    if (!server.open()) return;
+
+    while (running) {
+        if (!server.poll(500)) break;  // 500ms: running 확인 주기
+    }
 }
@@ -1,11 +1,49 @@
 #pragma once
 #include "../include/shared_structs.hpp"
 #include "threadsafe_queue.hpp"
+#include "frame_shm.hpp"
 #include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 
-extern std::vector<FaceData> face_buffer;
-extern std::mutex face_buffer_mutex;
+// 얼굴 producer 들을 받는 non-blocking 서버 (연결 수와 무관하게 스레드 하나).
+// fd() 는 내부 epoll fd 라서 바깥 이벤트 루프에 EPOLLIN 으로 그대로 등록할 수 있다.
+class FaceServer {
+public:
+    // producer 연결 하나 (카메라 하나)
+    struct Connection {
+        int fd = -1;
+        std::string buffer;
+        int source_id = -1;   // 첫 메시지에서 결정
+    };
 
-void socket_receiver(ThreadSafeQueue<FaceData>& queue, std::atomic<bool>& running, ToggleWindow* ui_window);
+    FaceServer();
+    ~FaceServer();
+
+    FaceServer(const FaceServer&) = delete;
+    FaceServer& operator=(const FaceServer&) = delete;
+
+    bool open();
+    int fd() const { return epoll_fd_; }
+
+    // 준비된 연결/데이터를 처리 (최대 timeout_ms 대기, 0 이면 바로 반환). epoll 오류면 false.
+    // idle 전환이 있었으면 producer 들에게 frame rate 명령도 여기서 보낸다
+    bool poll(int timeout_ms);
+
+private:
+    void accept_all();
+    void close_connection(int fd);
+    // idle 상태가 바뀌었으면 모든 producer 에 frame rate 명령 전송
+    void announce_rate_mode();
+
+    int server_fd_ = -1;
+    int epoll_fd_ = -1;
+    std::vector<std::unique_ptr<FrameShmReader>> frame_shm_;
+    std::unordered_map<int, Connection> connections_;
+    uint64_t announced_transitions_ = 0;
+};
+
+void socket_receiver(ThreadSafeQueue<FaceData>& queue, std::atomic<bool>& running);
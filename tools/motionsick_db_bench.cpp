@@ -0,0 +1,190 @@
+// motionsick_db_bench: DatabaseLogger::query 구간 조회 지연을 DB 크기(세션 길이)별로 잰다.
+//
+//   motionsick_db_bench [--hours 1,2,4,8] [--window SEC] [--queries N] [--dir DIR]
+//
+// - 시간마다 합성 DB 를 만든다 (IMU 100Hz, 얼굴 10Hz, GPS 1Hz, 라이브와 같은 스키마/인덱스).
+// - 임의 시각의 "최근 window 초" IMU 구간을 query<ImuData> 로 읽는 시간을 잰다.
+// - 같은 DB 에서 timestamp 인덱스를 지운 뒤(전체 스캔) 한 번 더 잰다.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sqlite3.h>
+
+#include "../logger/database_logger.hpp"
+#include "../logger/sample_query.hpp"
+
+namespace {
+    struct Options {
+        std::vector<double> hours = {1, 2, 4, 8};
+        double window = 30.0;
+        size_t queries = 200;
+        std::string dir = "/tmp";
+    };
+
+    const double T_BEGIN = 1750000000.0;   // 합성 세션 시작 (epoch 초)
+
+    struct Latency {
+        double median_ms = 0.0;
+        double p95_ms = 0.0;
+        double rows = 0.0;   // 쿼리당 평균 행 수
+    };
+
+    bool fill_db(sqlite3* db, double hours) {
+        sqlite3_stmt* imu = nullptr;
+        sqlite3_stmt* face = nullptr;
+        sqlite3_stmt* gps = nullptr;
+        sqlite3_prepare_v2(db, "INSERT INTO imu_data VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7);", -1, &imu, nullptr);
+        sqlite3_prepare_v2(db, "INSERT INTO face_data VALUES (?1, ?2, ?3, ?4, ?5, 0);", -1, &face, nullptr);
+        sqlite3_prepare_v2(db, "INSERT INTO gps_data VALUES (?1, ?2, ?3, ?4);", -1, &gps, nullptr);
+        if (!imu || !face || !gps) {
+            std::cerr << "[Bench] SQL error: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+
+        const char* blendshapes = "{\"eyeBlinkLeft\":0.1,\"eyeBlinkRight\":0.1,\"jawOpen\":0.05}";
+        size_t imu_rows = static_cast<size_t>(hours * 3600.0 * 100.0);
+
+        sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+        for (size_t i = 0; i < imu_rows; ++i) {
+            double t = T_BEGIN + i * 0.01;
+            sqlite3_bind_double(imu, 1, t);
+            for (int c = 2; c <= 7; ++c) sqlite3_bind_double(imu, c, 0.01 * ((i + c) % 97));
+            sqlite3_step(imu);
+            sqlite3_reset(imu);
+
+            if (i % 10 == 0) {
+                sqlite3_bind_double(face, 1, t);
+                for (int c = 2; c <= 4; ++c) sqlite3_bind_double(face, c, 120.0 + c);
+                sqlite3_bind_text(face, 5, blendshapes, -1, SQLITE_STATIC);
+                sqlite3_step(face);
+                sqlite3_reset(face);
+            }
+            if (i % 100 == 0) {
+                sqlite3_bind_double(gps, 1, t);
+                sqlite3_bind_double(gps, 2, 37.5 + i * 1e-9);
+                sqlite3_bind_double(gps, 3, 127.0 + i * 1e-9);
+                sqlite3_bind_double(gps, 4, 60.0);
+                sqlite3_step(gps);
+                sqlite3_reset(gps);
+            }
+        }
+        sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+
+        sqlite3_finalize(imu);
+        sqlite3_finalize(face);
+        sqlite3_finalize(gps);
+        return true;
+    }
+
+    Latency measure(sqlite3* db, double hours, double window, size_t queries) {
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<double> pick(T_BEGIN + window, T_BEGIN + hours * 3600.0);
+
+        std::vector<double> ms;
+        size_t total_rows = 0;
+        for (size_t q = 0; q < queries; ++q) {
+            double t1 = pick(rng);
+            auto start = std::chrono::steady_clock::now();
+            double sum = 0.0;
+            for (const ImuData& s : SampleQuery<ImuData>(db, t1 - window, t1)) {
+                sum += s.accel[0];   // 실제로 값을 읽는다
+                ++total_rows;
+            }
+            ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            if (sum < 0.0) std::cout << "";
+        }
+
+        std::sort(ms.begin(), ms.end());
+        Latency l;
+        l.median_ms = ms[ms.size() / 2];
+        l.p95_ms = ms[std::min(ms.size() - 1, ms.size() * 95 / 100)];
+        l.rows = static_cast<double>(total_rows) / queries;
+        return l;
+    }
+
+    bool parse_args(int argc, char* argv[], Options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+            try {
+                if (arg == "--hours") {
+                    const char* v = next(); if (!v) return false;
+                    opt.hours.clear();
+                    std::stringstream ss(v);
+                    std::string item;
+                    while (std::getline(ss, item, ',')) opt.hours.push_back(std::stod(item));
+                } else if (arg == "--window") {
+                    const char* v = next(); if (!v) return false;
+                    opt.window = std::stod(v);
+                } else if (arg == "--queries") {
+                    const char* v = next(); if (!v) return false;
+                    opt.queries = std::stoul(v);
+                } else if (arg == "--dir") {
+                    const char* v = next(); if (!v) return false;
+                    opt.dir = v;
+                } else {
+                    return false;
+                }
+            } catch (const std::exception&) {
+                std::cerr << "[Bench] Invalid value for " << arg << std::endl;
+                return false;
+            }
+        }
+        return !opt.hours.empty() && opt.queries > 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        std::cerr << "Usage: " << argv[0] << " [--hours 1,2,4,8] [--window SEC] [--queries N] [--dir DIR]\n";
+        return 1;
+    }
+
+    std::printf("%6s %10s %8s | %12s %10s | %12s %10s | %8s\n",
+                "hours", "imu_rows", "db_MB", "index_p50_ms", "p95_ms", "scan_p50_ms", "p95_ms", "rows/q");
+
+    for (double hours : opt.hours) {
+        std::string path = opt.dir + "/motionsick_db_bench_" + std::to_string(static_cast<int>(hours * 60)) + "min.db";
+        std::filesystem::remove(path);
+
+        { DatabaseLogger schema(path); }   // 라이브와 같은 테이블 + 인덱스
+
+        sqlite3* db = nullptr;
+        if (sqlite3_open(path.c_str(), &db) != SQLITE_OK) {
+            std::cerr << "[Bench] Failed to open " << path << std::endl;
+            sqlite3_close(db);
+            return 1;
+        }
+        sqlite3_exec(db, "PRAGMA journal_mode=WAL; PRAGMA synchronous=OFF;", nullptr, nullptr, nullptr);
+        if (!fill_db(db, hours)) {
+            sqlite3_close(db);
+            return 1;
+        }
+
+        double mb = std::filesystem::file_size(path) / 1e6;
+        Latency indexed = measure(db, hours, opt.window, opt.queries);
+
+        // 인덱스 없이 (예전 스키마): 전체 스캔이라 쿼리 수를 줄인다
+        sqlite3_exec(db, "DROP INDEX imu_data_timestamp;", nullptr, nullptr, nullptr);
+        Latency scan = measure(db, hours, opt.window, std::max<size_t>(1, opt.queries / 10));
+
+        std::printf("%6.1f %10zu %8.1f | %12.3f %10.3f | %12.3f %10.3f | %8.0f\n",
+                    hours, static_cast<size_t>(hours * 3600.0 * 100.0), mb,
+                    indexed.median_ms, indexed.p95_ms, scan.median_ms, scan.p95_ms, indexed.rows);
+
+        sqlite3_close(db);
+        std::filesystem::remove(path);
+        std::filesystem::remove(path + "-wal");
+        std::filesystem::remove(path + "-shm");
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+// motionsick_kernel_bench: reduce_channel SIMD 구현들을 scalar 와 비교하고 속도를 잰다.
+//
+//   motionsick_kernel_bench [--lengths 1,3,7,...] [--iterations N]
+//
+// - 이 CPU 에서 돌릴 수 있는 구현 (scalar / sse2 / avx2 / neon) 마다 홀수 길이 (SIMD 폭으로 안 나눠지는 꼬리) 입력에서
+//   mean / rms / variance 가 scalar 와 상대오차 1e-9 이내, min / max 가 정확히 같은지 확인한다.
+// - MOTIONSICK_REDUCE_KERNEL (scalar / sse2) 로 강제했을 때 고르는 구현과, 지금 reduce_channel 이 쓰는 구현도 확인.
+// - 구현별 호출당 시간 (median). 불일치가 있으면 exit 1.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../features/reduce_kernels.hpp"
+
+namespace {
+    struct Options {
+        std::vector<size_t> lengths = {1, 3, 5, 7, 9, 15, 17, 31, 33, 97, 101, 499, 501, 1001, 4097};
+        std::vector<size_t> timing_lengths = {100, 500, 6000};   // 얼굴 10 s, IMU 5 s, 재처리 1분
+        size_t iterations = 2000;
+    };
+
+    bool parse_lengths(const std::string& text, std::vector<size_t>& out) {
+        out.clear();
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            try {
+                out.push_back(static_cast<size_t>(std::stoul(item)));
+            } catch (...) {
+                return false;
+            }
+        }
+        return !out.empty();
+    }
+
+    bool close_enough(double a, double b) {
+        return std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(b));
+    }
+
+    bool same_stats(const ChannelStats& a, const ChannelStats& b) {
+        return close_enough(a.mean, b.mean) && close_enough(a.rms, b.rms) &&
+               close_enough(a.variance, b.variance) && a.min == b.min && a.max == b.max;
+    }
+
+    // 가속도처럼 큰 평균 (중력) + 작은 흔들림, 부호가 섞인 값
+    std::vector<float> make_input(size_t n, std::mt19937& rng) {
+        std::normal_distribution<float> noise(0.0f, 0.5f);
+        std::vector<float> x(n);
+        for (size_t i = 0; i < n; ++i) x[i] = 9.81f + noise(rng);
+        if (n > 2) {
+            x[n - 1] = -20.0f;   // 꼬리 (SIMD 폭 밖) 에 최소값
+            x[n / 2] = 30.0f;
+        }
+        return x;
+    }
+
+    int check_parity(const std::vector<ReduceKernel>& kernels, const Options& opt) {
+        std::mt19937 rng(42);
+        int failures = 0;
+        for (size_t n : opt.lengths) {
+            std::vector<float> x = make_input(n, rng);
+            ChannelStats ref = kernels.front().reduce(x.data(), n);
+            for (const auto& k : kernels) {
+                ChannelStats s = k.reduce(x.data(), n);
+                if (!same_stats(s, ref)) {
+                    std::printf("  MISMATCH %-6s n=%-5zu mean %.17g/%.17g rms %.17g/%.17g min %g/%g max %g/%g\n",
+                                k.name, n, s.mean, ref.mean, s.rms, ref.rms, s.min, ref.min, s.max, ref.max);
+                    ++failures;
+                }
+            }
+            ChannelStats dispatched = reduce_channel(x.data(), n);
+            if (!same_stats(dispatched, ref)) {
+                std::printf("  MISMATCH reduce_channel (%s) n=%zu\n", reduce_kernel_name(), n);
+                ++failures;
+            }
+        }
+        return failures;
+    }
+
+    int check_forcing(const std::vector<ReduceKernel>& kernels) {
+        int failures = 0;
+        const char* values[] = {nullptr, "scalar", "sse2"};
+        for (const char* forced : values) {
+            ReduceKernel k = select_reduce_kernel(forced);
+            bool ok = true;
+            if (forced && std::strcmp(forced, "scalar") == 0) ok = std::strcmp(k.name, "scalar") == 0;
+            if (forced && std::strcmp(forced, "sse2") == 0) ok = std::strcmp(k.name, "avx2") != 0;
+            if (!forced) ok = std::strcmp(k.name, kernels.back().name) == 0;
+            std::printf("  MOTIONSICK_REDUCE_KERNEL=%-7s → %-6s %s\n", forced ? forced : "(unset)", k.name, ok ? "ok" : "WRONG");
+            if (!ok) ++failures;
+        }
+        return failures;
+    }
+
+    double median_ns(const ReduceKernel& k, const std::vector<float>& x, size_t iterations) {
+        std::vector<double> times;
+        times.reserve(iterations);
+        volatile double sink = 0.0;
+        for (size_t i = 0; i < iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            ChannelStats s = k.reduce(x.data(), x.size());
+            auto end = std::chrono::steady_clock::now();
+            sink = sink + s.mean;
+            times.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        }
+        std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+        return times[times.size() / 2];
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--lengths" && i + 1 < argc) {
+            if (!parse_lengths(argv[++i], opt.lengths)) {
+                std::cerr << "[Bench] Bad --lengths" << std::endl;
+                return 2;
+            }
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            opt.iterations = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--lengths 1,3,7,...] [--iterations N]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<ReduceKernel> kernels = available_reduce_kernels();
+    std::printf("[Bench] kernels:");
+    for (const auto& k : kernels) std::printf(" %s", k.name);
+    std::printf(", reduce_channel uses %s\n", reduce_kernel_name());
+
+    std::printf("[Bench] parity vs scalar (%zu lengths)\n", opt.lengths.size());
+    int failures = check_parity(kernels, opt);
+    std::printf("[Bench] kernel selection\n");
+    failures += check_forcing(kernels);
+
+    std::printf("[Bench] median ns / call\n  %-8s", "n");
+    for (const auto& k : kernels) std::printf("%10s", k.name);
+    std::printf("\n");
+    std::mt19937 rng(7);
+    for (size_t n : opt.timing_lengths) {
+        std::vector<float> x = make_input(n, rng);
+        std::printf("  %-8zu", n);
+        for (const auto& k : kernels) std::printf("%10.0f", median_ns(k, x, opt.iterations));
+        std::printf("\n");
+    }
+
+    std::printf("[Bench] %s\n", failures == 0 ? "all kernels match scalar" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
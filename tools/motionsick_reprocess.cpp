@@ -0,0 +1,440 @@
+// motionsick_reprocess: 기록된 data_log.db 들로부터 summary 테이블을 다시 계산한다.
+//
+//   motionsick_reprocess [--threads N] [--from T0] [--to T1] [--gap SEC]
+//                        [--out-dir DIR] data_log.db [more.db ...]
+//
+// - 각 DB 를 샘플 간격이 --gap 초 이상 벌어지는 지점에서 세션으로 나눈다.
+// - 세션의 1초 tick 들을 chunk 단위 작업으로 나눠 work-stealing 풀에서 병렬 계산한다.
+// - HR 필터(HeartRateSmoother)는 순서 의존적이라 chunk 가 모두 끝난 뒤 세션별로 순차 적용한다.
+// - 토글 컬럼은 toggle_events 테이블(클릭 이벤트)에서 라이브와 같은 방식으로 다시 만든다.
+//   그 테이블이 없는 예전 DB 와 head pose 컬럼은 0 으로 남는다.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sqlite3.h>
+
+#include "../include/shared_structs.hpp"
+#include "../features/gps_kinematics.hpp"
+#include "../features/gps_imu_fusion.hpp"
+#include "../features/msdv.hpp"
+#include "../features/motion_spectrum.hpp"
+#include "../features/summary_features.hpp"
+#include "../features/work_stealing_pool.hpp"
+#include "../logger/sample_query.hpp"
+
+namespace {
+    // 라이브 버퍼와 같은 크기 (sensors/sensor_registry.hpp 의 capacity)
+    struct WindowSpec {
+        size_t max_samples;
+        double max_age;  // 초
+    };
+    const WindowSpec FACE_WINDOW{10 * 10, 10.0};
+    const WindowSpec IMU_WINDOW{50 * 10, 10.0};
+    const WindowSpec GPS_WINDOW{10 * 10, 100.0};
+    const WindowSpec CAN_WINDOW{50 * 10, 10.0};
+
+    const size_t TICKS_PER_CHUNK = 60;
+
+    struct Options {
+        size_t threads = std::thread::hardware_concurrency();
+        double t_from = 0.0;
+        double t_to = 1e300;
+        double gap = 60.0;
+        std::string out_dir;
+        std::vector<std::string> db_paths;
+    };
+
+    struct Session {
+        std::array<std::vector<FaceData>, MAX_FACE_SOURCES> face;   // source_id 별
+        std::vector<ImuData> imu;
+        std::vector<GpsData> gps;
+        std::vector<CanData> can;
+        double t_begin = 0.0;
+        double t_end = 0.0;
+        std::vector<SummaryRow> rows;  // tick 마다 한 줄
+    };
+
+    struct DbJob {
+        std::string db_path;
+        std::string out_path;
+        std::vector<Session> sessions;
+        std::vector<ToggleEvent> toggles;   // 시간순, 로거 시작마다 OFF 이벤트 포함
+        std::atomic<size_t> remaining_chunks{0};
+    };
+
+    std::mutex log_mutex;
+
+    void log_line(const std::string& msg) {
+        std::lock_guard<std::mutex> lock(log_mutex);
+        std::cout << msg << std::endl;
+    }
+
+    bool prepare(sqlite3* db, const char* sql, sqlite3_stmt** stmt) {
+        if (sqlite3_prepare_v2(db, sql, -1, stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "[Reprocess] SQL error: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool has_column(sqlite3* db, const char* table, const char* column) {
+        sqlite3_stmt* stmt = nullptr;
+        std::string sql = std::string("PRAGMA table_info(") + table + ");";
+        if (!prepare(db, sql.c_str(), &stmt)) return false;
+        bool found = false;
+        while (!found && sqlite3_step(stmt) == SQLITE_ROW) {
+            const unsigned char* name = sqlite3_column_text(stmt, 1);
+            found = name && std::string(reinterpret_cast<const char*>(name)) == column;
+        }
+        sqlite3_finalize(stmt);
+        return found;
+    }
+
+    bool load_db(const std::string& path, const Options& opt,
+                 std::vector<FaceData>& face, std::vector<ImuData>& imu, std::vector<GpsData>& gps,
+                 std::vector<CanData>& can, std::vector<ToggleEvent>& toggles) {
+        sqlite3* db = nullptr;
+        if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+            std::cerr << "[Reprocess] Failed to open " << path << ": " << sqlite3_errmsg(db) << std::endl;
+            sqlite3_close(db);
+            return false;
+        }
+
+        // source_id 컬럼 이전 DB 는 전부 운전자(0)
+        const char* face_sql = has_column(db, "face_data", "source_id")
+            ? SampleTable<FaceData>::select_sql
+            : "SELECT timestamp, r, g, b, blendshapes, 0 FROM face_data "
+              "WHERE timestamp >= ?1 AND timestamp <= ?2 ORDER BY timestamp;";
+        for (const FaceData& f : SampleQuery<FaceData>(db, opt.t_from, opt.t_to, face_sql)) {
+            if (f.source_id < 0 || f.source_id >= MAX_FACE_SOURCES) continue;
+            face.push_back(f);
+        }
+        for (const ImuData& s : SampleQuery<ImuData>(db, opt.t_from, opt.t_to)) imu.push_back(s);
+        for (const GpsData& g : SampleQuery<GpsData>(db, opt.t_from, opt.t_to)) gps.push_back(g);
+        // can_data 는 --can 으로 기록한 DB 에만 있다
+        if (has_column(db, "can_data", "timestamp")) {
+            for (const CanData& c : SampleQuery<CanData>(db, opt.t_from, opt.t_to)) can.push_back(c);
+        }
+
+        sqlite3_stmt* stmt = nullptr;
+
+        // 토글은 --from 이전 이벤트도 상태 계산에 필요하다. 로거가 시작할 때는 모든 버튼이 OFF
+        if (has_column(db, "toggle_events", "button") &&
+            prepare(db, "SELECT session_start, timestamp, monotonic, button, state FROM toggle_events "
+                        "WHERE timestamp <= ?1 ORDER BY timestamp;", &stmt)) {
+            sqlite3_bind_double(stmt, 1, opt.t_to);
+            double last_session = -1.0;
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                double session_start = sqlite3_column_double(stmt, 0);
+                if (session_start != last_session) {
+                    for (int button = 0; button < 3; ++button) {
+                        ToggleEvent off;
+                        off.timestamp = session_start;
+                        off.button = button;
+                        toggles.push_back(off);
+                    }
+                    last_session = session_start;
+                }
+                ToggleEvent ev;
+                ev.timestamp = sqlite3_column_double(stmt, 1);
+                ev.monotonic = sqlite3_column_double(stmt, 2);
+                ev.button = sqlite3_column_int(stmt, 3);
+                ev.state = sqlite3_column_int(stmt, 4);
+                toggles.push_back(ev);
+            }
+            sqlite3_finalize(stmt);
+            std::stable_sort(toggles.begin(), toggles.end(),
+                [](const ToggleEvent& a, const ToggleEvent& b) { return a.timestamp < b.timestamp; });
+        }
+
+        sqlite3_close(db);
+        return true;
+    }
+
+    // 샘플 시간축이 gap 초 이상 끊기는 곳에서 세션을 나눈다
+    std::vector<Session> split_sessions(std::vector<FaceData>& face, std::vector<ImuData>& imu,
+                                        std::vector<GpsData>& gps, std::vector<CanData>& can, double gap) {
+        std::vector<double> ts;
+        ts.reserve(face.size() + imu.size() + gps.size() + can.size());
+        for (const auto& f : face) ts.push_back(f.source_timestamp);
+        for (const auto& s : imu) ts.push_back(s.source_timestamp);
+        for (const auto& g : gps) ts.push_back(g.source_timestamp);
+        for (const auto& c : can) ts.push_back(c.source_timestamp);
+        std::sort(ts.begin(), ts.end());
+
+        std::vector<Session> sessions;
+        if (ts.empty()) return sessions;
+
+        std::vector<std::pair<double, double>> ranges;
+        double begin = ts.front();
+        for (size_t i = 1; i < ts.size(); ++i) {
+            if (ts[i] - ts[i-1] > gap) {
+                ranges.emplace_back(begin, ts[i-1]);
+                begin = ts[i];
+            }
+        }
+        ranges.emplace_back(begin, ts.back());
+
+        auto in_range = [](double t, const std::pair<double, double>& r) {
+            return t >= r.first && t <= r.second;
+        };
+
+        size_t fi = 0, ii = 0, gi = 0, ci = 0;
+        for (const auto& r : ranges) {
+            Session s;
+            s.t_begin = r.first;
+            s.t_end = r.second;
+            for (; fi < face.size() && in_range(face[fi].source_timestamp, r); ++fi) {
+                s.face[face[fi].source_id].push_back(std::move(face[fi]));
+            }
+            for (; ii < imu.size() && in_range(imu[ii].source_timestamp, r); ++ii) s.imu.push_back(std::move(imu[ii]));
+            for (; gi < gps.size() && in_range(gps[gi].source_timestamp, r); ++gi) s.gps.push_back(gps[gi]);
+            for (; ci < can.size() && in_range(can[ci].source_timestamp, r); ++ci) s.can.push_back(can[ci]);
+            sessions.push_back(std::move(s));
+        }
+        return sessions;
+    }
+
+    // tick 시각 t 에서 라이브 버퍼가 들고 있었을 구간
+    template <typename T>
+    SampleSpan<T> window_at(const std::vector<T>& samples, double t, const WindowSpec& spec) {
+        auto by_time = [](const T& s, double v) { return s.source_timestamp < v; };
+        auto end = std::upper_bound(samples.begin(), samples.end(), t,
+            [](double v, const T& s) { return v < s.source_timestamp; });
+        auto begin = std::lower_bound(samples.begin(), end, t - spec.max_age, by_time);
+        if (static_cast<size_t>(end - begin) > spec.max_samples) begin = end - spec.max_samples;
+        return SampleSpan<T>(samples.data() + (begin - samples.begin()),
+                             static_cast<size_t>(end - begin));
+    }
+
+    double tick_time(const Session& s, size_t tick) {
+        return std::floor(s.t_begin) + 1.0 + tick;
+    }
+
+    void compute_chunk(Session& s, size_t tick_begin, size_t tick_end) {
+        for (size_t k = tick_begin; k < tick_end; ++k) {
+            double t = tick_time(s, k);
+            SummaryRow& row = s.rows[k];
+            row.clear();
+
+            for (int source = 0; source < MAX_FACE_SOURCES; ++source) {
+                compute_face_features(window_at(s.face[source], t, FACE_WINDOW), row, source);
+            }
+            SampleSpan<ImuData> imu = window_at(s.imu, t, IMU_WINDOW);
+            compute_imu_features(imu, row);
+            compute_msdv_features(imu, row);
+            compute_fusion_features(imu, row);
+            compute_spectrum_features(imu, row);
+            compute_gps_features(window_at(s.gps, t, GPS_WINDOW), row);
+            compute_can_features(window_at(s.can, t, CAN_WINDOW), row);
+        }
+    }
+
+    void finalize_job(DbJob& job) {
+        std::ofstream out(job.out_path, std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "[Reprocess] Failed to write " << job.out_path << std::endl;
+            return;
+        }
+        write_summary_header(out);
+
+        // 토글 라벨도 순서 의존적이라 여기서 (DB 전체에 걸쳐 이어짐)
+        ToggleLabeler toggle_labeler;
+        size_t toggle_pos = 0;
+        auto toggles_until = [&job, &toggle_pos](double t) {
+            size_t begin = toggle_pos;
+            while (toggle_pos < job.toggles.size() && job.toggles[toggle_pos].timestamp <= t) ++toggle_pos;
+            return SampleSpan<ToggleEvent>(job.toggles.data() + begin, toggle_pos - begin);
+        };
+
+        size_t total = 0;
+        for (auto& s : job.sessions) {
+            std::array<HeartRateSmoother, MAX_FACE_SOURCES> hr_smoothers;  // 세션마다 새로 시작 (라이브와 동일)
+            toggle_labeler.advance(toggles_until(tick_time(s, 0) - 1.0));
+            for (size_t k = 0; k < s.rows.size(); ++k) {
+                SummaryRow& row = s.rows[k];
+                toggle_labeler.apply(toggles_until(tick_time(s, k)), row);
+                for (int source = 0; source < MAX_FACE_SOURCES; ++source) {
+                    const int hr = face_column(source, FACE_HR);
+                    row.set(hr, hr_smoothers[source].update(row[hr], row[face_column(source, FACE_HR_SNR)]));
+                }
+                char timestamp[SUMMARY_TIMESTAMP_SIZE];
+                format_summary_timestamp(tick_time(s, k), timestamp);
+                write_summary_row(out, timestamp, row);
+            }
+            total += s.rows.size();
+            s.rows.clear();
+            s.rows.shrink_to_fit();
+        }
+
+        log_line("[Reprocess] " + job.db_path + " → " + job.out_path +
+                 " (" + std::to_string(job.sessions.size()) + " sessions, " +
+                 std::to_string(total) + " rows)");
+    }
+
+    void schedule_job(WorkStealingPool& pool, DbJob& job, const Options& opt) {
+        std::vector<FaceData> face;
+        std::vector<ImuData> imu;
+        std::vector<GpsData> gps;
+        std::vector<CanData> can;
+        if (!load_db(job.db_path, opt, face, imu, gps, can, job.toggles)) return;
+
+        job.sessions = split_sessions(face, imu, gps, can, opt.gap);
+
+        // 순서 의존적인 스트리밍 단계는 세션별로 먼저 순차 실행
+        for (auto& s : job.sessions) {
+            GpsKinematics kinematics;
+            for (auto& g : s.gps) kinematics.update(g);
+
+            MsdvAccumulator msdv(100.0);
+            for (auto& m : s.imu) msdv.process(m);
+
+            MotionSpectrum spectrum(100.0);
+            for (auto& m : s.imu) spectrum.process(m);
+
+            // GPS fix 와 IMU 샘플을 시간순으로 섞어서 (라이브는 IMU 샘플 직전에 최신 fix 를 반영)
+            GpsImuFusion fusion;
+            size_t gi = 0;
+            for (auto& m : s.imu) {
+                for (; gi < s.gps.size() && s.gps[gi].source_timestamp <= m.source_timestamp; ++gi) {
+                    fusion.correct(s.gps[gi]);
+                }
+                fusion.process(m);
+            }
+        }
+
+        size_t chunks = 0;
+        for (auto& s : job.sessions) {
+            size_t ticks = static_cast<size_t>(std::max(0.0, std::floor(s.t_end) - std::floor(s.t_begin)));
+            s.rows.resize(ticks);
+            chunks += (ticks + TICKS_PER_CHUNK - 1) / TICKS_PER_CHUNK;
+        }
+
+        if (chunks == 0) {
+            finalize_job(job);
+            return;
+        }
+
+        // 마지막 chunk 를 끝낸 워커가 파일을 쓴다
+        job.remaining_chunks = chunks;
+        for (auto& s : job.sessions) {
+            for (size_t k = 0; k < s.rows.size(); k += TICKS_PER_CHUNK) {
+                size_t k_end = std::min(k + TICKS_PER_CHUNK, s.rows.size());
+                Session* sp = &s;
+                DbJob* jp = &job;
+                pool.submit([sp, jp, k, k_end]() {
+                    compute_chunk(*sp, k, k_end);
+                    if (jp->remaining_chunks.fetch_sub(1) == 1) finalize_job(*jp);
+                });
+            }
+        }
+    }
+
+    std::string output_path_for(const std::string& db_path, const std::string& out_dir) {
+        namespace fs = std::filesystem;
+        fs::path p(db_path);
+        std::string name = p.stem().string() + "_summary_reprocessed.csv";
+        if (out_dir.empty()) return (p.parent_path() / name).string();
+
+        // 여러 세션 폴더의 data_log.db 가 같은 이름이라 상위 폴더명을 붙임
+        std::string parent = p.parent_path().filename().string();
+        if (!parent.empty()) name = parent + "_" + name;
+        return (fs::path(out_dir) / name).string();
+    }
+
+    void print_usage(const char* argv0) {
+        std::cerr << "Usage: " << argv0
+                  << " [--threads N] [--from T0] [--to T1] [--gap SEC] [--out-dir DIR]"
+                  << " data_log.db [more.db ...]\n"
+                  << "  --threads N   worker threads (default: all cores)\n"
+                  << "  --from/--to   epoch-seconds time window to reprocess\n"
+                  << "  --gap SEC     split sessions at sample gaps longer than SEC (default 60)\n"
+                  << "  --out-dir DIR write CSVs to DIR instead of next to each DB\n";
+    }
+
+    bool parse_args(int argc, char* argv[], Options& opt) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+
+            try {
+                if (arg == "--threads") {
+                    const char* v = next(); if (!v) return false;
+                    opt.threads = std::stoul(v);
+                } else if (arg == "--from") {
+                    const char* v = next(); if (!v) return false;
+                    opt.t_from = std::stod(v);
+                } else if (arg == "--to") {
+                    const char* v = next(); if (!v) return false;
+                    opt.t_to = std::stod(v);
+                } else if (arg == "--gap") {
+                    const char* v = next(); if (!v) return false;
+                    opt.gap = std::stod(v);
+                } else if (arg == "--out-dir") {
+                    const char* v = next(); if (!v) return false;
+                    opt.out_dir = v;
+                } else if (arg == "-h" || arg == "--help") {
+                    return false;
+                } else {
+                    opt.db_paths.push_back(arg);
+                }
+            } catch (const std::exception&) {
+                std::cerr << "[Reprocess] Invalid value for " << arg << std::endl;
+                return false;
+            }
+        }
+        return !opt.db_paths.empty();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parse_args(argc, argv, opt)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (!opt.out_dir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(opt.out_dir, ec);
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+
+    std::vector<std::unique_ptr<DbJob>> jobs;
+    for (const auto& path : opt.db_paths) {
+        auto job = std::make_unique<DbJob>();
+        job->db_path = path;
+        job->out_path = output_path_for(path, opt.out_dir);
+        jobs.push_back(std::move(job));
+    }
+
+    {
+        WorkStealingPool pool(opt.threads);
+        log_line("[Reprocess] " + std::to_string(jobs.size()) + " databases, " +
+                 std::to_string(pool.size()) + " threads");
+
+        // DB 로딩도 작업으로 던지고, 로딩한 워커가 tick chunk 들을 자기 deque 에 쌓는다
+        for (auto& job : jobs) {
+            DbJob* jp = job.get();
+            pool.submit([&pool, jp, &opt]() { schedule_job(pool, *jp, opt); });
+        }
+        pool.wait_idle();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "[Reprocess] Done in " << elapsed << " s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "sparkline_widget.hpp"
+
+#include <QPainter>
+#include <QPen>
+#include <algorithm>
+
+namespace {
+    constexpr int LABEL_HEIGHT = 22;
+    constexpr int MARGIN = 4;
+}
+
+SparklineWidget::SparklineWidget(const QString& title, const QColor& color,
+                                 const PlotHistory<PLOT_HISTORY_SIZE>* history,
+                                 bool zero_is_missing, QWidget* parent)
+    : QWidget(parent), title_(title), color_(color), history_(history), zero_is_missing_(zero_is_missing) {
+    setAttribute(Qt::WA_OpaquePaintEvent);   // 배경은 직접 칠함
+    setMinimumHeight(80);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    pending_.reserve(PLOT_HISTORY_SIZE);
+}
+
+int SparklineWidget::plot_width() const {
+    return std::max(1, width() - 2 * MARGIN);
+}
+
+void SparklineWidget::add_sample(float v) {
+    if (zero_is_missing_ && v == 0.0f) return;
+    last_value_ = v;
+    has_value_ = true;
+
+    if (columns_.empty() || columns_.back().count >= samples_per_column_) {
+        columns_.push_back({v, v, 1});
+        if (static_cast<int>(columns_.size()) > plot_width()) columns_.pop_front();
+    } else {
+        Column& c = columns_.back();
+        c.min = std::min(c.min, v);
+        c.max = std::max(c.max, v);
+        ++c.count;
+    }
+}
+
+void SparklineWidget::rebuild() {
+    built_width_ = plot_width();
+    // history 전체가 폭 안에 들어가도록 열당 샘플 수 결정
+    samples_per_column_ = static_cast<int>((PLOT_HISTORY_SIZE + built_width_ - 1) / built_width_);
+    columns_.clear();
+    has_value_ = false;
+
+    pending_.clear();
+    read_pos_ = history_->read_since(0, pending_);
+    for (float v : pending_) add_sample(v);
+}
+
+void SparklineWidget::refresh() {
+    if (built_width_ != plot_width()) {
+        rebuild();
+        update();
+        return;
+    }
+
+    pending_.clear();
+    uint64_t pos = history_->read_since(read_pos_, pending_);
+    if (pos == read_pos_) return;   // 새 값 없으면 다시 그리지 않음
+    read_pos_ = pos;
+
+    for (float v : pending_) add_sample(v);
+    update();
+}
+
+void SparklineWidget::resizeEvent(QResizeEvent* event) {
+    QWidget::resizeEvent(event);
+    rebuild();
+}
+
+void SparklineWidget::paintEvent(QPaintEvent*) {
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(Qt::black));
+
+    // 제목 + 최신값
+    painter.setPen(QColor(Qt::gray));
+    QString label = title_;
+    if (has_value_) label += QString("  %1").arg(last_value_, 0, 'f', 1);
+    painter.drawText(QRect(MARGIN, 0, width() - 2 * MARGIN, LABEL_HEIGHT), Qt::AlignLeft | Qt::AlignVCenter, label);
+
+    if (columns_.empty()) return;
+
+    // 보이는 열 기준 자동 범위
+    float lo = columns_.front().min, hi = columns_.front().max;
+    for (const Column& c : columns_) {
+        lo = std::min(lo, c.min);
+        hi = std::max(hi, c.max);
+    }
+    if (hi - lo < 1e-3f) {
+        hi += 0.5f;
+        lo -= 0.5f;
+    }
+
+    const int top = LABEL_HEIGHT;
+    const int bottom = height() - MARGIN;
+    const float scale = (bottom - top) / (hi - lo);
+    auto y_of = [&](float v) { return bottom - static_cast<int>((v - lo) * scale + 0.5f); };
+
+    // 열마다 세로선 하나 (min~max). 이웃 열과 이어지도록 이전 열 범위까지 늘린다
+    painter.setPen(QPen(color_, 1));
+    const int x0 = MARGIN + plot_width() - static_cast<int>(columns_.size());
+    float prev_min = columns_.front().min, prev_max = columns_.front().max;
+    int x = x0;
+    for (const Column& c : columns_) {
+        float seg_lo = std::min(c.min, prev_max);
+        float seg_hi = std::max(c.max, prev_min);
+        painter.drawLine(x, y_of(seg_lo), x, y_of(seg_hi));
+        prev_min = c.min;
+        prev_max = c.max;
+        ++x;
+    }
+}
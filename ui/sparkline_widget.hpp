@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QColor>
+#include <QString>
+#include <QWidget>
+#include <deque>
+#include <vector>
+
+#include "plot_feed.hpp"
+
+// PlotHistory 하나를 그리는 작은 실시간 그래프.
+// - 픽셀 열마다 min/max 를 들고 있어서 새 샘플은 마지막 열만 갱신한다 (전체 재계산은 폭이 바뀔 때만).
+// - refresh() 는 UI 타이머에서 부르고, 센서 버퍼/뮤텍스는 건드리지 않는다.
+class SparklineWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    SparklineWidget(const QString& title, const QColor& color,
+                    const PlotHistory<PLOT_HISTORY_SIZE>* history,
+                    bool zero_is_missing = false, QWidget* parent = nullptr);
+
+    // 새 샘플을 가져와서 있으면 다시 그린다
+    void refresh();
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private:
+    struct Column {
+        float min;
+        float max;
+        int count;   // 이 열에 들어간 샘플 수
+    };
+
+    void add_sample(float v);
+    void rebuild();   // 폭이 바뀌면 history 전체로 열을 다시 만든다
+    int plot_width() const;
+
+    QString title_;
+    QColor color_;
+    const PlotHistory<PLOT_HISTORY_SIZE>* history_;
+    bool zero_is_missing_;
+
+    uint64_t read_pos_ = 0;
+    std::vector<float> pending_;       // refresh 마다 재사용
+    std::deque<Column> columns_;       // 최대 plot_width() 개
+    int samples_per_column_ = 1;
+    int built_width_ = -1;
+    float last_value_ = 0.0f;
+    bool has_value_ = false;
+};
@@ -1,4 +1,7 @@
 #include "toggle_window.hpp"
+#include "sparkline_widget.hpp"
+#include "idle_monitor.hpp"
+#include "toggle_events.hpp"
 #include <QHBoxLayout>
 #include <QVBoxLayout>
 #include <QTimer>
@@ -34,6 +37,17 @@ ToggleWindow::ToggleWindow(SharedToggleState shared_state, QWidget *parent)
     status_circle->setFixedSize(20, 20);
     status_circle->setStyleSheet("background-color: gray; border-radius: 10px;");
 
+    // Sensor status: face fps, IMU / GPS 표시등, 마지막 오류
+    fps_label = new QLabel("-- fps");
+    fps_label->setStyleSheet("font-size: 14px; color: gray;");
+    imu_label = new QLabel("IMU");
+    gps_label = new QLabel("GPS");
+    for (QLabel* label : {imu_label, gps_label}) {
+        label->setStyleSheet("font-size: 14px; color: gray;");
+    }
+    error_label = new QLabel("");
+    error_label->setStyleSheet("font-size: 14px; color: #e05050;");
+
     // Time label
     time_label = new QLabel("00:00:00");
     time_label->setAlignment(Qt::AlignLeft | Qt::AlignTop);
@@ -67,6 +81,8 @@ ToggleWindow::ToggleWindow(SharedToggleState shared_state, QWidget *parent)
 
         connect(buttons[i], &QPushButton::clicked, [=]() {
             toggle_states[i] = buttons[i]->isChecked();
+            toggle_event_log.record(i, toggle_states[i] ? 1 : 0);  // ✅ 클릭 순간 시각 (DB/CSV 는 여기서 읽음)
+            idle_monitor.wake();   // idle 로 잠든 DB 스레드도 이 클릭은 바로 기록
             (*external_state)[i] = toggle_states[i] ? 1 : 0;
             printStates();
         });
@@ -76,12 +92,29 @@ ToggleWindow::ToggleWindow(SharedToggleState shared_state, QWidget *parent)
     QHBoxLayout *top_layout = new QHBoxLayout();
     top_layout->addWidget(status_circle, 0, Qt::AlignLeft| Qt::AlignVCenter);
     top_layout->addWidget(time_label, 0, Qt::AlignLeft| Qt::AlignVCenter);
+    top_layout->addSpacing(20);
+    top_layout->addWidget(fps_label, 0, Qt::AlignLeft| Qt::AlignVCenter);
+    top_layout->addWidget(imu_label, 0, Qt::AlignLeft| Qt::AlignVCenter);
+    top_layout->addWidget(gps_label, 0, Qt::AlignLeft| Qt::AlignVCenter);
+    top_layout->addSpacing(20);
+    top_layout->addWidget(error_label, 0, Qt::AlignLeft| Qt::AlignVCenter);
     top_layout->addStretch();
     top_layout->addWidget(quit_button, 0, Qt::AlignRight);
 
+    // Live plots (summary 스레드가 plot_feed 에 쓰고, 여기서는 타이머로 읽기만)
+    sparklines = {
+        new SparklineWidget("HR", QColor(230, 80, 80), &plot_feed.hr, true),
+        new SparklineWidget("ACC RMS", QColor(80, 180, 230), &plot_feed.acc_rms),
+        new SparklineWidget("SPEED", QColor(120, 220, 120), &plot_feed.speed)
+    };
+    QHBoxLayout *plot_layout = new QHBoxLayout();
+    plot_layout->setSpacing(10);
+    for (auto* plot : sparklines) plot_layout->addWidget(plot);
+
     // Main layout
     QVBoxLayout *main_layout = new QVBoxLayout();
     main_layout->addLayout(top_layout, 1);
+    main_layout->addLayout(plot_layout, 2);
     main_layout->addLayout(btn_layout, 3);
     main_layout->setSpacing(10);
     main_layout->setContentsMargins(10, 10, 10, 10);
@@ -99,11 +132,70 @@ ToggleWindow::ToggleWindow(SharedToggleState shared_state, QWidget *parent)
             .arg(hours, 2, 10, QLatin1Char('0'))
             .arg(minutes, 2, 10, QLatin1Char('0'))
             .arg(secs, 2, 10, QLatin1Char('0')));
+
+        // summary 가 1초 주기라 그래프도 같은 타이머로 (새 값이 있을 때만 다시 그림)
+        for (auto* plot : sparklines) plot->refresh();
     });
     update_timer->start(1000);
 
     // ✅ 얼굴 감지 상태 업데이트용 Signal-Slot 연결
     connect(this, &ToggleWindow::faceDetectionChanged, this, &ToggleWindow::setFaceDetected);
+
+    // ✅ 센서 상태판은 100ms 마다 샘플링 (프레임마다 큐에 이벤트가 쌓이지 않음)
+    status_timer = new QTimer(this);
+    connect(status_timer, &QTimer::timeout, this, &ToggleWindow::pollStatus);
+    status_timer->start(100);
+}
+
+void ToggleWindow::pollStatus() {
+    SensorStatus::Snapshot snap = sensor_status.snapshot();
+
+    // 얼굴 표시등: 바뀐 순간에만 신호 한 번
+    if (snap.face_detected != shown_face_detected) {
+        shown_face_detected = snap.face_detected;
+        emit faceDetectionChanged(snap.face_detected);
+    }
+
+    if (snap.error_count != shown_error_count) {
+        shown_error_count = snap.error_count;
+        error_label->setText(QString::fromStdString(snap.last_error));
+    }
+
+    // rate 와 표시등은 1초 구간의 카운터 차이로
+    qint64 now_ms = elapsed_timer.elapsed();
+    if (snap.gps_fixes != last_rate_snapshot.gps_fixes) last_gps_fix_ms = now_ms;
+    qint64 dt_ms = now_ms - last_rate_ms;
+    if (dt_ms < 1000) {
+        last_rate_snapshot.gps_fixes = snap.gps_fixes;
+        return;
+    }
+
+    int fps = static_cast<int>((snap.face_frames - last_rate_snapshot.face_frames) * 1000 / dt_ms);
+    if (fps != shown_fps) {
+        shown_fps = fps;
+        fps_label->setText(QString("%1 fps").arg(fps));
+    }
+
+    // idle 동안에는 IMU 를 일부러 멈추므로 끊김(빨강) 대신 회색
+    bool imu_fresh = snap.imu_samples != last_rate_snapshot.imu_samples;
+    setHealth(imu_label, shown_imu,
+              imu_fresh ? Health::Ok
+              : (idle_monitor.idle() || snap.imu_samples == 0) ? Health::Off : Health::Stale);
+
+    // NMEA 는 1Hz 라 3초까지는 봐준다
+    bool gps_fresh = last_gps_fix_ms >= 0 && now_ms - last_gps_fix_ms < 3000;
+    setHealth(gps_label, shown_gps,
+              gps_fresh ? Health::Ok : (snap.gps_fixes == 0) ? Health::Off : Health::Stale);
+
+    last_rate_snapshot = snap;
+    last_rate_ms = now_ms;
+}
+
+void ToggleWindow::setHealth(QLabel* label, Health& shown, Health health) {
+    if (health == shown) return;
+    shown = health;
+    const char* color = health == Health::Ok ? "#40c040" : health == Health::Stale ? "#e05050" : "gray";
+    label->setStyleSheet(QString("font-size: 14px; color: %1;").arg(color));
 }
 
 void ToggleWindow::printStates() {
@@ -10,6 +10,9 @@
 #include <atomic>
 #include <memory>
 #include "shared_structs.hpp"
+#include "sensor_status.hpp"
+
+class SparklineWidget;
 
 class ToggleWindow : public QWidget {
     Q_OBJECT
@@ -18,7 +21,7 @@ public:
     explicit ToggleWindow(SharedToggleState shared_state, QWidget *parent = nullptr);
 
 signals:
-    void faceDetectionChanged(bool detected);  // ✅ 외부 스레드에서 emit할 수 있는 신호
+    void faceDetectionChanged(bool detected);  // ✅ 상태판 샘플링에서 값이 바뀔 때 한 번만 emit
 
 public slots:
     void setFaceDetected(bool detected);       // ✅ 시그널을 받아 UI를 업데이트하는 슬롯
@@ -30,8 +33,30 @@ private:
 
     QLabel* time_label;       // ⏱️ 경과 시간 표시용
     QLabel* status_circle;    // 🟢/⚫️ 얼굴 감지 상태 원
+    QLabel* fps_label;        // 얼굴 프레임 수신 fps
+    QLabel* imu_label;        // IMU / GPS 표시등
+    QLabel* gps_label;
+    QLabel* error_label;      // 마지막 센서 오류
     QElapsedTimer elapsed_timer;
     QTimer* update_timer;
+    QTimer* status_timer;     // sensor_status 샘플링 (센서 스레드는 Qt 이벤트를 만들지 않음)
+
+    // 상태판 샘플링 결과 — 바뀐 것만 다시 그린다
+    enum class Health { Off, Ok, Stale };
+    bool shown_face_detected = false;
+    int shown_fps = -1;
+    Health shown_imu = Health::Off;
+    Health shown_gps = Health::Off;
+    uint64_t shown_error_count = 0;
+    SensorStatus::Snapshot last_rate_snapshot;
+    qint64 last_rate_ms = 0;
+    qint64 last_gps_fix_ms = -1;
+
+    void pollStatus();
+    void setHealth(QLabel* label, Health& shown, Health health);
+
+    // 1초 summary 값 실시간 그래프 (HR, 가속도 RMS, 속도)
+    std::array<SparklineWidget*, 3> sparklines;
 
     SharedToggleState external_state;  // 외부와 공유되는 상태 포인터
 